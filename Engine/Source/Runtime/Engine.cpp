@@ -4,6 +4,7 @@
 #include <Luna/Font/Font.hpp>
 #include <Luna/HID/HID.hpp>
 #include <Luna/ImGui/ImGui.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 #include <Luna/ObjLoader/ObjLoader.hpp>
 #include <Luna/RHI/RHI.hpp>
 #include <Luna/Runtime/File.hpp>
@@ -29,7 +30,8 @@ namespace Bocchi
                                         module_font(),
                                         module_imgui(),
                                         module_asset(),
-                                        module_obj_loader() }));
+                                        module_obj_loader(),
+                                        module_job_system() }));
         auto r = init_modules();
         if (failed(r))
         {
@@ -41,10 +43,16 @@ namespace Bocchi
         {
             log_error("App", explain(r.errcode()));
         }
+        BuildFrameGraph();
         log_info("App", "Engine Started!");
     };
 
-    void BocchiEngine::ShutdownEngine() { log_info("App", "Engine Closed!"); }
+    void BocchiEngine::ShutdownEngine()
+    {
+        // the frame graph holds job system resources, release it before the job system module is closed
+        m_frame_graph.reset();
+        log_info("App", "Engine Closed!");
+    }
     void BocchiEngine::SetCurrentDirToProcessPath()
     {
         Path p = get_process_path();
@@ -89,8 +97,13 @@ namespace Bocchi
             return ok;
         }
 
-        LogicalTick(delta_time);
-        RendererTick(delta_time);
+        m_frame_delta_time = delta_time;
+        auto frame_job = m_frame_graph->execute();
+        if (failed(frame_job))
+        {
+            return frame_job.errcode();
+        }
+        JobSystem::wait_job(frame_job.get());
         CalculateFps(delta_time);
         c8 buf[64];
         snprintf(buf, sizeof(buf), "Bocchi Engine %lld FPS", GetFps());
@@ -98,6 +111,27 @@ namespace Bocchi
         return ok;
     }
 
+    void BocchiEngine::BuildFrameGraph()
+    {
+        m_frame_graph = JobSystem::new_job_graph();
+        usize logical_tick = m_frame_graph->add_node(
+            [](void *params) {
+                auto engine = (BocchiEngine *)params;
+                engine->LogicalTick(engine->m_frame_delta_time);
+            },
+            this,
+            JobSystem::JobPriority::high);
+        usize renderer_tick = m_frame_graph->add_node(
+            [](void *params) {
+                auto engine = (BocchiEngine *)params;
+                engine->RendererTick(engine->m_frame_delta_time);
+            },
+            this,
+            JobSystem::JobPriority::high,
+            true); // swap chain presentation must run on the main thread
+        m_frame_graph->add_edge(logical_tick, renderer_tick);
+    }
+
     void      BocchiEngine::LogicalTick(f32 delta_time) {}
     void      BocchiEngine::RendererTick(f32 delta_time) {}
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <Luna/JobSystem/JobGraph.hpp>
 #include <Luna/Window/Window.hpp>
 
 namespace Bocchi
@@ -28,6 +29,8 @@ namespace Bocchi
             void             LogicalTick(f32 delta_time);
             void             RendererTick(f32 delta_time);
 
+            void             BuildFrameGraph();
+
             f64              CalculalteDeltaTime();
             void             CalculateFps(f32 delta_time);
 
@@ -39,6 +42,10 @@ namespace Bocchi
             f64              m_frame_count{ 0 };
             i64              m_fps{ 0 };
 
+            // per-frame tick stages, executed as one job graph
+            Ref<JobSystem::IJobGraph> m_frame_graph;
+            f32                       m_frame_delta_time{ 0.f };
+
             static const f32 k_fps_alpha;
     };
 } // namespace Bocchi
\ No newline at end of file
@@ -11,6 +11,11 @@
 #include <Luna/Runtime/Result.hpp>
 #include <Luna/Runtime/Ref.hpp>
 #include <Luna/Runtime/Path.hpp>
+#include <Luna/Runtime/Blob.hpp>
+#include <Luna/Runtime/Functional.hpp>
+#include <Luna/Runtime/Waitable.hpp>
+#include <Luna/Runtime/Span.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 
 #ifndef LUNA_ASSET_API
 #define LUNA_ASSET_API
@@ -96,6 +101,24 @@ namespace Luna
             //! @param[in] path The VFS path to load asset data from.
             //! @return Returns the loaded asset data object.
             R<ObjRef>(*on_load_asset)(object_t userdata, asset_t asset, const Path& path) = nullptr;
+            //! Called in the I/O stage of asset loading to read asset file data from the specified file.
+            //! @details This function can be `nullptr`. If both this and @ref on_decode_asset are not `nullptr` and 
+            //! @ref on_load_asset is `nullptr`, the asset data is loaded by calling this function and then @ref on_decode_asset.
+            //! When loading asset data asynchronously by @ref load_asset_async, these two functions are called in different jobs
+            //! and @ref on_load_asset is not used, so that reading files of one asset can overlap with decoding data of other assets.
+            //! @param[in] userdata The userdata.
+            //! @param[in] asset The asset handle of the asset being loaded.
+            //! @param[in] path The VFS path to load asset data from.
+            //! @return Returns the file data read from the file.
+            R<Blob>(*on_read_asset_file)(object_t userdata, asset_t asset, const Path& path) = nullptr;
+            //! Called in the decode stage of asset loading to create the asset data object from file data read by @ref on_read_asset_file.
+            //! @details This function can be `nullptr`. See @ref on_read_asset_file for details.
+            //! @param[in] userdata The userdata.
+            //! @param[in] asset The asset handle of the asset being loaded.
+            //! @param[in] path The VFS path of the asset.
+            //! @param[in] file_data The file data returned by @ref on_read_asset_file.
+            //! @return Returns the loaded asset data object.
+            R<ObjRef>(*on_decode_asset)(object_t userdata, asset_t asset, const Path& path, Blob& file_data) = nullptr;
             //! Called when one asset data object with default asset data is being requested. The user should create a 
             //! new asset data object and load default asset data to the object.
             //! @details This function can be `nullptr`. If this function is `nullptr`, this asset type does not support 
@@ -125,6 +148,29 @@ namespace Luna
             //! This can be `nullptr` if the user calls @ref set_asset_data with `data` equals to `nullptr`. In such case,
             //! this function behaves like unloading existing asset data object.
             RV(*on_set_asset_data)(object_t userdata, asset_t asset, object_t data) = nullptr;
+            //! Called to get the memory size of one asset data object, which is used to check the memory budget of assets.
+            //! @details This function is called when one asset data object is set to the asset, or when @ref update_asset_data_size is called.
+            //! The asset is locked when this function is called, so this function should not call other asset functions on the same asset.
+            //! 
+            //! This function can be `nullptr`, in such case, the size of asset data objects of this type is treated as 0, so that they never 
+            //! exceed the memory budget and are never evicted.
+            //! @param[in] userdata The userdata.
+            //! @param[in] asset The asset handle of the asset.
+            //! @param[in] data The asset data object to measure.
+            //! @return Returns the memory size, in bytes, of the asset data object.
+            u64(*on_get_asset_data_size)(object_t userdata, asset_t asset, object_t data) = nullptr;
+            //! Called to get assets that should be loaded before the specified asset is loaded, like textures referred by one material.
+            //! @details This function is called by @ref load_asset_with_dependencies and @ref reload_assets before the asset data is loaded, 
+            //! and the returned assets are recorded as dependencies of the asset once the asset is loaded successfully. The user usually 
+            //! reads the asset file header or metadata to find dependencies, without decoding the whole asset data. This function may be 
+            //! called from worker threads.
+            //! 
+            //! This function can be `nullptr`, in such case, assets of this type do not have any dependency.
+            //! @param[in] userdata The userdata.
+            //! @param[in] asset The asset handle of the asset.
+            //! @param[in] path The VFS path of the asset.
+            //! @param[out] dependencies Returns asset handles of dependencies. Existing elements in the array will be preserved.
+            RV(*on_get_asset_dependencies)(object_t userdata, asset_t asset, const Path& path, Vector<asset_t>& dependencies) = nullptr;
         };
 
         //! Registers one asset type so the asset system can handle the asset of that type.
@@ -175,6 +221,11 @@ namespace Luna
         //! If `path` specifies one asset, the system loads the asset metadata by opening its meta file and reading from it.
         //! If `path` specifies one directory, the system loads assets metadata for all assets in the directory recursively, every
         //! asset metadata is loaded as if `load_assets_meta` is called for that particular asset.
+        //! 
+        //! When loading one directory, the system maintains one binary index file named `.meta_index` in that directory, which caches 
+        //! metadata of all assets in the directory. Directories and metadata files whose last write time and size match the index are not 
+        //! parsed again, and new or modified metadata files are parsed in parallel using the job system. The index file is rebuilt if any 
+        //! metadata file is added, removed or modified.
         //! @param[in] allow_overwrite Specify the behavior when the specified asset already exists in the system.
         //! If `allow_overwrite` is `true`, the system will overwrite the asset metadata in the system using new asset metadata loaded
         //! from asset meta file; if `allow_overwrite` is `false`, the system discards the new asset metadata and does not change the 
@@ -290,8 +341,8 @@ namespace Luna
 
         //! Creates one asset data object for the asset by loading data from asset file.
         //! @details This function loads the asset data synchronously. To load asset data asynchronously, call
-        //! this function in the thread you want to use for asset loading, like a background thread or a 
-        //! worker thread in job system.
+        //! @ref load_asset_async, or call this function in the thread you want to use for asset loading, like a 
+        //! background thread or a worker thread in job system.
         //! @param[in] asset The asset handle of the asset to operate.
         //! @param[in] force_reload If this is `true`, this function always loads the asset data from file even if the asset is 
         //! in loaded state, and the existing asset data object will be replaced with new asset data object.
@@ -307,6 +358,201 @@ namespace Luna
         //! object will not be changed.
         LUNA_ASSET_API RV load_asset_default_data(asset_t asset, bool force_reload = false);
 
+        //! Identifies the status of one asynchronous asset loading request.
+        enum class AssetLoadingStatus : u8
+        {
+            //! The request is waiting to be processed by worker threads.
+            pending = 0,
+            //! The asset data is being loaded.
+            loading = 1,
+            //! The request is finished. Call @ref IAssetLoadingRequest::get_result to check whether the asset data is loaded.
+            finished = 2,
+        };
+
+        //! The callback function invoked when one asynchronous asset loading request is finished.
+        //! @param[in] asset The asset handle of the loaded asset.
+        //! @param[in] result The loading result. This is @ref BasicError::interrupted if the request is cancelled.
+        using asset_loading_callback_t = void(asset_t asset, RV result);
+
+        //! @interface IAssetLoadingRequest
+        //! Represents one asynchronous asset loading request created by @ref load_asset_async.
+        //! @details Waiting for the request by @ref IWaitable::wait executes jobs of the job system on the current thread, 
+        //! so that it can be called by both the main thread and worker threads. The request is also finished when 
+        //! the job ID returned by @ref get_job_id is finished, so that it can be waited by job system functions like 
+        //! @ref JobSystem::wait_job_async.
+        //! 
+        //! All functions of this interface are thread-safe.
+        struct IAssetLoadingRequest : virtual IWaitable
+        {
+            luiid("{b3f1a6d2-7c4e-4e8b-9a05-2d6f8c1e7b43}");
+
+            //! Gets the asset being loaded.
+            virtual asset_t get_asset() = 0;
+
+            //! Gets the job ID that is finished when the request is finished.
+            virtual JobSystem::job_id_t get_job_id() = 0;
+
+            //! Gets the status of the request.
+            virtual AssetLoadingStatus get_status() = 0;
+
+            //! Gets the loading result.
+            //! @return Returns @ref BasicError::in_progress if the request is not finished, returns @ref BasicError::interrupted 
+            //! if the request is cancelled, otherwise returns the result of loading the asset data.
+            virtual RV get_result() = 0;
+
+            //! Gets the priority of the request.
+            virtual JobSystem::JobPriority get_priority() = 0;
+
+            //! Changes the priority of the request.
+            //! @details Pending requests are processed in priority order, requests with the same priority are processed in the 
+            //! order of being created or reprioritized. Changing the priority of requests that are loading or finished only 
+            //! affects the priority of jobs submitted for the remaining stages.
+            //! @param[in] priority The new priority.
+            virtual void set_priority(JobSystem::JobPriority priority) = 0;
+
+            //! Cancels the request.
+            //! @details If the request is pending, it is finished immediately. If the request is loading, the remaining stages 
+            //! are skipped, and the loaded asset data (if any) is discarded. In both cases, the asset is kept in @ref AssetState::unloaded
+            //! state (or the previous state if the request reloads one loaded asset) and the request result is @ref BasicError::interrupted.
+            //! This function does nothing if the request is already finished.
+            virtual void cancel() = 0;
+
+            //! Adds one callback function that will be invoked when the request is finished.
+            //! @details Callback functions are marshalled to the main thread, and are invoked by @ref JobSystem::run_main_thread_jobs, 
+            //! or by @ref JobSystem::wait_job called from the main thread. If the request is already finished, the callback function 
+            //! is scheduled immediately.
+            //! @param[in] callback The callback function.
+            virtual void add_callback(const Function<asset_loading_callback_t>& callback) = 0;
+        };
+
+        //! Loads asset data asynchronously using worker threads of the job system.
+        //! @details The request is queued and processed by jobs submitted to the job system. If the asset type provides 
+        //! @ref AssetTypeDesc::on_read_asset_file and @ref AssetTypeDesc::on_decode_asset, the file is read in one I/O job,
+        //! and the data is decoded in another job, otherwise @ref AssetTypeDesc::on_load_asset is called in one job.
+        //! 
+        //! If the asset is already being loaded by another @ref load_asset_async call, the existing request is returned and
+        //! its priority is raised to `priority` if `priority` is higher.
+        //! @param[in] asset The asset handle of the asset to operate.
+        //! @param[in] priority The priority of the request.
+        //! @param[in] force_reload If this is `true`, the asset data is always loaded from file even if the asset is in loaded state, 
+        //! and the existing asset data object will be replaced with new asset data object when the request is finished.
+        //! If this is `false` and the asset is already in loaded state, this function returns one finished request directly.
+        //! @return Returns the loading request.
+        //! @par Valid Usage
+        //! * The job system module must be initialized.
+        LUNA_ASSET_API R<Ref<IAssetLoadingRequest>> load_asset_async(asset_t asset, 
+            JobSystem::JobPriority priority = JobSystem::JobPriority::normal, bool force_reload = false);
+
+        //! Describes the memory usage of resident asset data objects.
+        struct AssetResidencyStatistics
+        {
+            //! The memory budget, in bytes. This is `U64_MAX` if no budget is set.
+            u64 budget;
+            //! The total memory size, in bytes, of resident asset data objects.
+            u64 resident_size;
+            //! The number of assets whose data objects are resident.
+            u64 num_resident_assets;
+            //! The number of asset data objects evicted since the asset module is initialized.
+            u64 num_evictions;
+            //! The total memory size, in bytes, of asset data objects evicted since the asset module is initialized.
+            u64 evicted_size;
+            //! The number of times that one eviction candidate is skipped because its data object is still in use: the data object
+            //! is referenced outside of the asset system, the asset is being reloaded, or @ref AssetTypeDesc::on_set_asset_data fails.
+            u64 num_referenced_skips;
+        };
+
+        //! Sets the global memory budget of resident asset data objects.
+        //! @details When the total size of resident asset data objects exceeds the budget, the system evicts data objects of least 
+        //! recently used assets until the size is within the budget. One asset is used when its data object is loaded or set, or is 
+        //! fetched by @ref get_asset_data. Only data objects that are not referenced outside of the asset system are evicted, and 
+        //! evicted assets are in @ref AssetState::unloaded state, which can be loaded again when needed.
+        //! 
+        //! The size of one asset data object is reported by @ref AssetTypeDesc::on_get_asset_data_size.
+        //! @param[in] budget The memory budget in bytes. Specify `U64_MAX` to disable the budget, which is the default value.
+        LUNA_ASSET_API void set_asset_memory_budget(u64 budget);
+
+        //! Sets the memory budget of resident asset data objects of the specified asset type.
+        //! @details The type budget is checked in addition to the global budget set by @ref set_asset_memory_budget, so that 
+        //! data objects of this type are evicted if either of the budget is exceeded.
+        //! @param[in] type The asset type.
+        //! @param[in] budget The memory budget in bytes. Specify `U64_MAX` to disable the budget, which is the default value.
+        LUNA_ASSET_API void set_asset_type_memory_budget(const Name& type, u64 budget);
+
+        //! Gets the memory usage of all resident asset data objects.
+        LUNA_ASSET_API AssetResidencyStatistics get_asset_residency_statistics();
+
+        //! Gets the memory usage of resident asset data objects of the specified asset type.
+        //! @param[in] type The asset type.
+        LUNA_ASSET_API AssetResidencyStatistics get_asset_type_residency_statistics(const Name& type);
+
+        //! Queries the memory size of the asset data object again.
+        //! @details Call this function if the asset data object is modified in place and its memory size changes.
+        //! @param[in] asset The asset handle of the asset to operate.
+        LUNA_ASSET_API void update_asset_data_size(asset_t asset);
+
+        //! Loads the asset and all of its dependencies.
+        //! @details Dependencies are fetched by @ref AssetTypeDesc::on_get_asset_dependencies recursively, and assets in the dependency 
+        //! closure are loaded asynchronously like @ref load_asset_async. Every asset starts loading as soon as all of its dependencies 
+        //! are loaded, so that independent assets are loaded in parallel, and one asset is always loaded after its dependencies.
+        //! 
+        //! Dependencies of assets that are loaded and not reloaded by this call are not fetched again if they are already recorded.
+        //! If any asset fails to load, assets that depend on it and assets that are not started yet are not loaded.
+        //! 
+        //! This function blocks the current thread until all assets are loaded. The current thread executes jobs while waiting,
+        //! so this function can also be called in job callback functions.
+        //! @param[in] asset The asset handle of the asset to load.
+        //! @param[in] priority The priority of loading requests.
+        //! @param[in] force_reload If this is `true`, all assets in the dependency closure are loaded from files even if they are in 
+        //! loaded state. If this is `false`, only assets that are not loaded are loaded.
+        //! @par Valid Usage
+        //! * The job system module must be initialized.
+        LUNA_ASSET_API RV load_asset_with_dependencies(asset_t asset, 
+            JobSystem::JobPriority priority = JobSystem::JobPriority::normal, bool force_reload = false);
+
+        //! Gets dependencies of the specified asset.
+        //! @details Dependencies are recorded when the asset is loaded successfully by @ref load_asset_with_dependencies or @ref reload_assets.
+        //! @param[in] asset The asset handle of the asset to query.
+        //! @param[out] dependencies Returns asset handles of dependencies. Existing elements in the array will be preserved.
+        LUNA_ASSET_API void get_asset_dependencies(asset_t asset, Vector<asset_t>& dependencies);
+
+        //! Gets assets that depend on the specified asset.
+        //! @details This is the reverse of @ref get_asset_dependencies, and only contains assets whose dependencies are recorded.
+        //! @param[in] asset The asset handle of the asset to query.
+        //! @param[out] dependents Returns asset handles of dependents. Existing elements in the array will be preserved.
+        LUNA_ASSET_API void get_asset_dependents(asset_t asset, Vector<asset_t>& dependents);
+
+        //! Reloads the specified assets and all loaded assets that depend on them directly or indirectly.
+        //! @details Only assets that are in loaded state are reloaded, and every asset is reloaded after its dependencies are reloaded.
+        //! Dependencies of reloaded assets are fetched again, and new dependencies that are not loaded are loaded before reloading 
+        //! assets that depend on them. Assets are loaded in parallel like @ref load_asset_with_dependencies.
+        //! @param[in] assets The asset handles of modified assets.
+        //! @param[in] priority The priority of loading requests.
+        //! @par Valid Usage
+        //! * The job system module must be initialized.
+        LUNA_ASSET_API RV reload_assets(Span<const asset_t> assets, JobSystem::JobPriority priority = JobSystem::JobPriority::normal);
+
+        //! Starts watching asset files in the specified directory for hot reloading.
+        //! @details The system records the last write time and size of all files in the directory recursively. Modified files are 
+        //! detected and reloaded when @ref reload_modified_assets is called. Watching one directory that is already watched records 
+        //! the last write time and size of files again.
+        //! @param[in] dir The VFS path of the directory to watch.
+        LUNA_ASSET_API RV watch_asset_dir(const Path& dir);
+
+        //! Stops watching asset files in the specified directory.
+        //! @param[in] dir The VFS path of the directory passed to @ref watch_asset_dir.
+        LUNA_ASSET_API void unwatch_asset_dir(const Path& dir);
+
+        //! Checks files in directories watched by @ref watch_asset_dir, and reloads assets whose files are added or modified since the last check.
+        //! @details Every modified file is mapped to the asset whose path equals to the file path with zero or more extensions removed, 
+        //! and all such assets are reloaded by @ref reload_assets, so that assets depending on them are reloaded as well. Metadata files 
+        //! are ignored.
+        //! 
+        //! Files are checked through VFS, so this works with all VFS drivers. The user usually calls this function periodically, 
+        //! like once per second in editors.
+        //! @param[in] priority The priority of loading requests.
+        //! @return Returns the number of modified assets.
+        LUNA_ASSET_API R<usize> reload_modified_assets(JobSystem::JobPriority priority = JobSystem::JobPriority::normal);
+
         //! Gets the asset state.
         //! @param[in] asset The asset handle of the asset to query.
         //! @return Returns the asset state of the specified asset.
@@ -352,6 +598,8 @@ namespace Luna
         LUNA_ASSET_API ErrCode asset_data_not_loaded();
         //! The asset data is currently loading by another thread.
         LUNA_ASSET_API ErrCode asset_data_loading();
+        //! The dependencies of the asset contain one cycle, so that they cannot be loaded in order.
+        LUNA_ASSET_API ErrCode dependency_cycle();
 
         //! @}
     }
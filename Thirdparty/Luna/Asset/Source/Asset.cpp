@@ -15,12 +15,17 @@
 #include <Luna/Runtime/Random.hpp>
 #include <Luna/Runtime/SelfIndexedHashMap.hpp>
 #include "AssetType.hpp"
+#include "AssetMetaIndex.hpp"
+#include "AssetResidency.hpp"
+#include "AssetDependency.hpp"
+#include "AssetHotReload.hpp"
 #include <Luna/Runtime/Module.hpp>
 #include <Luna/VFS/VFS.hpp>
 #include <Luna/Runtime/Serialization.hpp>
 #include <Luna/VariantUtils/JSON.hpp>
 #include <Luna/Runtime/Reflection.hpp>
 #include <Luna/VariantUtils/VariantUtils.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 
 namespace Luna
 {
@@ -44,9 +49,11 @@ namespace Luna
                 });
             set_serializable<AssetMetaFile>();
             g_assets_mutex = new_mutex();
+            init_asset_residency();
         }
         void close_asset_registry()
         {
+            close_asset_residency();
             g_assets.clear();
             g_assets.shrink_to_fit();
             g_asset_path_mapping.clear();
@@ -59,7 +66,7 @@ namespace Luna
             if (entry->loading) return AssetState::loading;
             return AssetState::unloaded;
         }
-        static R<AssetMetaFile> internal_load_asset_meta(const Path& meta_path)
+        R<AssetMetaFile> internal_load_asset_meta(const Path& meta_path)
         {
             // Read file.
             AssetMetaFile file;
@@ -148,42 +155,6 @@ namespace Luna
             }
             return ret;
         }
-        struct AssetMetaUpdateInfo
-        {
-            Path path;
-            AssetMetaFile meta_file;
-        };
-        static RV recursive_load_asset_meta(const Path& directory, Vector<AssetMetaUpdateInfo>& assets)
-        {
-            lutry
-            {
-                lulet(iter, VFS::open_dir(directory));
-                Path path = directory;
-                for(; iter->is_valid(); iter->move_next())
-                {
-                    const c8* filename = iter->get_filename();
-                    if(!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
-                    path.push_back(filename);
-                    if(test_flags(iter->get_attributes(), FileAttributeFlag::directory))
-                    {
-                        luexp(recursive_load_asset_meta(path, assets));
-                    }
-                    else if(path.extension() == "meta")
-                    {
-                        lulet(meta_file, internal_load_asset_meta(path));
-                        AssetMetaUpdateInfo info;
-                        path.remove_extension();
-                        info.path = path;
-                        info.meta_file = move(meta_file);
-                        assets.push_back(move(info));
-                    }
-                    path.pop_back();
-                }
-            }
-            lucatchret;
-            return ok;
-        }
-
         LUNA_ASSET_API RV load_assets_meta(const Path& path, bool allow_overwrite)
         {
             lutry
@@ -193,7 +164,7 @@ namespace Luna
                 auto attr = VFS::get_file_attribute(path);
                 if(succeeded(attr) && test_flags(attr.get().attributes, FileAttributeFlag::directory))
                 {
-                    luexp(recursive_load_asset_meta(path, update_assets));
+                    luexp(collect_assets_meta(path, update_assets));
                 }
                 else
                 {
@@ -383,6 +354,8 @@ namespace Luna
                 AssetEntry* entry = (AssetEntry*)asset.handle;
                 LockGuard guard(entry->lock);
                 entry->reset();
+                update_asset_residency(entry);
+                clear_asset_dependencies(entry);
             }
             lucatchret;
             return ok;
@@ -440,6 +413,7 @@ namespace Luna
             if(!asset.handle) return ObjRef();
             AssetEntry* entry = (AssetEntry*)asset.handle;
             LockGuard g(entry->lock);
+            touch_asset_residency(entry);
             return entry->data;
         }
         LUNA_ASSET_API RV set_asset_data(asset_t asset, object_t data)
@@ -457,6 +431,9 @@ namespace Luna
             }
             lucatchret;
             entry->data = data;
+            update_asset_residency(entry);
+            g.unlock();
+            enforce_asset_budgets(entry);
             return ok;
         }
         LUNA_ASSET_API RV load_asset(asset_t asset, bool force_reload)
@@ -471,38 +448,17 @@ namespace Luna
             Name type = entry->type;
             entry->loading = true;
             g.unlock();
-            lutry
-            {
-                if (type.empty())
-                {
-                    luthrow(AssetError::asset_not_registered());
-                }
-                if (path.empty())
-                {
-                    luthrow(AssetError::empty_asset_path());
-                }
-                lulet(desc, get_asset_type_desc(type));
-                ObjRef data;
-                if (desc.on_load_asset)
-                {
-                    luset(data, desc.on_load_asset(desc.userdata.get(), asset, path));
-                }
-                else
-                {
-                    luthrow(set_error(BasicError::not_supported(), "Asset loading is not implemented by asset %s", type.c_str()));
-                }
-                g = entry->lock;
-                entry->data = data;
-                entry->loading = false;
-                g.unlock();
-            }
-            lucatch
+            auto data = internal_load_asset_data(asset, type, path);
+            g = entry->lock;
+            if (succeeded(data))
             {
-                g = entry->lock;
-                entry->loading = false;
-                g.unlock();
-                return luerr;
+                entry->data = data.get();
+                update_asset_residency(entry);
             }
+            entry->loading = false;
+            g.unlock();
+            if (failed(data)) return data.errcode();
+            enforce_asset_budgets(entry);
             return ok;
         }
         LUNA_ASSET_API RV load_asset_default_data(asset_t asset, bool force_reload)
@@ -534,8 +490,10 @@ namespace Luna
                 }
                 g = entry->lock;
                 entry->data = data;
+                update_asset_residency(entry);
                 entry->loading = false;
                 g.unlock();
+                enforce_asset_budgets(entry);
             }
             lucatch
             {
@@ -591,12 +549,14 @@ namespace Luna
             virtual const c8* get_name() override { return "Asset"; }
             virtual RV on_register() override
             {
-                return add_dependency_modules(this, {module_variant_utils(), module_vfs()});
+                return add_dependency_modules(this, {module_variant_utils(), module_vfs(), module_job_system()});
             }
             virtual RV on_init() override
             {
                 init_asset_type();
                 init_asset_registry();
+                init_asset_loading();
+                init_asset_hot_reload();
                 register_struct_type<asset_t>({});
                 SerializableTypeDesc desc;
                 desc.serialize_func = [](typeinfo_t type, const void* inst) -> R<Variant>
@@ -624,6 +584,8 @@ namespace Luna
             }
             virtual void on_close() override
             {
+                close_asset_hot_reload();
+                close_asset_loading();
                 close_asset_registry();
                 close_asset_type();
                 g_assets_mutex.reset();
@@ -680,5 +642,10 @@ namespace Luna
             static ErrCode v = get_error_code_by_name("AssetError", "asset_data_loading");
             return v;
         }
+        LUNA_ASSET_API ErrCode dependency_cycle()
+        {
+            static ErrCode v = get_error_code_by_name("AssetError", "dependency_cycle");
+            return v;
+        }
     }
 }
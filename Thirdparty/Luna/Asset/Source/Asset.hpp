@@ -12,6 +12,7 @@
 #include <Luna/Runtime/SpinLock.hpp>
 #include <Luna/Runtime/Mutex.hpp>
 #include <Luna/Runtime/Signal.hpp>
+#include "AssetLoading.hpp"
 
 namespace Luna
 {
@@ -32,7 +33,20 @@ namespace Luna
             Path path;
             ObjRef data;
             bool loading;
+            // The asynchronous loading request that is loading the asset data, if any.
+            Ref<AssetLoadingRequest> loading_request;
             SpinLock lock;
+            // Residency tracking states, protected by the residency lock. See AssetResidency.hpp.
+            AssetEntry* lru_prev = nullptr;
+            AssetEntry* lru_next = nullptr;
+            u64 resident_size = 0;
+            // The type that the resident data is counted to.
+            Name resident_type;
+            bool resident = false;
+            // Dependency graph states, protected by the dependency lock. See AssetDependency.hpp.
+            Vector<asset_t> dependencies;
+            Vector<asset_t> dependents;
+            bool dependencies_recorded = false;
             AssetEntry() :
                 loading(false) {}
             void reset()
@@ -41,8 +55,15 @@ namespace Luna
                 path.clear();
                 data.reset();
                 loading = false;
+                loading_request.reset();
             }
         };
+        struct AssetMetaUpdateInfo
+        {
+            Path path;
+            AssetMetaFile meta_file;
+        };
+        R<AssetMetaFile> internal_load_asset_meta(const Path& meta_path);
         void init_asset_registry();
         void close_asset_registry();
     }
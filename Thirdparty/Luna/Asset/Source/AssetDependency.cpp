@@ -0,0 +1,407 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetDependency.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_ASSET_API LUNA_EXPORT
+#include "AssetDependency.hpp"
+#include "AssetType.hpp"
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/Runtime/HashSet.hpp>
+
+namespace Luna
+{
+    namespace Asset
+    {
+        SpinLock g_dependency_lock;
+
+        inline void remove_asset_handle(Vector<asset_t>& assets, asset_t asset)
+        {
+            for (auto iter = assets.begin(); iter != assets.end(); ++iter)
+            {
+                if (*iter == asset)
+                {
+                    assets.swap_erase(iter);
+                    return;
+                }
+            }
+        }
+        inline bool contains_asset_handle(const Vector<asset_t>& assets, asset_t asset)
+        {
+            for (auto& a : assets)
+            {
+                if (a == asset) return true;
+            }
+            return false;
+        }
+        //! Replaces dependencies of the asset and updates dependents of old and new dependencies. The dependency lock must be held.
+        static void internal_set_asset_dependencies(AssetEntry* entry, const Vector<asset_t>& dependencies)
+        {
+            asset_t asset(entry);
+            for (auto& dep : entry->dependencies)
+            {
+                remove_asset_handle(((AssetEntry*)dep.handle)->dependents, asset);
+            }
+            entry->dependencies = dependencies;
+            for (auto& dep : entry->dependencies)
+            {
+                ((AssetEntry*)dep.handle)->dependents.push_back(asset);
+            }
+            entry->dependencies_recorded = true;
+        }
+        void clear_asset_dependencies(AssetEntry* entry)
+        {
+            LockGuard guard(g_dependency_lock);
+            internal_set_asset_dependencies(entry, Vector<asset_t>());
+            entry->dependencies_recorded = false;
+        }
+        LUNA_ASSET_API void get_asset_dependencies(asset_t asset, Vector<asset_t>& dependencies)
+        {
+            lucheck_msg(asset.handle, "Asset handle must not be null!");
+            AssetEntry* entry = (AssetEntry*)asset.handle;
+            LockGuard guard(g_dependency_lock);
+            dependencies.insert(dependencies.end(), entry->dependencies.begin(), entry->dependencies.end());
+        }
+        LUNA_ASSET_API void get_asset_dependents(asset_t asset, Vector<asset_t>& dependents)
+        {
+            lucheck_msg(asset.handle, "Asset handle must not be null!");
+            AssetEntry* entry = (AssetEntry*)asset.handle;
+            LockGuard guard(g_dependency_lock);
+            dependents.insert(dependents.end(), entry->dependents.begin(), entry->dependents.end());
+        }
+
+        struct DependencyLoadNode
+        {
+            asset_t asset;
+            bool force_reload;
+            //! Whether the dependencies are fetched from the asset type instead of the recorded ones.
+            bool query_dependencies;
+            Vector<asset_t> dependencies;
+            //! Indices of nodes that depend on this node.
+            Vector<u32> dependents;
+            //! The number of dependencies that are not finished yet. The node is started when this reaches 0.
+            u32 num_pending_dependencies;
+        };
+
+        //! The dependency closure of a set of assets being loaded.
+        struct DependencyLoadGraph
+        {
+            Vector<DependencyLoadNode> m_nodes;
+            HashMap<opaque_t, u32> m_node_indices;
+            JobSystem::JobPriority m_priority;
+            //! The job ID that is finished when all nodes are finished.
+            JobSystem::job_id_t m_job_id = JobSystem::INVALID_JOB_ID;
+            //! The following states are protected by `m_lock` when the graph is being loaded.
+            usize m_num_unfinished_nodes = 0;
+            ErrCode m_result = ErrCode(0);
+            asset_t m_failed_asset;
+            SpinLock m_lock;
+
+            //! Adds one node if the asset is not in the graph.
+            //! @return Returns `true` if the node is added.
+            bool add_node(asset_t asset, bool force_reload)
+            {
+                auto iter = m_node_indices.insert(make_pair(asset.handle, (u32)m_nodes.size()));
+                if (!iter.second) return false;
+                DependencyLoadNode node;
+                node.asset = asset;
+                node.force_reload = force_reload;
+                node.query_dependencies = false;
+                node.num_pending_dependencies = 0;
+                m_nodes.push_back(move(node));
+                return true;
+            }
+        };
+
+        //! Fetches dependencies of the asset. Recorded dependencies are used if the asset is loaded and is not reloaded.
+        static RV fetch_asset_dependencies(DependencyLoadNode& node)
+        {
+            AssetEntry* entry = (AssetEntry*)node.asset.handle;
+            LockGuard guard(entry->lock);
+            bool loaded = entry->data.valid();
+            Name type = entry->type;
+            Path path = entry->path;
+            guard.unlock();
+            if (loaded && !node.force_reload)
+            {
+                LockGuard dependency_guard(g_dependency_lock);
+                if (entry->dependencies_recorded)
+                {
+                    node.dependencies = entry->dependencies;
+                    return ok;
+                }
+            }
+            node.query_dependencies = true;
+            lutry
+            {
+                if (type.empty())
+                {
+                    luthrow(AssetError::asset_not_registered());
+                }
+                lulet(desc, get_asset_type_desc(type));
+                if (desc.on_get_asset_dependencies)
+                {
+                    Vector<asset_t> dependencies;
+                    luexp(desc.on_get_asset_dependencies(desc.userdata.get(), node.asset, path, dependencies));
+                    // Removes null and duplicated handles.
+                    for (auto& dep : dependencies)
+                    {
+                        if (dep && !contains_asset_handle(node.dependencies, dep))
+                        {
+                            node.dependencies.push_back(dep);
+                        }
+                    }
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+
+        //! Collects the dependency closure of the graph nodes.
+        //! @param[in] force_reload_dependencies Whether to reload assets that are added to the graph as dependencies.
+        static RV collect_dependency_graph(DependencyLoadGraph& graph, bool force_reload_dependencies)
+        {
+            // Dependencies of nodes added in the same round are fetched in parallel, since fetching dependencies may read files.
+            usize round_begin = 0;
+            while (round_begin < graph.m_nodes.size())
+            {
+                usize round_end = graph.m_nodes.size();
+                Vector<Error> errors(round_end - round_begin);
+                JobSystem::parallel_for(round_begin, round_end, 1, [&graph, &errors, round_begin](usize i)
+                {
+                    DependencyLoadNode& node = graph.m_nodes[i];
+                    auto r = fetch_asset_dependencies(node);
+                    if (failed(r))
+                    {
+                        if (r.errcode() == BasicError::error_object())
+                        {
+                            // The error object is stored in the worker thread, so copies it.
+                            errors[i - round_begin] = get_error();
+                        }
+                        else
+                        {
+                            errors[i - round_begin] = Error(r.errcode(), "Failed to get dependencies of asset %s.", get_asset_path(node.asset).encode().c_str());
+                        }
+                    }
+                });
+                for (auto& err : errors)
+                {
+                    if (err.code.code)
+                    {
+                        get_error() = move(err);
+                        return BasicError::error_object();
+                    }
+                }
+                for (usize i = round_begin; i < round_end; ++i)
+                {
+                    // Copies dependencies, since adding nodes may reallocate the node array.
+                    Vector<asset_t> dependencies = graph.m_nodes[i].dependencies;
+                    for (auto& dep : dependencies)
+                    {
+                        graph.add_node(dep, force_reload_dependencies);
+                        u32 dep_index = graph.m_node_indices.find(dep.handle)->second;
+                        graph.m_nodes[dep_index].dependents.push_back((u32)i);
+                    }
+                    graph.m_nodes[i].num_pending_dependencies = (u32)dependencies.size();
+                }
+                round_begin = round_end;
+            }
+            // Checks cycles by sorting nodes topologically, all nodes can be visited only if there is no cycle.
+            Vector<u32> num_pending(graph.m_nodes.size());
+            Vector<u32> ready;
+            for (u32 i = 0; i < (u32)graph.m_nodes.size(); ++i)
+            {
+                num_pending[i] = graph.m_nodes[i].num_pending_dependencies;
+                if (!num_pending[i]) ready.push_back(i);
+            }
+            usize num_visited = 0;
+            while (!ready.empty())
+            {
+                u32 i = ready.back();
+                ready.pop_back();
+                ++num_visited;
+                for (u32 dependent : graph.m_nodes[i].dependents)
+                {
+                    if (!--num_pending[dependent]) ready.push_back(dependent);
+                }
+            }
+            if (num_visited != graph.m_nodes.size())
+            {
+                for (u32 i = 0; i < (u32)graph.m_nodes.size(); ++i)
+                {
+                    if (num_pending[i])
+                    {
+                        return set_error(AssetError::dependency_cycle(), "The dependencies of asset %s contain one cycle.",
+                            get_asset_path(graph.m_nodes[i].asset).encode().c_str());
+                    }
+                }
+            }
+            return ok;
+        }
+
+        static void start_dependency_load_node(DependencyLoadGraph* graph, u32 index);
+
+        //! Finishes one node and starts nodes whose dependencies are all finished.
+        static void finish_dependency_load_node(DependencyLoadGraph* graph, u32 index, ErrCode result)
+        {
+            // Queried dependencies are recorded only after the asset is loaded, so that assets that fail to load or are 
+            // not loaded because of cycles or failed dependencies do not change the dependency index.
+            DependencyLoadNode& node = graph->m_nodes[index];
+            if (!result.code && node.query_dependencies)
+            {
+                LockGuard dependency_guard(g_dependency_lock);
+                internal_set_asset_dependencies((AssetEntry*)node.asset.handle, node.dependencies);
+            }
+            Vector<u32> ready;
+            Vector<u32> finished;
+            finished.push_back(index);
+            LockGuard guard(graph->m_lock);
+            if (result.code && !graph->m_result.code)
+            {
+                graph->m_result = result;
+                graph->m_failed_asset = graph->m_nodes[index].asset;
+            }
+            usize num_finished = 0;
+            while (!finished.empty())
+            {
+                u32 i = finished.back();
+                finished.pop_back();
+                ++num_finished;
+                for (u32 dependent : graph->m_nodes[i].dependents)
+                {
+                    if (--graph->m_nodes[dependent].num_pending_dependencies) continue;
+                    // Remaining nodes are finished without being loaded if any node fails.
+                    if (graph->m_result.code) finished.push_back(dependent);
+                    else ready.push_back(dependent);
+                }
+            }
+            graph->m_num_unfinished_nodes -= num_finished;
+            bool all_finished = graph->m_num_unfinished_nodes == 0;
+            JobSystem::job_id_t job_id = graph->m_job_id;
+            guard.unlock();
+            // The graph may be destroyed once the last node is finished, so it must not be accessed after starting the last ready node.
+            for (u32 i : ready)
+            {
+                start_dependency_load_node(graph, i);
+            }
+            if (all_finished)
+            {
+                JobSystem::finish_job_id(job_id);
+            }
+        }
+
+        struct DependencyLoadJobParams
+        {
+            DependencyLoadGraph* m_graph;
+            u32 m_index;
+            Ref<IAssetLoadingRequest> m_request;
+        };
+        static void dependency_load_job(void* params)
+        {
+            DependencyLoadJobParams* p = (DependencyLoadJobParams*)params;
+            DependencyLoadGraph* graph = p->m_graph;
+            u32 index = p->m_index;
+            RV r = p->m_request->get_result();
+            p->~DependencyLoadJobParams();
+            finish_dependency_load_node(graph, index, failed(r) ? r.errcode() : ErrCode(0));
+        }
+        static void start_dependency_load_node(DependencyLoadGraph* graph, u32 index)
+        {
+            DependencyLoadNode& node = graph->m_nodes[index];
+            auto request = load_asset_async(node.asset, graph->m_priority, node.force_reload);
+            if (failed(request))
+            {
+                finish_dependency_load_node(graph, index, request.errcode());
+                return;
+            }
+            // Finishes the node after the request is finished, without blocking any thread.
+            void* params = JobSystem::new_job(dependency_load_job, sizeof(DependencyLoadJobParams), alignof(DependencyLoadJobParams));
+            DependencyLoadJobParams* p = new (params) DependencyLoadJobParams();
+            p->m_graph = graph;
+            p->m_index = index;
+            p->m_request = request.get();
+            JobSystem::job_id_t request_job_id = p->m_request->get_job_id();
+            JobSystem::submit_job_after(params, request_job_id, graph->m_priority);
+        }
+
+        //! Loads all nodes of the graph in dependency order, and waits for all nodes to finish.
+        static RV load_dependency_graph(DependencyLoadGraph& graph)
+        {
+            if (graph.m_nodes.empty()) return ok;
+            Vector<u32> ready;
+            for (u32 i = 0; i < (u32)graph.m_nodes.size(); ++i)
+            {
+                if (!graph.m_nodes[i].num_pending_dependencies) ready.push_back(i);
+            }
+            graph.m_num_unfinished_nodes = graph.m_nodes.size();
+            graph.m_job_id = JobSystem::allocate_job_id();
+            for (u32 i : ready)
+            {
+                start_dependency_load_node(&graph, i);
+            }
+            JobSystem::wait_job(graph.m_job_id);
+            if (graph.m_result.code)
+            {
+                // Loading errors may be set on worker threads, so only the error code is reported.
+                ErrCode err = graph.m_result == BasicError::error_object() ? BasicError::failure() : graph.m_result;
+                return set_error(err, "Failed to load asset %s.", get_asset_path(graph.m_failed_asset).encode().c_str());
+            }
+            return ok;
+        }
+        LUNA_ASSET_API RV load_asset_with_dependencies(asset_t asset, JobSystem::JobPriority priority, bool force_reload)
+        {
+            lucheck_msg(asset.handle, "Asset handle must not be null!");
+            DependencyLoadGraph graph;
+            graph.m_priority = priority;
+            graph.add_node(asset, force_reload);
+            lutry
+            {
+                luexp(collect_dependency_graph(graph, force_reload));
+                luexp(load_dependency_graph(graph));
+            }
+            lucatchret;
+            return ok;
+        }
+        LUNA_ASSET_API RV reload_assets(Span<const asset_t> assets, JobSystem::JobPriority priority)
+        {
+            // Finds all assets that depend on modified assets through the reverse dependency index.
+            HashSet<opaque_t> visited;
+            Vector<asset_t> stack;
+            for (auto& asset : assets)
+            {
+                lucheck_msg(asset.handle, "Asset handle must not be null!");
+                stack.push_back(asset);
+            }
+            DependencyLoadGraph graph;
+            graph.m_priority = priority;
+            while (!stack.empty())
+            {
+                asset_t asset = stack.back();
+                stack.pop_back();
+                if (!visited.insert(asset.handle).second) continue;
+                AssetEntry* entry = (AssetEntry*)asset.handle;
+                LockGuard guard(entry->lock);
+                // Assets that are not loaded do not need to be reloaded, they will load new data when being loaded.
+                if (entry->data.valid())
+                {
+                    graph.add_node(asset, true);
+                }
+                LockGuard dependency_guard(g_dependency_lock);
+                stack.insert(stack.end(), entry->dependents.begin(), entry->dependents.end());
+            }
+            lutry
+            {
+                // Dependencies that are not reloaded are only loaded if they are not loaded.
+                luexp(collect_dependency_graph(graph, false));
+                luexp(load_dependency_graph(graph));
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
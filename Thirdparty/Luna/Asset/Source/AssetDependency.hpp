@@ -0,0 +1,24 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetDependency.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Asset.hpp"
+
+namespace Luna
+{
+    namespace Asset
+    {
+        // Every asset records its dependencies and dependents, so that the dependency graph can be walked in both directions.
+        // The graph is protected by one global dependency lock, which is always acquired after the asset entry lock.
+
+        //! Removes the asset from dependents of all its dependencies, and clears its dependencies.
+        //! Dependents of the asset are kept, since they may still refer to the asset.
+        void clear_asset_dependencies(AssetEntry* entry);
+    }
+}
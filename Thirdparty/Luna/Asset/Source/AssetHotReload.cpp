@@ -0,0 +1,169 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetHotReload.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_ASSET_API LUNA_EXPORT
+#include "AssetHotReload.hpp"
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/Runtime/Mutex.hpp>
+#include <Luna/VFS/VFS.hpp>
+
+namespace Luna
+{
+    namespace Asset
+    {
+        //! The file state used to detect modifications. The size is also compared, since the last write time may
+        //! not change if the file is modified in the timestamp resolution.
+        struct WatchedFileState
+        {
+            i64 last_write_time;
+            u64 size;
+
+            bool operator==(const WatchedFileState& rhs) const
+            {
+                return last_write_time == rhs.last_write_time && size == rhs.size;
+            }
+        };
+        struct WatchedAssetDir
+        {
+            Path path;
+            //! The state of every file in the directory recursively.
+            HashMap<Path, WatchedFileState> file_states;
+        };
+        Ref<IMutex> g_watch_mutex;
+        Vector<WatchedAssetDir> g_watched_dirs;
+
+        void init_asset_hot_reload()
+        {
+            g_watch_mutex = new_mutex();
+        }
+        void close_asset_hot_reload()
+        {
+            g_watched_dirs.clear();
+            g_watched_dirs.shrink_to_fit();
+            g_watch_mutex.reset();
+        }
+        static RV scan_watched_dir(const Path& dir, HashMap<Path, WatchedFileState>& file_states)
+        {
+            lutry
+            {
+                lulet(iter, VFS::open_dir(dir));
+                Path path = dir;
+                for (; iter->is_valid(); iter->move_next())
+                {
+                    const c8* filename = iter->get_filename();
+                    if (!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
+                    path.push_back(filename);
+                    if (test_flags(iter->get_attributes(), FileAttributeFlag::directory))
+                    {
+                        luexp(scan_watched_dir(path, file_states));
+                    }
+                    else
+                    {
+                        lulet(attr, VFS::get_file_attribute(path));
+                        file_states.insert(make_pair(path, WatchedFileState{ attr.last_write_time, attr.size }));
+                    }
+                    path.pop_back();
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        //! Finds the asset that the file belongs to. Asset files are named by the asset name, optionally followed by extensions,
+        //! so the file path is checked with extensions removed one by one.
+        static asset_t get_asset_by_file_path(const Path& file_path)
+        {
+            if (file_path.empty() || !strcmp(file_path.extension().c_str(), "meta")) return asset_t();
+            Path path = file_path;
+            Name filename = file_path.back();
+            const c8* name = filename.c_str();
+            for (usize i = filename.size(); i > 0; --i)
+            {
+                if (i != filename.size() && name[i] != '.') continue;
+                path.back() = Name(name, i);
+                auto asset = get_asset_by_path(path);
+                if (succeeded(asset)) return asset.get();
+            }
+            return asset_t();
+        }
+        LUNA_ASSET_API RV watch_asset_dir(const Path& dir)
+        {
+            HashMap<Path, WatchedFileState> file_states;
+            lutry
+            {
+                luexp(scan_watched_dir(dir, file_states));
+            }
+            lucatchret;
+            MutexGuard guard(g_watch_mutex);
+            for (auto& d : g_watched_dirs)
+            {
+                if (d.path == dir)
+                {
+                    d.file_states = move(file_states);
+                    return ok;
+                }
+            }
+            WatchedAssetDir d;
+            d.path = dir;
+            d.file_states = move(file_states);
+            g_watched_dirs.push_back(move(d));
+            return ok;
+        }
+        LUNA_ASSET_API void unwatch_asset_dir(const Path& dir)
+        {
+            MutexGuard guard(g_watch_mutex);
+            for (auto iter = g_watched_dirs.begin(); iter != g_watched_dirs.end(); ++iter)
+            {
+                if (iter->path == dir)
+                {
+                    g_watched_dirs.erase(iter);
+                    return;
+                }
+            }
+        }
+        LUNA_ASSET_API R<usize> reload_modified_assets(JobSystem::JobPriority priority)
+        {
+            Vector<asset_t> modified_assets;
+            lutry
+            {
+                MutexGuard guard(g_watch_mutex);
+                for (auto& d : g_watched_dirs)
+                {
+                    HashMap<Path, WatchedFileState> file_states;
+                    luexp(scan_watched_dir(d.path, file_states));
+                    for (auto& f : file_states)
+                    {
+                        auto iter = d.file_states.find(f.first);
+                        if (iter != d.file_states.end() && iter->second == f.second) continue;
+                        asset_t asset = get_asset_by_file_path(f.first);
+                        if (!asset) continue;
+                        bool found = false;
+                        for (auto& a : modified_assets)
+                        {
+                            if (a == asset)
+                            {
+                                found = true;
+                                break;
+                            }
+                        }
+                        if (!found) modified_assets.push_back(asset);
+                    }
+                    d.file_states = move(file_states);
+                }
+                guard.unlock();
+                if (!modified_assets.empty())
+                {
+                    luexp(reload_assets({ modified_assets.data(), modified_assets.size() }, priority));
+                }
+            }
+            lucatchret;
+            return modified_assets.size();
+        }
+    }
+}
@@ -0,0 +1,20 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetHotReload.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "../Asset.hpp"
+
+namespace Luna
+{
+    namespace Asset
+    {
+        void init_asset_hot_reload();
+        void close_asset_hot_reload();
+    }
+}
@@ -0,0 +1,371 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file AssetLoading.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_ASSET_API LUNA_EXPORT
+#include "AssetLoading.hpp"
+#include "Asset.hpp"
+#include "AssetType.hpp"
+#include "AssetResidency.hpp"
+#include <Luna/Runtime/RingDeque.hpp>
+#include <Luna/Runtime/HashSet.hpp>
+#include <Luna/Runtime/Thread.hpp>
+
+namespace Luna
+{
+    namespace Asset
+    {
+        constexpr u32 NUM_LOADING_PRIORITIES = 3;
+
+        // Pending requests of every priority. Requests are removed lazily: one request may be pushed to multiple queues
+        // if it is reprioritized, and entries whose priority does not match the request priority are skipped when being popped.
+        RingDeque<Ref<AssetLoadingRequest>> g_pending_requests[NUM_LOADING_PRIORITIES];
+        // Requests that are created by `load_asset_async` and are not finished yet. Requests are removed before their job IDs 
+        // are finished, so they are always valid when being accessed with `g_pending_requests_lock` held.
+        HashSet<AssetLoadingRequest*> g_unfinished_requests;
+        SpinLock g_pending_requests_lock;
+
+        void init_asset_loading()
+        {
+            register_boxed_type<AssetLoadingRequest>();
+            impl_interface_for_type<AssetLoadingRequest, IAssetLoadingRequest, IWaitable>();
+        }
+        void close_asset_loading()
+        {
+            // Cancels all unfinished requests and waits for jobs that are processing them, so that no job accesses asset
+            // entries after the asset registry is closed, and nothing waits for requests that will never be finished.
+            Vector<Ref<AssetLoadingRequest>> requests;
+            LockGuard guard(g_pending_requests_lock);
+            for (AssetLoadingRequest* request : g_unfinished_requests)
+            {
+                requests.push_back(request);
+            }
+            guard.unlock();
+            for (auto& request : requests)
+            {
+                request->cancel();
+            }
+            for (auto& request : requests)
+            {
+                JobSystem::wait_job(request->m_job_id);
+            }
+            // Callbacks of cancelled requests are marshalled to the main thread.
+            if (get_current_thread() == get_main_thread())
+            {
+                JobSystem::run_main_thread_jobs();
+            }
+            requests.clear();
+            guard = g_pending_requests_lock;
+            g_unfinished_requests.clear();
+            g_unfinished_requests.shrink_to_fit();
+            for (auto& queue : g_pending_requests)
+            {
+                queue.clear();
+                queue.shrink_to_fit();
+            }
+        }
+        R<ObjRef> internal_load_asset_data(asset_t asset, const Name& type, const Path& path)
+        {
+            ObjRef data;
+            lutry
+            {
+                if (type.empty())
+                {
+                    luthrow(AssetError::asset_not_registered());
+                }
+                if (path.empty())
+                {
+                    luthrow(AssetError::empty_asset_path());
+                }
+                lulet(desc, get_asset_type_desc(type));
+                if (desc.on_load_asset)
+                {
+                    luset(data, desc.on_load_asset(desc.userdata.get(), asset, path));
+                }
+                else if (desc.on_read_asset_file && desc.on_decode_asset)
+                {
+                    lulet(file_data, desc.on_read_asset_file(desc.userdata.get(), asset, path));
+                    luset(data, desc.on_decode_asset(desc.userdata.get(), asset, path, file_data));
+                }
+                else
+                {
+                    luthrow(set_error(BasicError::not_supported(), "Asset loading is not implemented by asset %s", type.c_str()));
+                }
+            }
+            lucatchret;
+            return data;
+        }
+
+        struct AssetLoadingCallbackJobParams
+        {
+            asset_t m_asset;
+            ErrCode m_result;
+            Vector<Function<asset_loading_callback_t>> m_callbacks;
+        };
+        static void asset_loading_callback_job(void* params)
+        {
+            AssetLoadingCallbackJobParams* p = (AssetLoadingCallbackJobParams*)params;
+            RV result = p->m_result.code ? RV(p->m_result) : ok;
+            for (auto& callback : p->m_callbacks)
+            {
+                callback(p->m_asset, result);
+            }
+            p->~AssetLoadingCallbackJobParams();
+        }
+        static void submit_loading_callbacks(asset_t asset, ErrCode result, Vector<Function<asset_loading_callback_t>>&& callbacks)
+        {
+            if (callbacks.empty()) return;
+            void* params = JobSystem::new_job(asset_loading_callback_job, sizeof(AssetLoadingCallbackJobParams), alignof(AssetLoadingCallbackJobParams));
+            AssetLoadingCallbackJobParams* p = new (params) AssetLoadingCallbackJobParams();
+            p->m_asset = asset;
+            p->m_result = result;
+            p->m_callbacks = move(callbacks);
+            JobSystem::submit_main_thread_job(params);
+        }
+        //! Stores the loaded data to the asset and finishes the request.
+        static void finish_loading_request(AssetLoadingRequest* request, R<ObjRef> data)
+        {
+            ErrCode result = failed(data) ? data.errcode() : ErrCode(0);
+            AssetEntry* entry = (AssetEntry*)request->m_asset.handle;
+            LockGuard entry_guard(entry->lock);
+            // The request may be detached from the entry if the asset is deleted while loading.
+            bool attached = entry->loading_request.get() == request;
+            LockGuard guard(request->m_lock);
+            if (request->m_cancelled || !attached)
+            {
+                result = BasicError::interrupted();
+            }
+            if (attached)
+            {
+                if (!result.code)
+                {
+                    entry->data = data.get();
+                    update_asset_residency(entry);
+                }
+                entry->loading = false;
+            }
+            request->m_status = AssetLoadingStatus::finished;
+            request->m_result = result;
+            Vector<Function<asset_loading_callback_t>> callbacks = move(request->m_callbacks);
+            guard.unlock();
+            // Keeps the request alive until the job ID is finished.
+            Ref<AssetLoadingRequest> request_ref = request;
+            if (attached)
+            {
+                entry->loading_request.reset();
+            }
+            entry_guard.unlock();
+            if (attached && !result.code)
+            {
+                enforce_asset_budgets(entry);
+            }
+            {
+                LockGuard requests_guard(g_pending_requests_lock);
+                g_unfinished_requests.erase(request);
+            }
+            JobSystem::finish_job_id(request->m_job_id);
+            submit_loading_callbacks(request->m_asset, result, move(callbacks));
+        }
+
+        struct AssetDecodeJobParams
+        {
+            Ref<AssetLoadingRequest> m_request;
+            AssetTypeDesc m_desc;
+            Path m_path;
+            Blob m_file_data;
+        };
+        static void asset_decode_job(void* params)
+        {
+            AssetDecodeJobParams* p = (AssetDecodeJobParams*)params;
+            AssetLoadingRequest* request = p->m_request;
+            if (request->is_cancelled())
+            {
+                finish_loading_request(request, BasicError::interrupted());
+            }
+            else
+            {
+                finish_loading_request(request, p->m_desc.on_decode_asset(p->m_desc.userdata.get(), request->m_asset, p->m_path, p->m_file_data));
+            }
+            p->~AssetDecodeJobParams();
+        }
+        //! Runs the I/O stage of the request, and submits the decode stage if needed.
+        static void run_loading_request(AssetLoadingRequest* request)
+        {
+            AssetEntry* entry = (AssetEntry*)request->m_asset.handle;
+            LockGuard entry_guard(entry->lock);
+            Name type = entry->type;
+            Path path = entry->path;
+            entry_guard.unlock();
+            lutry
+            {
+                if (type.empty())
+                {
+                    luthrow(AssetError::asset_not_registered());
+                }
+                if (path.empty())
+                {
+                    luthrow(AssetError::empty_asset_path());
+                }
+                lulet(desc, get_asset_type_desc(type));
+                if (!desc.on_load_asset && desc.on_read_asset_file && desc.on_decode_asset)
+                {
+                    lulet(file_data, desc.on_read_asset_file(desc.userdata.get(), request->m_asset, path));
+                    if (request->is_cancelled())
+                    {
+                        luthrow(BasicError::interrupted());
+                    }
+                    // Decode the data in one separate job, so that this worker can start the I/O stage of the next request.
+                    void* params = JobSystem::new_job(asset_decode_job, sizeof(AssetDecodeJobParams), alignof(AssetDecodeJobParams));
+                    AssetDecodeJobParams* p = new (params) AssetDecodeJobParams();
+                    p->m_request = request;
+                    p->m_desc = desc;
+                    p->m_path = move(path);
+                    p->m_file_data = move(file_data);
+                    JobSystem::submit_job(params, request->get_priority());
+                    return;
+                }
+                lulet(data, internal_load_asset_data(request->m_asset, type, path));
+                finish_loading_request(request, data);
+            }
+            lucatch
+            {
+                finish_loading_request(request, luerr);
+            }
+        }
+        //! Pops the pending request with the highest priority, and marks it as loading.
+        static Ref<AssetLoadingRequest> pop_pending_request()
+        {
+            LockGuard guard(g_pending_requests_lock);
+            for (u32 priority = 0; priority < NUM_LOADING_PRIORITIES; ++priority)
+            {
+                auto& queue = g_pending_requests[priority];
+                while (!queue.empty())
+                {
+                    Ref<AssetLoadingRequest> request = move(queue.front());
+                    queue.pop_front();
+                    LockGuard request_guard(request->m_lock);
+                    if (request->m_status == AssetLoadingStatus::pending && (u32)request->m_priority == priority)
+                    {
+                        request->m_status = AssetLoadingStatus::loading;
+                        return request;
+                    }
+                }
+            }
+            return nullptr;
+        }
+        static void asset_loading_job(void* params)
+        {
+            // Every queued request submits one job, and the job processes the request with the highest priority 
+            // when it is executed, which may not be the request that submits the job.
+            Ref<AssetLoadingRequest> request = pop_pending_request();
+            if (request)
+            {
+                run_loading_request(request);
+            }
+        }
+        void enqueue_loading_request(AssetLoadingRequest* request, JobSystem::JobPriority priority)
+        {
+            {
+                LockGuard guard(g_pending_requests_lock);
+                g_pending_requests[(u32)priority].push_back(request);
+            }
+            void* params = JobSystem::new_job(asset_loading_job, 0, 1);
+            JobSystem::submit_job(params, priority);
+        }
+        Ref<AssetLoadingRequest> new_finished_loading_request(asset_t asset, ErrCode result)
+        {
+            Ref<AssetLoadingRequest> request = new_object<AssetLoadingRequest>();
+            request->m_asset = asset;
+            request->m_status = AssetLoadingStatus::finished;
+            request->m_result = result;
+            request->m_job_id = JobSystem::allocate_job_id();
+            JobSystem::finish_job_id(request->m_job_id);
+            return request;
+        }
+        RV AssetLoadingRequest::get_result()
+        {
+            LockGuard guard(m_lock);
+            if (m_status != AssetLoadingStatus::finished) return BasicError::in_progress();
+            return m_result.code ? RV(m_result) : ok;
+        }
+        void AssetLoadingRequest::set_priority(JobSystem::JobPriority priority)
+        {
+            LockGuard guard(m_lock);
+            if (m_priority == priority) return;
+            m_priority = priority;
+            if (m_status != AssetLoadingStatus::pending) return;
+            guard.unlock();
+            // The old queue entry is skipped when being popped.
+            enqueue_loading_request(this, priority);
+        }
+        void AssetLoadingRequest::cancel()
+        {
+            LockGuard guard(m_lock);
+            if (m_status == AssetLoadingStatus::finished || m_cancelled) return;
+            m_cancelled = true;
+            if (m_status == AssetLoadingStatus::pending)
+            {
+                // Take the request from the queue, so that no job processes it.
+                m_status = AssetLoadingStatus::loading;
+                guard.unlock();
+                finish_loading_request(this, BasicError::interrupted());
+            }
+        }
+        void AssetLoadingRequest::add_callback(const Function<asset_loading_callback_t>& callback)
+        {
+            LockGuard guard(m_lock);
+            if (m_status != AssetLoadingStatus::finished)
+            {
+                m_callbacks.push_back(callback);
+                return;
+            }
+            ErrCode result = m_result;
+            guard.unlock();
+            Vector<Function<asset_loading_callback_t>> callbacks;
+            callbacks.push_back(callback);
+            submit_loading_callbacks(m_asset, result, move(callbacks));
+        }
+        LUNA_ASSET_API R<Ref<IAssetLoadingRequest>> load_asset_async(asset_t asset, JobSystem::JobPriority priority, bool force_reload)
+        {
+            lucheck_msg(asset.handle, "Asset handle must not be null!");
+            AssetEntry* entry = (AssetEntry*)asset.handle;
+            LockGuard g(entry->lock);
+            if (entry->loading_request)
+            {
+                Ref<AssetLoadingRequest> request = entry->loading_request;
+                g.unlock();
+                // Raise the priority of the existing request. Smaller values represent higher priorities.
+                if ((u32)priority < (u32)request->get_priority())
+                {
+                    request->set_priority(priority);
+                }
+                return Ref<IAssetLoadingRequest>(request);
+            }
+            if (entry->data.valid() && !force_reload)
+            {
+                return Ref<IAssetLoadingRequest>(new_finished_loading_request(asset, ErrCode(0)));
+            }
+            // The asset is being loaded synchronously by another thread.
+            if (entry->loading) return AssetError::asset_data_loading();
+            Ref<AssetLoadingRequest> request = new_object<AssetLoadingRequest>();
+            request->m_asset = asset;
+            request->m_priority = priority;
+            request->m_job_id = JobSystem::allocate_job_id();
+            entry->loading = true;
+            entry->loading_request = request;
+            g.unlock();
+            {
+                LockGuard guard(g_pending_requests_lock);
+                g_unfinished_requests.insert(request.get());
+            }
+            enqueue_loading_request(request, priority);
+            return Ref<IAssetLoadingRequest>(request);
+        }
+    }
+}
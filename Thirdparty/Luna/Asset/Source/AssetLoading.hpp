@@ -0,0 +1,78 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file AssetLoading.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "../Asset.hpp"
+#include <Luna/Runtime/SpinLock.hpp>
+#include <Luna/Runtime/Vector.hpp>
+
+namespace Luna
+{
+    namespace Asset
+    {
+        struct AssetLoadingRequest : IAssetLoadingRequest
+        {
+            lustruct("Asset::AssetLoadingRequest", "{4e9c2b7a-1d58-4f36-8a0e-c5b3d7f19264}");
+            luiimpl();
+
+            asset_t m_asset;
+            JobSystem::job_id_t m_job_id = JobSystem::INVALID_JOB_ID;
+            JobSystem::JobPriority m_priority = JobSystem::JobPriority::normal;
+            AssetLoadingStatus m_status = AssetLoadingStatus::pending;
+            bool m_cancelled = false;
+            //! The loading result, valid when the request is finished. 0 means success.
+            ErrCode m_result = ErrCode(0);
+            Vector<Function<asset_loading_callback_t>> m_callbacks;
+            SpinLock m_lock;
+
+            bool is_cancelled()
+            {
+                LockGuard guard(m_lock);
+                return m_cancelled;
+            }
+
+            virtual void wait() override
+            {
+                JobSystem::wait_job(m_job_id);
+            }
+            virtual bool try_wait() override
+            {
+                return JobSystem::is_job_finished(m_job_id);
+            }
+            virtual asset_t get_asset() override { return m_asset; }
+            virtual JobSystem::job_id_t get_job_id() override { return m_job_id; }
+            virtual AssetLoadingStatus get_status() override
+            {
+                LockGuard guard(m_lock);
+                return m_status;
+            }
+            virtual RV get_result() override;
+            virtual JobSystem::JobPriority get_priority() override
+            {
+                LockGuard guard(m_lock);
+                return m_priority;
+            }
+            virtual void set_priority(JobSystem::JobPriority priority) override;
+            virtual void cancel() override;
+            virtual void add_callback(const Function<asset_loading_callback_t>& callback) override;
+        };
+
+        //! Loads asset data by calling asset type callbacks on the current thread.
+        R<ObjRef> internal_load_asset_data(asset_t asset, const Name& type, const Path& path);
+
+        //! Creates one request that is finished with the specified result.
+        Ref<AssetLoadingRequest> new_finished_loading_request(asset_t asset, ErrCode result);
+
+        //! Queues one request and submits one job to process it.
+        void enqueue_loading_request(AssetLoadingRequest* request, JobSystem::JobPriority priority);
+
+        void init_asset_loading();
+        void close_asset_loading();
+    }
+}
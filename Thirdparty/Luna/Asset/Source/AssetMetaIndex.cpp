@@ -0,0 +1,432 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetMetaIndex.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_ASSET_API LUNA_EXPORT
+#include "AssetMetaIndex.hpp"
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/VFS/VFS.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
+
+namespace Luna
+{
+    namespace Asset
+    {
+        // The index file stores one snapshot of all metadata files in one directory tree:
+        //
+        // AssetMetaIndexHeader
+        // AssetMetaIndexDirRecord[num_dirs]        Directories in depth-first order, the first directory is the root directory.
+        // AssetMetaIndexEntryRecord[num_entries]   Metadata files, files in the same directory are stored continuously.
+        // c8[string_table_size]                    Names of directories, assets and asset types.
+        //
+        // Records are stored in native byte order, the index file is rebuilt if it is loaded on one platform with
+        // different byte order, since the magic number will not match.
+        constexpr u32 ASSET_META_INDEX_MAGIC = 0x58444D4C; // "LMDX"
+        constexpr u32 ASSET_META_INDEX_VERSION = 1;
+
+        struct AssetMetaIndexHeader
+        {
+            u32 magic;
+            u32 version;
+            u32 num_dirs;
+            u32 num_entries;
+            u64 string_table_size;
+        };
+
+        struct AssetMetaIndexDirRecord
+        {
+            //! The index of the parent directory, `U32_MAX` for the root directory.
+            u32 parent;
+            u32 name_offset;
+            u32 name_size;
+            u32 first_entry;
+            u32 num_entries;
+            u32 reserved;
+            //! The last write time of the directory, which changes if any file is added, removed or renamed
+            //! in the directory.
+            i64 last_write_time;
+        };
+
+        struct AssetMetaIndexEntryRecord
+        {
+            u64 guid_high;
+            u64 guid_low;
+            //! The asset name, which is the metadata file name without the ".meta" extension.
+            u32 name_offset;
+            u32 name_size;
+            u32 type_offset;
+            u32 type_size;
+            //! The last write time of the metadata file.
+            i64 last_write_time;
+            //! The size of the metadata file.
+            u64 size;
+        };
+
+        struct IndexedDir
+        {
+            u32 parent;
+            Name name;
+            i64 last_write_time;
+            u32 first_entry;
+            u32 num_entries;
+        };
+
+        struct IndexedEntry
+        {
+            Guid guid;
+            Name name;
+            Name type;
+            i64 last_write_time;
+            u64 size;
+            //! The index of the directory that contains this entry.
+            u32 dir;
+        };
+
+        struct AssetMetaIndexBuilder
+        {
+            // The index loaded from the index file.
+            Vector<IndexedDir> m_old_dirs;
+            Vector<IndexedEntry> m_old_entries;
+            Vector<Vector<u32>> m_old_children;
+
+            // The index of the current directory tree.
+            Vector<IndexedDir> m_dirs;
+            Vector<Path> m_dir_paths;
+            Vector<IndexedEntry> m_entries;
+            //! Indices of entries in `m_entries` whose metadata files should be parsed.
+            Vector<u32> m_dirty_entries;
+            //! `true` if the index file should be rebuilt.
+            bool m_changed = false;
+        };
+
+        static bool parse_meta_index(const void* data, u64 size, AssetMetaIndexBuilder& builder)
+        {
+            if (size < sizeof(AssetMetaIndexHeader)) return false;
+            const AssetMetaIndexHeader* header = (const AssetMetaIndexHeader*)data;
+            if (header->magic != ASSET_META_INDEX_MAGIC || header->version != ASSET_META_INDEX_VERSION) return false;
+            u64 dirs_offset = sizeof(AssetMetaIndexHeader);
+            u64 entries_offset = dirs_offset + (u64)header->num_dirs * sizeof(AssetMetaIndexDirRecord);
+            u64 strings_offset = entries_offset + (u64)header->num_entries * sizeof(AssetMetaIndexEntryRecord);
+            if (strings_offset + header->string_table_size != size) return false;
+            const AssetMetaIndexDirRecord* dirs = (const AssetMetaIndexDirRecord*)((const u8*)data + dirs_offset);
+            const AssetMetaIndexEntryRecord* entries = (const AssetMetaIndexEntryRecord*)((const u8*)data + entries_offset);
+            const c8* strings = (const c8*)data + strings_offset;
+            auto check_string = [header](u32 offset, u32 size) { return (u64)offset + size <= header->string_table_size; };
+            builder.m_old_dirs.reserve(header->num_dirs);
+            builder.m_old_children.resize(header->num_dirs);
+            for (u32 i = 0; i < header->num_dirs; ++i)
+            {
+                const AssetMetaIndexDirRecord& src = dirs[i];
+                // Parent directories are always stored before their children.
+                bool parent_valid = i == 0 ? src.parent == U32_MAX : src.parent < i;
+                if (!parent_valid || !check_string(src.name_offset, src.name_size) ||
+                    (u64)src.first_entry + src.num_entries > header->num_entries) return false;
+                IndexedDir dir;
+                dir.parent = src.parent;
+                dir.name = Name(strings + src.name_offset, src.name_size);
+                dir.last_write_time = src.last_write_time;
+                dir.first_entry = src.first_entry;
+                dir.num_entries = src.num_entries;
+                builder.m_old_dirs.push_back(move(dir));
+                if (i) builder.m_old_children[src.parent].push_back(i);
+            }
+            builder.m_old_entries.reserve(header->num_entries);
+            for (u32 i = 0; i < header->num_entries; ++i)
+            {
+                const AssetMetaIndexEntryRecord& src = entries[i];
+                if (!check_string(src.name_offset, src.name_size) || !check_string(src.type_offset, src.type_size)) return false;
+                IndexedEntry entry;
+                entry.guid = Guid(src.guid_high, src.guid_low);
+                entry.name = Name(strings + src.name_offset, src.name_size);
+                entry.type = Name(strings + src.type_offset, src.type_size);
+                entry.last_write_time = src.last_write_time;
+                entry.size = src.size;
+                entry.dir = U32_MAX;
+                builder.m_old_entries.push_back(move(entry));
+            }
+            return true;
+        }
+
+        static void load_meta_index(const Path& index_path, AssetMetaIndexBuilder& builder)
+        {
+            // Maps the index file directly if the file is stored in the platform file system, so that only pages
+            // that are accessed are read.
+            Ref<IMappedFile> mapped_file;
+            Blob file_data;
+            const void* data = nullptr;
+            u64 size = 0;
+            auto native_path = VFS::get_native_path(index_path);
+            if (succeeded(native_path))
+            {
+                auto r = map_file(native_path.get().c_str());
+                if (succeeded(r))
+                {
+                    mapped_file = r.get();
+                    data = mapped_file->get_data();
+                    size = mapped_file->get_size();
+                }
+            }
+            if (!mapped_file)
+            {
+                auto f = VFS::open_file(index_path, FileOpenFlag::read, FileCreationMode::open_existing);
+                if (failed(f)) return;
+                auto r = load_file_data(f.get());
+                if (failed(r)) return;
+                file_data = move(r.get());
+                data = file_data.data();
+                size = file_data.size();
+            }
+            if (!parse_meta_index(data, size, builder))
+            {
+                builder.m_old_dirs.clear();
+                builder.m_old_entries.clear();
+                builder.m_old_children.clear();
+            }
+        }
+
+        static void add_meta_index_entry(AssetMetaIndexBuilder& builder, u32 dir, const Name& name, const IndexedEntry* old_entry)
+        {
+            Path meta_path = builder.m_dir_paths[dir];
+            meta_path.push_back(name);
+            meta_path.append_extension("meta");
+            auto attr = VFS::get_file_attribute(meta_path);
+            if (failed(attr))
+            {
+                // The metadata file is removed.
+                builder.m_changed = true;
+                return;
+            }
+            IndexedEntry entry;
+            entry.name = name;
+            entry.last_write_time = attr.get().last_write_time;
+            entry.size = attr.get().size;
+            entry.dir = dir;
+            // The file size is also checked, since the last write time may not change if the file is
+            // rewritten in the same second.
+            if (old_entry && old_entry->last_write_time == entry.last_write_time && old_entry->size == entry.size)
+            {
+                entry.guid = old_entry->guid;
+                entry.type = old_entry->type;
+            }
+            else
+            {
+                builder.m_changed = true;
+                builder.m_dirty_entries.push_back((u32)builder.m_entries.size());
+            }
+            builder.m_entries.push_back(move(entry));
+        }
+
+        static RV scan_meta_index_dir(AssetMetaIndexBuilder& builder, const Path& path, u32 parent, const Name& name,
+            i64 last_write_time, u32 old_dir)
+        {
+            u32 dir_index = (u32)builder.m_dirs.size();
+            IndexedDir dir;
+            dir.parent = parent;
+            dir.name = name;
+            dir.last_write_time = last_write_time;
+            dir.first_entry = (u32)builder.m_entries.size();
+            dir.num_entries = 0;
+            builder.m_dirs.push_back(move(dir));
+            builder.m_dir_paths.push_back(path);
+            // Pairs of subdirectory names and their indices in the old index.
+            Vector<Pair<Name, u32>> subdirs;
+            lutry
+            {
+                if (old_dir != U32_MAX && builder.m_old_dirs[old_dir].last_write_time == last_write_time)
+                {
+                    // No file is added, removed or renamed in this directory, so only checks whether metadata
+                    // files are modified.
+                    const IndexedDir& src = builder.m_old_dirs[old_dir];
+                    for (u32 i = src.first_entry; i < src.first_entry + src.num_entries; ++i)
+                    {
+                        add_meta_index_entry(builder, dir_index, builder.m_old_entries[i].name, &builder.m_old_entries[i]);
+                    }
+                    for (u32 child : builder.m_old_children[old_dir])
+                    {
+                        subdirs.push_back(make_pair(builder.m_old_dirs[child].name, child));
+                    }
+                }
+                else
+                {
+                    builder.m_changed = true;
+                    HashMap<Name, u32> old_entries;
+                    HashMap<Name, u32> old_children;
+                    if (old_dir != U32_MAX)
+                    {
+                        const IndexedDir& src = builder.m_old_dirs[old_dir];
+                        for (u32 i = src.first_entry; i < src.first_entry + src.num_entries; ++i)
+                        {
+                            old_entries.insert(make_pair(builder.m_old_entries[i].name, i));
+                        }
+                        for (u32 child : builder.m_old_children[old_dir])
+                        {
+                            old_children.insert(make_pair(builder.m_old_dirs[child].name, child));
+                        }
+                    }
+                    lulet(iter, VFS::open_dir(path));
+                    for (; iter->is_valid(); iter->move_next())
+                    {
+                        const c8* filename = iter->get_filename();
+                        if (!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
+                        if (test_flags(iter->get_attributes(), FileAttributeFlag::directory))
+                        {
+                            Name child_name = filename;
+                            auto child = old_children.find(child_name);
+                            subdirs.push_back(make_pair(child_name, child == old_children.end() ? U32_MAX : child->second));
+                            continue;
+                        }
+                        usize len = strlen(filename);
+                        if (len <= 5 || strcmp(filename + len - 5, ".meta")) continue;
+                        Name asset_name(filename, len - 5);
+                        auto entry = old_entries.find(asset_name);
+                        add_meta_index_entry(builder, dir_index, asset_name, entry == old_entries.end() ? nullptr : &builder.m_old_entries[entry->second]);
+                    }
+                }
+                builder.m_dirs[dir_index].num_entries = (u32)builder.m_entries.size() - builder.m_dirs[dir_index].first_entry;
+                for (auto& subdir : subdirs)
+                {
+                    Path subdir_path = path;
+                    subdir_path.push_back(subdir.first);
+                    auto attr = VFS::get_file_attribute(subdir_path);
+                    if (failed(attr) || !test_flags(attr.get().attributes, FileAttributeFlag::directory))
+                    {
+                        builder.m_changed = true;
+                        continue;
+                    }
+                    luexp(scan_meta_index_dir(builder, subdir_path, dir_index, subdir.first, attr.get().last_write_time, subdir.second));
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+
+        static RV save_meta_index(const Path& index_path, const AssetMetaIndexBuilder& builder)
+        {
+            Vector<c8> strings;
+            auto add_string = [&strings](const Name& name, u32& offset, u32& size)
+            {
+                offset = (u32)strings.size();
+                size = (u32)name.size();
+                strings.insert(strings.end(), name.c_str(), name.c_str() + name.size());
+            };
+            Vector<AssetMetaIndexDirRecord> dirs;
+            dirs.reserve(builder.m_dirs.size());
+            for (auto& src : builder.m_dirs)
+            {
+                AssetMetaIndexDirRecord dir;
+                dir.parent = src.parent;
+                add_string(src.name, dir.name_offset, dir.name_size);
+                dir.first_entry = src.first_entry;
+                dir.num_entries = src.num_entries;
+                dir.reserved = 0;
+                dir.last_write_time = src.last_write_time;
+                dirs.push_back(dir);
+            }
+            Vector<AssetMetaIndexEntryRecord> entries;
+            entries.reserve(builder.m_entries.size());
+            for (auto& src : builder.m_entries)
+            {
+                AssetMetaIndexEntryRecord entry;
+                entry.guid_high = src.guid.high;
+                entry.guid_low = src.guid.low;
+                add_string(src.name, entry.name_offset, entry.name_size);
+                add_string(src.type, entry.type_offset, entry.type_size);
+                entry.last_write_time = src.last_write_time;
+                entry.size = src.size;
+                entries.push_back(entry);
+            }
+            AssetMetaIndexHeader header;
+            header.magic = ASSET_META_INDEX_MAGIC;
+            header.version = ASSET_META_INDEX_VERSION;
+            header.num_dirs = (u32)dirs.size();
+            header.num_entries = (u32)entries.size();
+            header.string_table_size = strings.size();
+            lutry
+            {
+                // If writing fails halfway, the file size does not match the header, and the index will be
+                // rebuilt the next time.
+                lulet(f, VFS::open_file(index_path, FileOpenFlag::write | FileOpenFlag::user_buffering, FileCreationMode::create_always));
+                luexp(f->write(&header, sizeof(header)));
+                luexp(f->write(dirs.data(), dirs.size() * sizeof(AssetMetaIndexDirRecord)));
+                luexp(f->write(entries.data(), entries.size() * sizeof(AssetMetaIndexEntryRecord)));
+                luexp(f->write(strings.data(), strings.size()));
+            }
+            lucatchret;
+            return ok;
+        }
+
+        RV collect_assets_meta(const Path& directory, Vector<AssetMetaUpdateInfo>& assets)
+        {
+            lutry
+            {
+                lulet(attr, VFS::get_file_attribute(directory));
+                Path index_path = directory;
+                index_path.push_back(ASSET_META_INDEX_FILENAME);
+                AssetMetaIndexBuilder builder;
+                load_meta_index(index_path, builder);
+                if (builder.m_old_dirs.empty())
+                {
+                    builder.m_changed = true;
+                }
+                luexp(scan_meta_index_dir(builder, directory, U32_MAX, Name(), attr.last_write_time, builder.m_old_dirs.empty() ? U32_MAX : 0));
+                // Parses new and modified metadata files in parallel.
+                usize num_dirty_entries = builder.m_dirty_entries.size();
+                Vector<Error> errors(num_dirty_entries);
+                JobSystem::parallel_for(0, num_dirty_entries, 0, [&builder, &errors](usize i)
+                {
+                    IndexedEntry& entry = builder.m_entries[builder.m_dirty_entries[i]];
+                    Path meta_path = builder.m_dir_paths[entry.dir];
+                    meta_path.push_back(entry.name);
+                    meta_path.append_extension("meta");
+                    auto r = internal_load_asset_meta(meta_path);
+                    if (succeeded(r))
+                    {
+                        entry.guid = r.get().guid;
+                        entry.type = r.get().type;
+                    }
+                    else if (r.errcode() == BasicError::error_object())
+                    {
+                        // The error object is stored in the worker thread, so copies it.
+                        errors[i] = get_error();
+                    }
+                    else
+                    {
+                        errors[i] = Error(r.errcode(), "Failed to load asset meta file %s.", meta_path.encode().c_str());
+                    }
+                });
+                for (auto& err : errors)
+                {
+                    if (err.code.code)
+                    {
+                        get_error() = move(err);
+                        return BasicError::error_object();
+                    }
+                }
+                assets.reserve(assets.size() + builder.m_entries.size());
+                for (auto& entry : builder.m_entries)
+                {
+                    AssetMetaUpdateInfo info;
+                    info.path = builder.m_dir_paths[entry.dir];
+                    info.path.push_back(entry.name);
+                    info.meta_file.guid = entry.guid;
+                    info.meta_file.type = entry.type;
+                    assets.push_back(move(info));
+                }
+                if (builder.m_changed)
+                {
+                    // The index file is only a cache, so failing to save it does not fail the load.
+                    save_meta_index(index_path, builder);
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
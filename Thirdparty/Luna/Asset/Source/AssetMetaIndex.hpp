@@ -0,0 +1,25 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetMetaIndex.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Asset.hpp"
+
+namespace Luna
+{
+    namespace Asset
+    {
+        //! The name of the metadata index file placed in the root directory passed to `load_assets_meta`.
+        constexpr const c8* ASSET_META_INDEX_FILENAME = ".meta_index";
+
+        //! Collects metadata of all assets in the directory recursively.
+        //! @details Metadata loaded from the index file of the directory is reused if the metadata file is not changed,
+        //! and only new or changed metadata files are parsed. The index file is rebuilt if any metadata file is changed.
+        RV collect_assets_meta(const Path& directory, Vector<AssetMetaUpdateInfo>& assets);
+    }
+}
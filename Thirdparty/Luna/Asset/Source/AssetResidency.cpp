@@ -0,0 +1,231 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetResidency.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_ASSET_API LUNA_EXPORT
+#include "AssetResidency.hpp"
+#include "AssetType.hpp"
+#include <Luna/Runtime/HashMap.hpp>
+
+namespace Luna
+{
+    namespace Asset
+    {
+        SpinLock g_residency_lock;
+        AssetEntry* g_lru_head = nullptr;
+        AssetEntry* g_lru_tail = nullptr;
+        AssetResidencyStatistics g_residency_stats;
+        HashMap<Name, AssetResidencyStatistics> g_type_residency_stats;
+
+        inline void reset_residency_statistics(AssetResidencyStatistics& stats)
+        {
+            stats.budget = U64_MAX;
+            stats.resident_size = 0;
+            stats.num_resident_assets = 0;
+            stats.num_evictions = 0;
+            stats.evicted_size = 0;
+            stats.num_referenced_skips = 0;
+        }
+        static AssetResidencyStatistics& get_type_residency_stats(const Name& type)
+        {
+            auto iter = g_type_residency_stats.find(type);
+            if (iter == g_type_residency_stats.end())
+            {
+                AssetResidencyStatistics stats;
+                reset_residency_statistics(stats);
+                iter = g_type_residency_stats.insert(make_pair(type, stats)).first;
+            }
+            return iter->second;
+        }
+        inline void lru_remove(AssetEntry* entry)
+        {
+            if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+            else g_lru_head = entry->lru_next;
+            if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+            else g_lru_tail = entry->lru_prev;
+            entry->lru_prev = nullptr;
+            entry->lru_next = nullptr;
+        }
+        inline void lru_push_front(AssetEntry* entry)
+        {
+            entry->lru_prev = nullptr;
+            entry->lru_next = g_lru_head;
+            if (g_lru_head) g_lru_head->lru_prev = entry;
+            else g_lru_tail = entry;
+            g_lru_head = entry;
+        }
+        void init_asset_residency()
+        {
+            reset_residency_statistics(g_residency_stats);
+        }
+        void close_asset_residency()
+        {
+            LockGuard guard(g_residency_lock);
+            g_lru_head = nullptr;
+            g_lru_tail = nullptr;
+            reset_residency_statistics(g_residency_stats);
+            g_type_residency_stats.clear();
+            g_type_residency_stats.shrink_to_fit();
+        }
+        void update_asset_residency(AssetEntry* entry)
+        {
+            u64 size = 0;
+            if (entry->data)
+            {
+                auto desc = get_asset_type_desc(entry->type);
+                if (succeeded(desc) && desc.get().on_get_asset_data_size)
+                {
+                    size = desc.get().on_get_asset_data_size(desc.get().userdata.get(), asset_t(entry), entry->data.get());
+                }
+            }
+            LockGuard guard(g_residency_lock);
+            if (entry->resident)
+            {
+                AssetResidencyStatistics& type_stats = get_type_residency_stats(entry->resident_type);
+                g_residency_stats.resident_size -= entry->resident_size;
+                --g_residency_stats.num_resident_assets;
+                type_stats.resident_size -= entry->resident_size;
+                --type_stats.num_resident_assets;
+                lru_remove(entry);
+                entry->resident = false;
+                entry->resident_size = 0;
+                entry->resident_type.reset();
+            }
+            if (entry->data)
+            {
+                AssetResidencyStatistics& type_stats = get_type_residency_stats(entry->type);
+                g_residency_stats.resident_size += size;
+                ++g_residency_stats.num_resident_assets;
+                type_stats.resident_size += size;
+                ++type_stats.num_resident_assets;
+                lru_push_front(entry);
+                entry->resident = true;
+                entry->resident_size = size;
+                entry->resident_type = entry->type;
+            }
+        }
+        void touch_asset_residency(AssetEntry* entry)
+        {
+            LockGuard guard(g_residency_lock);
+            if (entry->resident && g_lru_head != entry)
+            {
+                lru_remove(entry);
+                lru_push_front(entry);
+            }
+        }
+        //! Finds the least recently used asset that should be evicted. The residency lock must be held.
+        static AssetEntry* find_eviction_candidate(AssetEntry* keep)
+        {
+            bool over_budget = g_residency_stats.resident_size > g_residency_stats.budget;
+            for (AssetEntry* entry = g_lru_tail; entry; entry = entry->lru_prev)
+            {
+                if (entry == keep || !entry->resident_size) continue;
+                if (over_budget) return entry;
+                auto iter = g_type_residency_stats.find(entry->resident_type);
+                if (iter != g_type_residency_stats.end() && iter->second.resident_size > iter->second.budget) return entry;
+            }
+            return nullptr;
+        }
+        //! Evicts the data object of the asset if it is not referenced outside of the asset system.
+        static void try_evict_asset(AssetEntry* entry)
+        {
+            LockGuard guard(entry->lock);
+            // The asset may be changed after being selected.
+            if (!entry->data) return;
+            // Assets that are being reloaded are also treated as in use.
+            bool evictable = !entry->loading && object_ref_count(entry->data.get()) == 1;
+            if (evictable)
+            {
+                auto desc = get_asset_type_desc(entry->type);
+                if (succeeded(desc) && desc.get().on_set_asset_data)
+                {
+                    evictable = succeeded(desc.get().on_set_asset_data(desc.get().userdata.get(), asset_t(entry), nullptr));
+                }
+            }
+            if (!evictable)
+            {
+                // The asset is still in use, so moves it to the head of the LRU list to try other assets first.
+                LockGuard residency_guard(g_residency_lock);
+                ++g_residency_stats.num_referenced_skips;
+                ++get_type_residency_stats(entry->resident_type).num_referenced_skips;
+                if (entry->resident)
+                {
+                    lru_remove(entry);
+                    lru_push_front(entry);
+                }
+                return;
+            }
+            u64 size = entry->resident_size;
+            Name type = entry->resident_type;
+            entry->data.reset();
+            update_asset_residency(entry);
+            LockGuard residency_guard(g_residency_lock);
+            AssetResidencyStatistics& type_stats = get_type_residency_stats(type);
+            ++g_residency_stats.num_evictions;
+            g_residency_stats.evicted_size += size;
+            ++type_stats.num_evictions;
+            type_stats.evicted_size += size;
+        }
+        void enforce_asset_budgets(AssetEntry* keep)
+        {
+            LockGuard guard(g_residency_lock);
+            // Every resident asset is checked at most once, so that this terminates if all assets are referenced.
+            u64 num_checks = g_residency_stats.num_resident_assets;
+            while (num_checks)
+            {
+                AssetEntry* entry = find_eviction_candidate(keep);
+                if (!entry) break;
+                guard.unlock();
+                try_evict_asset(entry);
+                guard = g_residency_lock;
+                --num_checks;
+            }
+        }
+        LUNA_ASSET_API void set_asset_memory_budget(u64 budget)
+        {
+            {
+                LockGuard guard(g_residency_lock);
+                g_residency_stats.budget = budget;
+            }
+            enforce_asset_budgets();
+        }
+        LUNA_ASSET_API void set_asset_type_memory_budget(const Name& type, u64 budget)
+        {
+            {
+                LockGuard guard(g_residency_lock);
+                get_type_residency_stats(type).budget = budget;
+            }
+            enforce_asset_budgets();
+        }
+        LUNA_ASSET_API AssetResidencyStatistics get_asset_residency_statistics()
+        {
+            LockGuard guard(g_residency_lock);
+            return g_residency_stats;
+        }
+        LUNA_ASSET_API AssetResidencyStatistics get_asset_type_residency_statistics(const Name& type)
+        {
+            LockGuard guard(g_residency_lock);
+            auto iter = g_type_residency_stats.find(type);
+            if (iter != g_type_residency_stats.end()) return iter->second;
+            AssetResidencyStatistics ret;
+            reset_residency_statistics(ret);
+            return ret;
+        }
+        LUNA_ASSET_API void update_asset_data_size(asset_t asset)
+        {
+            lucheck_msg(asset.handle, "Asset handle must not be null!");
+            AssetEntry* entry = (AssetEntry*)asset.handle;
+            {
+                LockGuard guard(entry->lock);
+                update_asset_residency(entry);
+            }
+            enforce_asset_budgets(entry);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AssetResidency.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Asset.hpp"
+
+namespace Luna
+{
+    namespace Asset
+    {
+        // Resident assets are tracked by one LRU list, the most recently used asset is at the head of the list.
+        // The residency lock is always acquired after the asset entry lock, so these functions can be called with
+        // the entry lock held, except `enforce_asset_budgets`, which locks entries being evicted.
+
+        //! Updates the residency state of the asset after its data object is changed. The entry lock must be held.
+        void update_asset_residency(AssetEntry* entry);
+
+        //! Moves the asset to the head of the LRU list if its data object is resident. The entry lock must be held.
+        void touch_asset_residency(AssetEntry* entry);
+
+        //! Evicts least recently used assets until all budgets are satisfied. The entry lock must not be held.
+        //! @param[in] keep The asset that should not be evicted, usually the asset that is just loaded.
+        void enforce_asset_budgets(AssetEntry* keep = nullptr);
+
+        void init_asset_residency();
+        void close_asset_residency();
+    }
+}
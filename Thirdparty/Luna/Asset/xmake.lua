@@ -2,5 +2,5 @@ luna_sdk_module_target("Asset")
     add_headerfiles("*.hpp", {prefixdir = "Luna/Asset"})
     add_headerfiles("Source/**.hpp", {install = false})
     add_files("Source/**.cpp")
-    add_deps("Runtime", "VariantUtils", "VFS")
+    add_deps("Runtime", "VariantUtils", "VFS", "JobSystem")
 target_end()
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file JobGraph.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "JobSystem.hpp"
+#include <Luna/Runtime/Interface.hpp>
+#include <Luna/Runtime/Ref.hpp>
+#include <Luna/Runtime/Result.hpp>
+
+namespace Luna
+{
+    namespace JobSystem
+    {
+        //! @addtogroup JobSystem
+        //! @{
+
+        //! @interface IJobGraph
+        //! Represents one directed acyclic graph of jobs that can be executed multiple times.
+        //! @details The user declares jobs (nodes) and dependencies (edges) up front. When the graph is executed,
+        //! jobs without predecessors are submitted at once, and every other job is submitted by the job system
+        //! as soon as its last predecessor finishes, so no thread needs to wait for predecessors.
+        //!
+        //! The graph prepares all scheduling data when it is executed for the first time after being modified,
+        //! and does not allocate memory for graph data when being executed again, so the same graph can be executed
+        //! every frame with low overhead.
+        struct IJobGraph : virtual Interface
+        {
+            luiid("{0f1a3a0e-2b8c-4d3e-9b5e-6b4c2f7d1e83}");
+
+            //! Adds one job node to the graph.
+            //! @param[in] func The callback function of the job.
+            //! @param[in] params The parameter passed to `func` when the job is executed. The graph does not
+            //! copy nor manage the parameter, so the parameter must be valid when the graph is executed.
+            //! @param[in] priority The priority of the job.
+            //! @param[in] main_thread If `true`, the job is submitted by @ref submit_main_thread_job and is only executed by 
+            //! the main thread. `priority` is ignored in such case.
+            //! @return Returns the index of the added node.
+            virtual usize add_node(job_func_t* func, void* params, JobPriority priority = JobPriority::normal, bool main_thread = false) = 0;
+
+            //! Adds one dependency between two nodes.
+            //! @param[in] predecessor The index of the node that should be finished before `successor` starts.
+            //! @param[in] successor The index of the node that should be started after `predecessor` is finished.
+            virtual void add_edge(usize predecessor, usize successor) = 0;
+
+            //! Gets the number of nodes in the graph.
+            virtual usize get_num_nodes() = 0;
+
+            //! Removes all nodes and edges from the graph.
+            //! @par Valid Usage
+            //! * This must not be called when the graph is being executed.
+            virtual void clear() = 0;
+
+            //! Executes the graph.
+            //! @return Returns one job ID that will be finished when all jobs in the graph are finished. Use
+            //! @ref wait_job to wait for the graph to finish.
+            //! Returns @ref BasicError::bad_arguments if the graph contains cycles.
+            //! @par Valid Usage
+            //! * The graph must not be executed again before the former execution is finished.
+            virtual R<job_id_t> execute() = 0;
+        };
+
+        //! Creates one new job graph.
+        //! @return Returns the created job graph.
+        LUNA_JOBSYSTEM_API Ref<IJobGraph> new_job_graph();
+
+        //! @}
+    }
+}
@@ -9,6 +9,9 @@
 */
 #pragma once
 #include <Luna/Runtime/Base.hpp>
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/Runtime/Vector.hpp>
+#include <Luna/Runtime/Span.hpp>
 #ifndef LUNA_JOBSYSTEM_API
 #define LUNA_JOBSYSTEM_API
 #endif
@@ -31,6 +34,19 @@ namespace Luna
         //! @param[in] params The parameter passed to @ref submit_job.
         using job_func_t = void(void* params);
 
+        //! Specifies the priority of one job.
+        //! @details Every thread has one job queue for every priority level. Jobs of higher priority levels are always
+        //! consumed before jobs of lower priority levels, including jobs stolen from other threads.
+        enum class JobPriority : u8
+        {
+            //! Frame-critical jobs that should be finished as soon as possible.
+            high = 0,
+            //! The default priority for jobs.
+            normal = 1,
+            //! Long-running jobs that are not time-critical, like asset decoding.
+            background = 2,
+        };
+
         //! Allocates one job ID, so that other threads can wait for it by calling @ref wait_job.
         //! @return Returns the allocated job ID.
         //! @remark This function is called internally by the job system for all jobs submitted by @ref submit_job, so the user doesn't need to call this function manually.
@@ -44,6 +60,9 @@ namespace Luna
         //! Marks one job ID as finished, so that all jobs waiting for this job ID will be resumed.
         //! This function should only be called for job IDs allocated by @ref allocate_job_id, never call this function for job IDs returned by @ref submit_job.
         //! See remarks of @ref allocate_job_id for details.
+        //! 
+        //! Every job ID can only be finished once. Finishing one job ID that is not allocated or is already finished 
+        //! reports an assertion failure even if assertions are disabled.
         LUNA_JOBSYSTEM_API void finish_job_id(job_id_t job);
 
         //! Creates a new job.
@@ -60,9 +79,41 @@ namespace Luna
         //! @param[in] params The parameter block pointer of the job. Every job can only be submitted once.
         //! If the parameter block is not trivially destructable, the user must destruct the parameter block manually at the end of the
         //! job callback function.
+        //! @param[in] priority The priority of the job.
         //! @return Returns the job ID for the submitted job, which can be used to wait for the job using @ref wait_job, or check whether
         //! the job is finished using @ref is_job_finished.
-        LUNA_JOBSYSTEM_API job_id_t submit_job(void* params);
+        LUNA_JOBSYSTEM_API job_id_t submit_job(void* params, JobPriority priority = JobPriority::normal);
+
+        //! Submits the job to the job system after the specified job ID is finished.
+        //! @details The job is recorded in the job state of `dependency`, and is pushed to job queues by the thread that finishes
+        //! `dependency`, so no thread needs to wait for `dependency`.
+        //! @param[in] params The parameter block pointer of the job. See @ref submit_job for details.
+        //! @param[in] dependency The job ID to wait. If this is @ref INVALID_JOB_ID or is already finished, the job is submitted immediately.
+        //! @param[in] priority The priority of the job.
+        //! @return Returns the job ID for the submitted job.
+        LUNA_JOBSYSTEM_API job_id_t submit_job_after(void* params, job_id_t dependency, JobPriority priority = JobPriority::normal);
+
+        //! Submits multiple jobs to the job system.
+        //! @details This behaves the same as calling @ref submit_job for every job, but wakes up sleeping worker 
+        //! threads once for all jobs, which is more efficient when submitting many jobs at once.
+        //! @param[in] params The parameter block pointers of jobs to submit.
+        //! @param[out] out_job_ids If not empty, receives the job ID of every submitted job. The size of this span must 
+        //! be equal to the size of `params`.
+        //! @param[in] priority The priority of all jobs.
+        LUNA_JOBSYSTEM_API void submit_jobs(Span<void* const> params, Span<job_id_t> out_job_ids = {}, JobPriority priority = JobPriority::normal);
+
+        //! Submits the job to the job system, and the job will only be executed by the main thread.
+        //! @details This can be used for jobs that must run on the main thread, like window and swap chain operations.
+        //! Main-thread jobs are executed in submission order before other jobs when the main thread calls @ref wait_job
+        //! or @ref run_main_thread_jobs.
+        //! @param[in] params The parameter block pointer of the job. See @ref submit_job for details.
+        //! @return Returns the job ID for the submitted job.
+        LUNA_JOBSYSTEM_API job_id_t submit_main_thread_job(void* params);
+
+        //! Executes all main-thread jobs submitted by @ref submit_main_thread_job.
+        //! @par Valid Usage
+        //! * This function can only be called by the main thread.
+        LUNA_JOBSYSTEM_API void run_main_thread_jobs();
 
         //! Fetches the job ID assigned with the specified job.
         //! @param[in] params The parameter block pointer of the job.
@@ -79,6 +130,176 @@ namespace Luna
         //! @return Returns `true` if the job is finished, `false` otherwise.
         LUNA_JOBSYSTEM_API bool is_job_finished(job_id_t job);
 
+        //! Allocates memory for one coroutine frame from the job block pool.
+        //! @details Frames that are not larger than job blocks are allocated from per-thread free lists, so creating 
+        //! coroutine tasks does not call heap allocator in most cases. The returned memory is aligned to @ref MAX_ALIGN.
+        //! 
+        //! This is used by the experimental coroutine tasks declared in `Task.hpp`, which require C++20.
+        //! @param[in] size The size of the frame.
+        //! @return Returns the allocated memory.
+        LUNA_JOBSYSTEM_API void* allocate_task_frame(usize size);
+
+        //! Frees memory allocated by @ref allocate_task_frame.
+        //! @param[in] frame The memory to free.
+        //! @param[in] size The size passed to @ref allocate_task_frame when allocating the memory.
+        LUNA_JOBSYSTEM_API void free_task_frame(void* frame, usize size);
+
+        //! Sets the number of polling rounds one idle worker thread performs before going to sleep.
+        //! @details When no job is available, worker threads poll for new jobs with an exponential backoff before they sleep, 
+        //! so that jobs submitted in bursts can be consumed without waking up threads. Larger values reduce job latency, but 
+        //! consume more CPU time when the system is idle. Setting this to `0` makes worker threads sleep immediately.
+        //! @param[in] spin_count The number of polling rounds. The default value is 32.
+        LUNA_JOBSYSTEM_API void set_worker_spin_count(u32 spin_count);
+
+        //! Gets the number of worker threads created by the job system.
+        //! @return Returns the number of worker threads. The thread that waits for jobs also executes jobs, so
+        //! the maximum number of jobs that can be executed concurrently is usually this value plus one.
+        LUNA_JOBSYSTEM_API u32 get_num_worker_threads();
+
+        namespace Impl
+        {
+            template <typename _Func>
+            struct ParallelChunkJobParams
+            {
+                usize m_first_chunk;
+                usize m_last_chunk;
+                _Func* m_func;
+            };
+
+            template <typename _Func>
+            void parallel_chunk_job(void* params)
+            {
+                using params_t = ParallelChunkJobParams<_Func>;
+                params_t* p = (params_t*)params;
+                usize first = p->m_first_chunk;
+                usize last = p->m_last_chunk;
+                // Splits the chunk range recursively. The right half is submitted as one child job of this job, 
+                // and the left half is processed by this job, so waiting for the root job waits for all chunks.
+                while (last - first > 1)
+                {
+                    usize mid = first + (last - first) / 2;
+                    params_t* child = (params_t*)new_job(parallel_chunk_job<_Func>, sizeof(params_t), alignof(params_t), params);
+                    child->m_first_chunk = mid;
+                    child->m_last_chunk = last;
+                    child->m_func = p->m_func;
+                    submit_job(child);
+                    last = mid;
+                }
+                (*p->m_func)(first);
+            }
+
+            template <typename _Func>
+            void dispatch_chunks(usize num_chunks, _Func& func)
+            {
+                if (num_chunks == 0) return;
+                if (num_chunks == 1)
+                {
+                    func(0);
+                    return;
+                }
+                using params_t = ParallelChunkJobParams<_Func>;
+                params_t* params = (params_t*)new_job(parallel_chunk_job<_Func>, sizeof(params_t), alignof(params_t));
+                params->m_first_chunk = 0;
+                params->m_last_chunk = num_chunks;
+                params->m_func = &func;
+                wait_job(submit_job(params));
+            }
+
+            inline usize get_parallel_grain_size(usize count, usize grain)
+            {
+                if (grain) return grain;
+                // Splits the range to several chunks for every thread, so that threads that finish 
+                // their chunks early can steal remaining chunks from other threads.
+                usize num_threads = get_num_worker_threads() + 1;
+                return max<usize>(count / (num_threads * 4), 1);
+            }
+        }
+
+        //! Calls the function for every index in the range in parallel.
+        //! @param[in] begin The first index of the range.
+        //! @param[in] end The one-past-last index of the range.
+        //! @param[in] grain The maximum number of indices processed by one job. If this is `0`, the grain size 
+        //! is determined by the job system based on the number of worker threads.
+        //! @param[in] func The function to call. The function should have signature `void(usize index)`, and may be called 
+        //! from multiple threads at the same time.
+        //! @remark This function blocks the current thread until all indices are processed. The current thread executes 
+        //! jobs while waiting, so this function can also be called in job callback functions.
+        template <typename _Func>
+        void parallel_for(usize begin, usize end, usize grain, _Func&& func)
+        {
+            if (end <= begin) return;
+            grain = Impl::get_parallel_grain_size(end - begin, grain);
+            usize num_chunks = (end - begin + grain - 1) / grain;
+            auto chunk_func = [begin, end, grain, &func](usize chunk)
+            {
+                usize chunk_begin = begin + chunk * grain;
+                usize chunk_end = min(chunk_begin + grain, end);
+                for (usize i = chunk_begin; i < chunk_end; ++i)
+                {
+                    func(i);
+                }
+            };
+            Impl::dispatch_chunks(num_chunks, chunk_func);
+        }
+
+        //! Maps every index in the range to one value and reduces all values to one value in parallel.
+        //! @param[in] begin The first index of the range.
+        //! @param[in] end The one-past-last index of the range.
+        //! @param[in] grain The maximum number of indices processed by one job. If this is `0`, the grain size 
+        //! is determined by the job system based on the number of worker threads.
+        //! @param[in] identity The identity value of the reduce operation, which is used as the initial value for every job.
+        //! @param[in] map The map function with signature `_Ty(usize index)`. This may be called from multiple threads at the same time.
+        //! @param[in] reduce The reduce function with signature `_Ty(const _Ty& a, const _Ty& b)`. This may be called from multiple threads
+        //! at the same time.
+        //! @return Returns the reduced value. Returns `identity` if the range is empty.
+        //! @remark Values are always reduced in index order, so the result is deterministic even if `reduce` is not commutative.
+        template <typename _Ty, typename _MapFunc, typename _ReduceFunc>
+        _Ty parallel_reduce(usize begin, usize end, usize grain, const _Ty& identity, _MapFunc&& map, _ReduceFunc&& reduce)
+        {
+            if (end <= begin) return identity;
+            grain = Impl::get_parallel_grain_size(end - begin, grain);
+            usize num_chunks = (end - begin + grain - 1) / grain;
+            Vector<_Ty> partials;
+            partials.resize(num_chunks, identity);
+            auto chunk_func = [begin, end, grain, &map, &reduce, &partials](usize chunk)
+            {
+                usize chunk_begin = begin + chunk * grain;
+                usize chunk_end = min(chunk_begin + grain, end);
+                _Ty value = partials[chunk];
+                for (usize i = chunk_begin; i < chunk_end; ++i)
+                {
+                    value = reduce(value, map(i));
+                }
+                partials[chunk] = move(value);
+            };
+            Impl::dispatch_chunks(num_chunks, chunk_func);
+            _Ty result = identity;
+            for (auto& value : partials)
+            {
+                result = reduce(result, value);
+            }
+            return result;
+        }
+
+        //! Statistics of memory allocations for job blocks (job headers and parameter blocks).
+        //! @details All counters are accumulated since the job system is initialized. To get the number of 
+        //! allocations in one period (like one frame), fetch the statistics at the beginning and the end of the 
+        //! period and compute the difference.
+        struct JobAllocationStats
+        {
+            //! The number of jobs created by @ref new_job.
+            u64 num_job_allocations = 0;
+            //! The number of jobs whose blocks are allocated from thread-local free lists directly.
+            u64 num_pool_hits = 0;
+            //! The number of heap allocations performed by the job system for job blocks. This includes 
+            //! allocations of oversized job blocks and allocations of new memory slabs for pools.
+            u64 num_heap_allocations = 0;
+        };
+
+        //! Gets job allocation statistics.
+        //! @return Returns the job allocation statistics accumulated by all threads.
+        LUNA_JOBSYSTEM_API JobAllocationStats get_job_allocation_stats();
+
         //! @}
     }
 
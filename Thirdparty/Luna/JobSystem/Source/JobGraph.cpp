@@ -0,0 +1,175 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file JobGraph.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_JOBSYSTEM_API LUNA_EXPORT
+#include "JobGraph.hpp"
+#include <Luna/Runtime/Atomic.hpp>
+
+namespace Luna
+{
+    namespace JobSystem
+    {
+        struct JobGraphNodeJobParams
+        {
+            JobGraph* m_graph;
+            usize m_node;
+        };
+        usize JobGraph::add_node(job_func_t* func, void* params, JobPriority priority, bool main_thread)
+        {
+            Node node;
+            node.m_func = func;
+            node.m_params = params;
+            node.m_priority = priority;
+            node.m_main_thread = main_thread;
+            node.m_first_successor = 0;
+            node.m_num_successors = 0;
+            node.m_num_predecessors = 0;
+            node.m_num_unfinished_predecessors = 0;
+            m_nodes.push_back(node);
+            m_dirty = true;
+            return m_nodes.size() - 1;
+        }
+        void JobGraph::add_edge(usize predecessor, usize successor)
+        {
+            lucheck(predecessor < m_nodes.size() && successor < m_nodes.size());
+            m_edges.push_back({predecessor, successor});
+            m_dirty = true;
+        }
+        void JobGraph::clear()
+        {
+            m_nodes.clear();
+            m_edges.clear();
+            m_successors.clear();
+            m_root_nodes.clear();
+            m_dirty = true;
+        }
+        RV JobGraph::build()
+        {
+            // Sort successors by predecessors using counting sort, so that successors of every node
+            // are stored continuously.
+            for (auto& node : m_nodes)
+            {
+                node.m_num_successors = 0;
+                node.m_num_predecessors = 0;
+            }
+            for (auto& edge : m_edges)
+            {
+                ++m_nodes[edge.m_predecessor].m_num_successors;
+                ++m_nodes[edge.m_successor].m_num_predecessors;
+            }
+            usize offset = 0;
+            for (auto& node : m_nodes)
+            {
+                node.m_first_successor = offset;
+                offset += node.m_num_successors;
+                node.m_num_successors = 0;
+            }
+            m_successors.resize(m_edges.size());
+            for (auto& edge : m_edges)
+            {
+                Node& node = m_nodes[edge.m_predecessor];
+                m_successors[node.m_first_successor + node.m_num_successors] = edge.m_successor;
+                ++node.m_num_successors;
+            }
+            m_root_nodes.clear();
+            for (usize i = 0; i < m_nodes.size(); ++i)
+            {
+                if (!m_nodes[i].m_num_predecessors) m_root_nodes.push_back(i);
+            }
+            // Check cycles by visiting nodes in topological order.
+            Vector<u32> num_predecessors;
+            num_predecessors.reserve(m_nodes.size());
+            for (auto& node : m_nodes) num_predecessors.push_back(node.m_num_predecessors);
+            Vector<usize> visit_queue = m_root_nodes;
+            usize num_visited = 0;
+            while (num_visited < visit_queue.size())
+            {
+                const Node& node = m_nodes[visit_queue[num_visited]];
+                ++num_visited;
+                for (usize i = 0; i < node.m_num_successors; ++i)
+                {
+                    usize successor = m_successors[node.m_first_successor + i];
+                    if (--num_predecessors[successor] == 0) visit_queue.push_back(successor);
+                }
+            }
+            if (num_visited != m_nodes.size()) return BasicError::bad_arguments();
+            m_dirty = false;
+            return ok;
+        }
+        void JobGraph::submit_node(usize index)
+        {
+            JobGraphNodeJobParams* params = (JobGraphNodeJobParams*)new_job(node_job, sizeof(JobGraphNodeJobParams), alignof(JobGraphNodeJobParams));
+            params->m_graph = this;
+            params->m_node = index;
+            const Node& node = m_nodes[index];
+            if (node.m_main_thread)
+            {
+                submit_main_thread_job(params);
+            }
+            else
+            {
+                submit_job(params, node.m_priority);
+            }
+        }
+        void JobGraph::node_job(void* params)
+        {
+            JobGraphNodeJobParams* p = (JobGraphNodeJobParams*)params;
+            JobGraph* graph = p->m_graph;
+            Node& node = graph->m_nodes[p->m_node];
+            node.m_func(node.m_params);
+            // Submit successors whose predecessors are all finished.
+            for (usize i = 0; i < node.m_num_successors; ++i)
+            {
+                usize successor = graph->m_successors[node.m_first_successor + i];
+                if (atom_dec_u32(&graph->m_nodes[successor].m_num_unfinished_predecessors) == 0)
+                {
+                    graph->submit_node(successor);
+                }
+            }
+            if (atom_dec_usize(&graph->m_num_unfinished_nodes) == 0)
+            {
+                finish_job_id(graph->m_job_id);
+            }
+        }
+        R<job_id_t> JobGraph::execute()
+        {
+            lucheck_msg(m_job_id == INVALID_JOB_ID || is_job_finished(m_job_id), "The job graph cannot be executed before the former execution is finished.");
+            if (m_dirty)
+            {
+                lutry
+                {
+                    luexp(build());
+                }
+                lucatchret;
+            }
+            for (auto& node : m_nodes)
+            {
+                node.m_num_unfinished_predecessors = node.m_num_predecessors;
+            }
+            job_id_t job_id = allocate_job_id();
+            m_job_id = job_id;
+            if (m_nodes.empty())
+            {
+                finish_job_id(job_id);
+                return job_id;
+            }
+            m_num_unfinished_nodes = m_nodes.size();
+            for (usize node : m_root_nodes)
+            {
+                submit_node(node);
+            }
+            return job_id;
+        }
+        LUNA_JOBSYSTEM_API Ref<IJobGraph> new_job_graph()
+        {
+            return new_object<JobGraph>();
+        }
+    }
+}
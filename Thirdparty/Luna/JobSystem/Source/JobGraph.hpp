@@ -0,0 +1,70 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file JobGraph.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "../JobGraph.hpp"
+#include <Luna/Runtime/Vector.hpp>
+#include <Luna/Runtime/TypeInfo.hpp>
+#include <Luna/Runtime/Object.hpp>
+
+namespace Luna
+{
+    namespace JobSystem
+    {
+        struct JobGraph : IJobGraph
+        {
+            lustruct("JobSystem::JobGraph", "{6c2a4f1d-8e3b-4a57-b1c9-2d0e7f5a9b64}");
+            luiimpl();
+
+            struct Node
+            {
+                job_func_t* m_func;
+                void* m_params;
+                JobPriority m_priority;
+                bool m_main_thread;
+                // The range of successors of this node in `m_successors`.
+                usize m_first_successor;
+                usize m_num_successors;
+                // The number of predecessors of this node.
+                u32 m_num_predecessors;
+                // The number of predecessors that are not finished in the current execution.
+                volatile u32 m_num_unfinished_predecessors;
+            };
+            struct Edge
+            {
+                usize m_predecessor;
+                usize m_successor;
+            };
+            Vector<Node> m_nodes;
+            Vector<Edge> m_edges;
+
+            // Built when the graph is executed for the first time after being modified.
+            Vector<usize> m_successors;
+            Vector<usize> m_root_nodes;
+            bool m_dirty = true;
+
+            // Execution context.
+            volatile usize m_num_unfinished_nodes = 0;
+            job_id_t m_job_id = INVALID_JOB_ID;
+
+            RV build();
+            void submit_node(usize index);
+            static void node_job(void* params);
+
+            virtual usize add_node(job_func_t* func, void* params, JobPriority priority, bool main_thread) override;
+            virtual void add_edge(usize predecessor, usize successor) override;
+            virtual usize get_num_nodes() override
+            {
+                return m_nodes.size();
+            }
+            virtual void clear() override;
+            virtual R<job_id_t> execute() override;
+        };
+    }
+}
@@ -15,74 +15,215 @@
 #include <Luna/Runtime/Signal.hpp>
 #include <Luna/Runtime/Random.hpp>
 #include <Luna/Runtime/Module.hpp>
+#include "WorkStealingQueue.hpp"
+#include "JobGraph.hpp"
 
 namespace Luna
 {
     namespace JobSystem
     {
+        inline void cpu_relax()
+        {
+#if defined(LUNA_PLATFORM_X86) || defined(LUNA_PLATFORM_X86_64)
+            _mm_pause();
+#endif
+        }
+
         // Used to record job states even when the job context is destroyed.
-        static SpinLock g_job_state_map_lock;
-        static job_id_t g_next_job_id;
-        static RingDeque<u64> g_job_state_map;
-        static usize g_job_state_map_offset;
-        constexpr usize JOBS_PER_CHUNK = 64;
+        // 
+        // Every job ID is composed by one slot index (low bits) and the generation of the slot (high bits). 
+        // The slot stores the job ID that currently occupies it, and the job is finished if the slot stores 
+        // another ID. When one job ID is finished, its slot is cleared and returned to one free list, and the next 
+        // job ID allocated from the slot will have a new generation. So checking and finishing one job ID never 
+        // takes one global lock.
+        constexpr u32 JOB_SLOT_INDEX_BITS = 22;
+        constexpr u64 JOB_SLOT_INDEX_MASK = (1ULL << JOB_SLOT_INDEX_BITS) - 1;
+        constexpr u32 JOB_SLOTS_PER_CHUNK_BITS = 12;
+        constexpr u32 JOB_SLOTS_PER_CHUNK = 1 << JOB_SLOTS_PER_CHUNK_BITS;
+        constexpr u32 MAX_JOB_SLOT_CHUNKS = (u32)((JOB_SLOT_INDEX_MASK + 1) >> JOB_SLOTS_PER_CHUNK_BITS);
+        // Free slots are pushed to different shards to reduce contention between threads.
+        constexpr u32 NUM_JOB_SLOT_FREE_LIST_SHARDS = 16;
+        // Set on the ID stored in the slot when one thread is adding continuation jobs to the slot. 
+        // The job ID cannot be finished until this bit is cleared.
+        constexpr u64 JOB_SLOT_LOCK_BIT = 1ULL << 63;
+
+        struct JobHeader;
+        static void submit_job_continuations(JobHeader* jobs);
+
+        struct JobSlot
+        {
+            //! The ID of the job that currently occupies this slot, or `INVALID_JOB_ID` if this slot is free.
+            volatile job_id_t m_id;
+            //! The list of jobs that should be submitted when the job ID is finished.
+            JobHeader* m_continuations;
+            //! The generation of the ID that is allocated from this slot.
+            u64 m_generation;
+            //! The next free slot index plus one, or `0` if this is the last free slot.
+            volatile u32 m_next_free;
+        };
+        struct alignas(64) JobSlotFreeList
+        {
+            //! The higher 32 bits store the modification tag to prevent ABA problem, the lower
+            //! 32 bits store the first free slot index plus one.
+            volatile u64 m_head;
+        };
+
+        static JobSlot* volatile g_job_slot_chunks[MAX_JOB_SLOT_CHUNKS];
+        static volatile u32 g_num_job_slots;
+        static JobSlotFreeList g_job_slot_free_lists[NUM_JOB_SLOT_FREE_LIST_SHARDS];
+
         inline void init_job_state_map()
         {
-            g_next_job_id = 0;
-            g_job_state_map_offset = 0;
+            memzero((void*)g_job_slot_chunks, sizeof(g_job_slot_chunks));
+            g_num_job_slots = 0;
+            for (auto& list : g_job_slot_free_lists) list.m_head = 0;
         }
         inline void close_job_state_map()
         {
-            g_job_state_map.clear();
-            g_job_state_map.shrink_to_fit();
+            for (u32 i = 0; i < MAX_JOB_SLOT_CHUNKS; ++i)
+            {
+                if (g_job_slot_chunks[i])
+                {
+                    memfree(g_job_slot_chunks[i]);
+                    g_job_slot_chunks[i] = nullptr;
+                }
+            }
+        }
+        inline JobSlotFreeList& get_current_thread_job_slot_free_list()
+        {
+            usize h = (usize)get_current_thread();
+            h ^= h >> 7;
+            return g_job_slot_free_lists[h % NUM_JOB_SLOT_FREE_LIST_SHARDS];
+        }
+        inline JobSlot* get_job_slot(u32 index)
+        {
+            JobSlot* chunk = g_job_slot_chunks[index >> JOB_SLOTS_PER_CHUNK_BITS];
+            luassert(chunk);
+            return chunk + (index & (JOB_SLOTS_PER_CHUNK - 1));
         }
-        inline job_id_t job_state_map_begin()
+        //! Gets the slot of the specified index, or `nullptr` if the slot is not allocated. This can be called with any 
+        //! index, including indices of invalid job IDs.
+        inline JobSlot* find_job_slot(u32 index)
         {
-            return g_job_state_map_offset * JOBS_PER_CHUNK;
+            if (index >= g_num_job_slots) return nullptr;
+            JobSlot* chunk = g_job_slot_chunks[index >> JOB_SLOTS_PER_CHUNK_BITS];
+            if (!chunk) return nullptr;
+            return chunk + (index & (JOB_SLOTS_PER_CHUNK - 1));
+        }
+        static u32 new_job_slot()
+        {
+            u32 index = atom_inc_u32(&g_num_job_slots) - 1;
+            lucheck_msg(index <= JOB_SLOT_INDEX_MASK, "Too many job IDs are allocated but not finished.");
+            u32 chunk_index = index >> JOB_SLOTS_PER_CHUNK_BITS;
+            if (!g_job_slot_chunks[chunk_index])
+            {
+                JobSlot* chunk = (JobSlot*)memalloc(sizeof(JobSlot) * JOB_SLOTS_PER_CHUNK);
+                memzero(chunk, sizeof(JobSlot) * JOB_SLOTS_PER_CHUNK);
+                if (atom_compare_exchange_pointer(&g_job_slot_chunks[chunk_index], chunk, nullptr) != nullptr)
+                {
+                    // Another thread allocates the chunk firstly.
+                    memfree(chunk);
+                }
+            }
+            return index;
+        }
+        static bool pop_free_job_slot(JobSlotFreeList& list, u32& out_index)
+        {
+            u64 head = list.m_head;
+            while (head & U32_MAX)
+            {
+                u32 index = (u32)(head & U32_MAX) - 1;
+                u64 new_head = ((head >> 32) + 1) << 32 | get_job_slot(index)->m_next_free;
+                u64 prev = atom_compare_exchange_u64(&list.m_head, new_head, head);
+                if (prev == head)
+                {
+                    out_index = index;
+                    return true;
+                }
+                head = prev;
+            }
+            return false;
         }
-        inline job_id_t job_state_map_end()
+        static void push_free_job_slot(JobSlotFreeList& list, u32 index)
         {
-            return (g_job_state_map_offset + g_job_state_map.size()) * JOBS_PER_CHUNK;
+            JobSlot* slot = get_job_slot(index);
+            u64 head = list.m_head;
+            while (true)
+            {
+                slot->m_next_free = (u32)(head & U32_MAX);
+                u64 new_head = ((head >> 32) + 1) << 32 | (index + 1);
+                u64 prev = atom_compare_exchange_u64(&list.m_head, new_head, head);
+                if (prev == head) break;
+                head = prev;
+            }
         }
         LUNA_JOBSYSTEM_API job_id_t allocate_job_id()
         {
-            LockGuard guard(g_job_state_map_lock);
-            job_id_t r = g_next_job_id;
-            ++g_next_job_id;
-            if (r >= job_state_map_end())
+            JobSlotFreeList& list = get_current_thread_job_slot_free_list();
+            u32 index;
+            bool found = pop_free_job_slot(list, index);
+            if (!found)
+            {
+                // Take free slots from other shards before allocating new slots.
+                for (u32 i = 0; i < NUM_JOB_SLOT_FREE_LIST_SHARDS && !found; ++i)
+                {
+                    if (&g_job_slot_free_lists[i] == &list) continue;
+                    found = pop_free_job_slot(g_job_slot_free_lists[i], index);
+                }
+            }
+            if (!found)
             {
-                g_job_state_map.push_back(0);
+                index = new_job_slot();
             }
-            return r;
+            JobSlot* slot = get_job_slot(index);
+            // Generation starts from 1, so that the allocated ID is never `INVALID_JOB_ID`.
+            ++slot->m_generation;
+            job_id_t id = (slot->m_generation << JOB_SLOT_INDEX_BITS) | index;
+            atom_exchange_u64(&slot->m_id, id);
+            return id;
         }
         LUNA_JOBSYSTEM_API void finish_job_id(job_id_t id)
         {
-            LockGuard guard(g_job_state_map_lock);
-            luassert(id >= job_state_map_begin() && id < job_state_map_end());
-            usize chunk_index = id / JOBS_PER_CHUNK - g_job_state_map_offset;
-            usize bit_offset = id % JOBS_PER_CHUNK;
-            u64* chunk = &(g_job_state_map[chunk_index]);
-            bit_set(chunk, bit_offset);
-            if (chunk_index == 0)
+            u32 index = (u32)(id & JOB_SLOT_INDEX_MASK);
+            JobSlot* slot = find_job_slot(index);
+            if (!slot)
             {
-                while (*chunk == U64_MAX)
+                lupanic_msg_always("finish_job_id is called with one job ID that is not allocated.");
+                return;
+            }
+            // The compare-exchange is a full memory barrier, so all writes of the job are visible 
+            // to the thread that observes the job is finished.
+            job_id_t prev = atom_compare_exchange_u64(&slot->m_id, INVALID_JOB_ID, id);
+            while (prev != id)
+            {
+                if (prev != (id | JOB_SLOT_LOCK_BIT))
                 {
-                    ++g_job_state_map_offset;
-                    g_job_state_map.pop_front();
-                    if (g_job_state_map.empty()) break;
-                    chunk = &g_job_state_map.front();
+                    lupanic_msg_always("finish_job_id is called with one job ID that is already finished.");
+                    return;
                 }
+                // Another thread is adding continuation jobs to this ID.
+                cpu_relax();
+                prev = atom_compare_exchange_u64(&slot->m_id, INVALID_JOB_ID, id);
+            }
+            JobHeader* continuations = slot->m_continuations;
+            slot->m_continuations = nullptr;
+            push_free_job_slot(get_current_thread_job_slot_free_list(), index);
+            if (continuations)
+            {
+                submit_job_continuations(continuations);
             }
         }
+        //! Adds one job to the continuation list of the specified job ID.
+        //! Returns `false` if the job ID is already finished, in which case the job is not added.
+        static bool add_job_continuation(job_id_t id, JobHeader* job);
         LUNA_JOBSYSTEM_API bool is_job_finished(job_id_t id)
         {
-            LockGuard guard(g_job_state_map_lock);
-            if (id < job_state_map_begin()) return true;
-            if (id >= job_state_map_end()) return false;
-            usize chunk_index = id / JOBS_PER_CHUNK - g_job_state_map_offset;
-            usize bit_offset = id % JOBS_PER_CHUNK;
-            u64* chunk = &(g_job_state_map[chunk_index]);
-            return bit_test(chunk, bit_offset);
+            if (id == INVALID_JOB_ID) return true;
+            JobSlot* slot = find_job_slot((u32)(id & JOB_SLOT_INDEX_MASK));
+            // Slots that are not allocated never store any job ID.
+            if (slot && (slot->m_id & ~JOB_SLOT_LOCK_BIT) == id) return false;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
         }
 
         struct JobHeader
@@ -91,7 +232,13 @@ namespace Luna
             job_func_t* m_func;
             JobHeader* m_parent;
             usize m_alignment;
+            //! The next job in the continuation list if this job is waiting for another job ID.
+            JobHeader* m_next_continuation;
             volatile u32 m_unfinished_jobs;
+            //! The size class of the job block, or `HEAP_JOB_SIZE_CLASS` if the job block is allocated from heap.
+            u32 m_size_class;
+            //! The priority used when submitting this job as a continuation job.
+            JobPriority m_priority;
 
             bool is_completed() const
             {
@@ -112,57 +259,140 @@ namespace Luna
         {
             return (JobHeader*)(((usize)params) - sizeof(JobHeader));
         }
-
-        LUNA_JOBSYSTEM_API void* new_job(job_func_t* func, usize param_size, usize param_alignment, void* parent)
+        static bool add_job_continuation(job_id_t id, JobHeader* job)
         {
-            // Allocate extra padding space for storing job header.
-            param_alignment = max(param_alignment, MAX_ALIGN);
-            usize padding_size = JobHeader::get_padding_size(param_alignment);
-            void* mem = memalloc(param_size + padding_size, param_alignment);
-            void* params = (void*)((usize)mem + padding_size);
-            JobHeader* job = get_job_header(params);
-            new (job) JobHeader();
-            job->m_id = INVALID_JOB_ID;
-            job->m_func = func;
-            job->m_parent = nullptr;
-            job->m_alignment = param_alignment;
-            job->m_unfinished_jobs = 1;
-            if (parent)
+            if (id == INVALID_JOB_ID) return false;
+            JobSlot* slot = find_job_slot((u32)(id & JOB_SLOT_INDEX_MASK));
+            if (!slot) return false;
+            // Lock the slot by setting the lock bit, so that the ID cannot be finished while we are adding the job.
+            while (true)
             {
-                job->m_parent = get_job_header(parent);
-                atom_inc_u32(&(job->m_parent->m_unfinished_jobs));
+                job_id_t cur = slot->m_id;
+                if (cur == (id | JOB_SLOT_LOCK_BIT))
+                {
+                    cpu_relax();
+                    continue;
+                }
+                if (cur != id) return false;
+                if (atom_compare_exchange_u64(&slot->m_id, id | JOB_SLOT_LOCK_BIT, id) == id) break;
             }
-            return params;
+            job->m_next_continuation = slot->m_continuations;
+            slot->m_continuations = job;
+            // Use compare-exchange to unlock the slot, which is a full memory barrier.
+            atom_compare_exchange_u64(&slot->m_id, id, id | JOB_SLOT_LOCK_BIT);
+            return true;
+        }
+
+        // Job blocks (job header and parameters) are allocated from per-thread free lists in size classes
+        // to avoid calling heap allocator for every job. Blocks that are too large or require large alignment
+        // are allocated from heap directly.
+        constexpr u32 NUM_JOB_SIZE_CLASSES = 4;
+        constexpr u32 HEAP_JOB_SIZE_CLASS = U32_MAX;
+        constexpr usize JOB_BLOCK_ALIGNMENT = 64;
+        constexpr usize JOB_SLAB_SIZE = 64 * 1024;
+        // The number of blocks transferred between the thread cache and the global pool at once.
+        constexpr u32 JOB_BLOCK_TRANSFER_BATCH = 32;
+
+        inline constexpr usize get_job_block_size(u32 size_class)
+        {
+            return JOB_BLOCK_ALIGNMENT << size_class;
         }
 
+        struct JobBlock
+        {
+            JobBlock* m_next;
+        };
+
+        struct JobBlockList
+        {
+            JobBlock* m_head = nullptr;
+            u32 m_size = 0;
+
+            void push(JobBlock* block)
+            {
+                block->m_next = m_head;
+                m_head = block;
+                ++m_size;
+            }
+            JobBlock* pop()
+            {
+                JobBlock* block = m_head;
+                if (block)
+                {
+                    m_head = block->m_next;
+                    --m_size;
+                }
+                return block;
+            }
+        };
+
+        constexpr u32 NUM_JOB_PRIORITIES = 3;
+
         struct WorkerThreadContext
         {
-            SpinLock m_lock;
-            RingDeque<JobHeader*> m_jobs;
+            //! One job queue for every priority level.
+            WorkStealingQueue<JobHeader> m_jobs[NUM_JOB_PRIORITIES];
+            //! Free job blocks cached by this thread.
+            JobBlockList m_free_blocks[NUM_JOB_SIZE_CLASSES];
+            //! Job allocation statistics, only modified by the owner thread.
+            volatile u64 m_num_job_allocations = 0;
+            volatile u64 m_num_pool_hits = 0;
+            volatile u64 m_num_heap_allocations = 0;
             Ref<ISignal> m_wake_signal;
-            bool m_thread_dead = false;
+            //! `1` if the owner thread of this context is exited, so that this context can be reused by another thread.
+            volatile u32 m_thread_dead = 0;
+            //! The index of this context in `g_worker_thread_contexts`.
+            u32 m_index = 0;
+            //! `1` if this context is pushed to the idle worker stack and is not popped yet.
+            volatile u32 m_idle = 0;
+            //! The next context index plus one in the idle worker stack.
+            volatile u32 m_next_idle = 0;
         };
 
-        static SpinLock g_worker_thread_contexts_lock;
-        static Vector<WorkerThreadContext*> g_worker_thread_contexts;
+        //! The maximum number of threads that can submit jobs at the same time.
+        constexpr u32 MAX_WORKER_THREAD_CONTEXTS = 1024;
+
+        // The victim list for stealing jobs. Contexts are only appended to this list, contexts of exited threads
+        // are reused by new threads and are released only when the job system is closed, so that thieves can access 
+        // the list without locking.
+        static WorkerThreadContext* volatile* g_worker_thread_contexts;
+        static volatile u32 g_num_worker_thread_contexts;
         static Vector<Ref<IThread>> g_worker_threads;
-        static SpinLock g_sleep_worker_threads_lock;
-        static Vector<WorkerThreadContext*> g_sleep_worker_threads;
+        // The lock-free stack of sleeping worker threads. The higher 32 bits store the modification tag 
+        // to prevent ABA problem, the lower 32 bits store the first context index plus one.
+        static volatile u64 g_idle_worker_threads;
+        // The number of polling rounds before one worker thread sleeps.
+        static volatile u32 g_worker_spin_count;
+        constexpr u32 DEFAULT_WORKER_SPIN_COUNT = 32;
+        // Jobs that can only be executed by the main thread.
+        static SpinLock g_main_thread_jobs_lock;
+        static RingDeque<JobHeader*> g_main_thread_jobs;
         static opaque_t g_worker_thread_tls;
         static bool g_job_system_exiting;
 
+        inline u32 get_num_worker_thread_contexts()
+        {
+            u32 num_contexts = g_num_worker_thread_contexts;
+            return min(num_contexts, MAX_WORKER_THREAD_CONTEXTS);
+        }
         static void worker_thread_tls_dtor(void* params)
         {
-            // Marks this context to be dead, so that it will be removed 
-            // when the queue is clear, or when the system is shut down.
+            // Marks this context to be dead, so that it can be reused by other threads.
+            // Jobs remaining in the queue can still be stolen by other threads.
             WorkerThreadContext* ctx = (WorkerThreadContext*)params;
-            ctx->m_thread_dead = true;
+            atom_exchange_u32(&ctx->m_thread_dead, 1);
         }
         static void worker_thread_run(void* params);
+        static void close_job_block_pools();
         RV job_system_init()
         {
             init_job_state_map();
             g_job_system_exiting = false;
+            g_worker_thread_contexts = (WorkerThreadContext* volatile*)memalloc(sizeof(WorkerThreadContext*) * MAX_WORKER_THREAD_CONTEXTS);
+            memzero((void*)g_worker_thread_contexts, sizeof(WorkerThreadContext*) * MAX_WORKER_THREAD_CONTEXTS);
+            g_num_worker_thread_contexts = 0;
+            g_idle_worker_threads = 0;
+            g_worker_spin_count = DEFAULT_WORKER_SPIN_COUNT;
             g_worker_thread_tls = tls_alloc(worker_thread_tls_dtor);
             // Emit worker threads.
             u32 processor_count = get_processors_count();
@@ -171,34 +401,35 @@ namespace Luna
                 Ref<IThread> worker = new_thread(worker_thread_run, nullptr);
                 g_worker_threads.push_back(worker);
             }
-            // Consume job id 0, so any valid job will never have ID 0.
-            job_id_t dummy = allocate_job_id();
-            finish_job_id(dummy);
             return ok;
         }
         void job_system_close()
         {
             g_job_system_exiting = true;
             // Wake up all sleep threads.
-            for (auto& t : g_sleep_worker_threads)
+            u32 num_worker_contexts = get_num_worker_thread_contexts();
+            for (u32 i = 0; i < num_worker_contexts; ++i)
             {
-                t->m_wake_signal->trigger();
+                WorkerThreadContext* ctx = g_worker_thread_contexts[i];
+                if (ctx && ctx->m_wake_signal) ctx->m_wake_signal->trigger();
             }
             // Wait for all threads to exit.
             g_worker_threads.clear();
             g_worker_threads.shrink_to_fit();
             // Clean up contexts.
             tls_free(g_worker_thread_tls);
-            g_worker_thread_contexts_lock.lock();
-            for (WorkerThreadContext* ctx : g_worker_thread_contexts)
+            u32 num_contexts = get_num_worker_thread_contexts();
+            for (u32 i = 0; i < num_contexts; ++i)
             {
-                memdelete(ctx);
+                if (g_worker_thread_contexts[i]) memdelete(g_worker_thread_contexts[i]);
             }
-            g_worker_thread_contexts.clear();
-            g_worker_thread_contexts.shrink_to_fit();
-            g_worker_thread_contexts_lock.unlock();
-            g_sleep_worker_threads.clear();
-            g_sleep_worker_threads.shrink_to_fit();
+            memfree((void*)g_worker_thread_contexts);
+            g_worker_thread_contexts = nullptr;
+            g_num_worker_thread_contexts = 0;
+            g_idle_worker_threads = 0;
+            g_main_thread_jobs.clear();
+            g_main_thread_jobs.shrink_to_fit();
+            close_job_block_pools();
             close_job_state_map();
         }
         static WorkerThreadContext* get_current_thread_worker_context()
@@ -207,75 +438,202 @@ namespace Luna
             if (!ctx)
             {
                 // For working on user-created threads.
-                ctx = memnew<WorkerThreadContext>();
+                // Try to reuse one context of exited threads firstly.
+                u32 num_contexts = get_num_worker_thread_contexts();
+                for (u32 i = 0; i < num_contexts; ++i)
+                {
+                    WorkerThreadContext* dead_ctx = g_worker_thread_contexts[i];
+                    if (dead_ctx && dead_ctx->m_thread_dead && atom_compare_exchange_u32(&dead_ctx->m_thread_dead, 0, 1) == 1)
+                    {
+                        ctx = dead_ctx;
+                        break;
+                    }
+                }
+                if (!ctx)
+                {
+                    ctx = memnew<WorkerThreadContext>();
+                    u32 index = atom_inc_u32(&g_num_worker_thread_contexts) - 1;
+                    lucheck_msg(index < MAX_WORKER_THREAD_CONTEXTS, "Too many threads are using the job system at the same time.");
+                    ctx->m_index = index;
+                    atom_exchange_pointer(&g_worker_thread_contexts[index], ctx);
+                }
                 tls_set(g_worker_thread_tls, ctx);
-                g_worker_thread_contexts_lock.lock();
-                g_worker_thread_contexts.push_back(ctx);
-                g_worker_thread_contexts_lock.unlock();
             }
             return ctx;
         }
-        inline JobHeader* steal_job(WorkerThreadContext* current_ctx)
+        inline JobHeader* steal_job(WorkerThreadContext* current_ctx, u32 priority)
         {
-            LockGuard guard(g_worker_thread_contexts_lock);
-            if (g_worker_thread_contexts.empty()) return nullptr;
-            u32 rand_index = random_u32() % (u32)g_worker_thread_contexts.size();
-            usize i = 0;
-            while (i < g_worker_thread_contexts.size())
+            u32 num_contexts = get_num_worker_thread_contexts();
+            if (!num_contexts) return nullptr;
+            u32 rand_index = random_u32() % num_contexts;
+            for (u32 i = 0; i < num_contexts; ++i)
             {
-                u32 index = (rand_index + i) % (u32)g_worker_thread_contexts.size();
-                WorkerThreadContext* steal_ctx = g_worker_thread_contexts[index];
-                if (steal_ctx == current_ctx)
-                {
-                    ++i;
-                    continue;
-                }
-                steal_ctx->m_lock.lock();
-                if (steal_ctx->m_thread_dead && steal_ctx->m_jobs.empty())
+                // The slot may be `nullptr` if the context is being registered.
+                WorkerThreadContext* steal_ctx = g_worker_thread_contexts[(rand_index + i) % num_contexts];
+                if (!steal_ctx || steal_ctx == current_ctx) continue;
+                JobHeader* job = steal_ctx->m_jobs[priority].steal();
+                if (job) return job;
+            }
+            return nullptr;
+        }
+        // The global pool that stores free job blocks shared by all threads.
+        struct JobBlockPool
+        {
+            SpinLock m_lock;
+            JobBlockList m_free_blocks;
+        };
+        static JobBlockPool g_job_block_pools[NUM_JOB_SIZE_CLASSES];
+        static SpinLock g_job_slabs_lock;
+        static Vector<void*> g_job_slabs;
+
+        static void close_job_block_pools()
+        {
+            for (auto& pool : g_job_block_pools)
+            {
+                pool.m_free_blocks = JobBlockList();
+            }
+            for (void* slab : g_job_slabs)
+            {
+                memfree(slab, JOB_BLOCK_ALIGNMENT);
+            }
+            g_job_slabs.clear();
+            g_job_slabs.shrink_to_fit();
+        }
+        static void refill_job_blocks(WorkerThreadContext* ctx, u32 size_class)
+        {
+            JobBlockList& list = ctx->m_free_blocks[size_class];
+            JobBlockPool& pool = g_job_block_pools[size_class];
+            pool.m_lock.lock();
+            for (u32 i = 0; i < JOB_BLOCK_TRANSFER_BATCH; ++i)
+            {
+                JobBlock* block = pool.m_free_blocks.pop();
+                if (!block) break;
+                list.push(block);
+            }
+            pool.m_lock.unlock();
+            if (list.m_head) return;
+            // Allocate a new slab.
+            void* slab = memalloc(JOB_SLAB_SIZE, JOB_BLOCK_ALIGNMENT);
+            ++ctx->m_num_heap_allocations;
+            g_job_slabs_lock.lock();
+            g_job_slabs.push_back(slab);
+            g_job_slabs_lock.unlock();
+            usize block_size = get_job_block_size(size_class);
+            for (usize offset = 0; offset + block_size <= JOB_SLAB_SIZE; offset += block_size)
+            {
+                list.push((JobBlock*)((usize)slab + offset));
+            }
+        }
+        inline u32 get_job_size_class(usize size, usize alignment)
+        {
+            if (alignment <= JOB_BLOCK_ALIGNMENT)
+            {
+                for (u32 size_class = 0; size_class < NUM_JOB_SIZE_CLASSES; ++size_class)
                 {
-                    // Remove this context.
-                    steal_ctx->m_lock.unlock();
-                    g_worker_thread_contexts.erase(g_worker_thread_contexts.begin() + index);
-                    memdelete(steal_ctx);
+                    if (size <= get_job_block_size(size_class)) return size_class;
                 }
-                else
+            }
+            return HEAP_JOB_SIZE_CLASS;
+        }
+        static void* allocate_job_block(usize size, usize alignment, u32& out_size_class)
+        {
+            WorkerThreadContext* ctx = get_current_thread_worker_context();
+            ++ctx->m_num_job_allocations;
+            u32 size_class = get_job_size_class(size, alignment);
+            out_size_class = size_class;
+            if (size_class == HEAP_JOB_SIZE_CLASS)
+            {
+                ++ctx->m_num_heap_allocations;
+                return memalloc(size, alignment);
+            }
+            JobBlockList& list = ctx->m_free_blocks[size_class];
+            if (list.m_head)
+            {
+                ++ctx->m_num_pool_hits;
+            }
+            else
+            {
+                refill_job_blocks(ctx, size_class);
+            }
+            return list.pop();
+        }
+        static void free_job_block(void* block, usize alignment, u32 size_class)
+        {
+            if (size_class == HEAP_JOB_SIZE_CLASS)
+            {
+                memfree(block, alignment);
+                return;
+            }
+            WorkerThreadContext* ctx = get_current_thread_worker_context();
+            JobBlockList& list = ctx->m_free_blocks[size_class];
+            list.push((JobBlock*)block);
+            if (list.m_size >= JOB_BLOCK_TRANSFER_BATCH * 2)
+            {
+                // Return blocks to the global pool, so that they can be used by threads that allocate more jobs than they free.
+                JobBlockPool& pool = g_job_block_pools[size_class];
+                pool.m_lock.lock();
+                for (u32 i = 0; i < JOB_BLOCK_TRANSFER_BATCH; ++i)
                 {
-                    JobHeader* job = nullptr;
-                    if (!steal_ctx->m_jobs.empty())
-                    {
-                        job = steal_ctx->m_jobs.front();
-                        steal_ctx->m_jobs.pop_front();
-                    }
-                    steal_ctx->m_lock.unlock();
-                    if (job) return job;
-                    ++i;
+                    pool.m_free_blocks.push(list.pop());
                 }
+                pool.m_lock.unlock();
             }
-            return nullptr;
+        }
+        LUNA_JOBSYSTEM_API void* new_job(job_func_t* func, usize param_size, usize param_alignment, void* parent)
+        {
+            // Allocate extra padding space for storing job header.
+            param_alignment = max(param_alignment, MAX_ALIGN);
+            usize padding_size = JobHeader::get_padding_size(param_alignment);
+            u32 size_class;
+            void* mem = allocate_job_block(param_size + padding_size, param_alignment, size_class);
+            void* params = (void*)((usize)mem + padding_size);
+            JobHeader* job = get_job_header(params);
+            new (job) JobHeader();
+            job->m_id = INVALID_JOB_ID;
+            job->m_func = func;
+            job->m_parent = nullptr;
+            job->m_alignment = param_alignment;
+            job->m_size_class = size_class;
+            job->m_priority = JobPriority::normal;
+            job->m_next_continuation = nullptr;
+            job->m_unfinished_jobs = 1;
+            if (parent)
+            {
+                job->m_parent = get_job_header(parent);
+                atom_inc_u32(&(job->m_parent->m_unfinished_jobs));
+            }
+            return params;
+        }
+
+        static JobHeader* consume_main_thread_job()
+        {
+            LockGuard guard(g_main_thread_jobs_lock);
+            if (g_main_thread_jobs.empty()) return nullptr;
+            JobHeader* job = g_main_thread_jobs.front();
+            g_main_thread_jobs.pop_front();
+            return job;
         }
         static JobHeader* consume_job()
         {
+            if (get_current_thread() == get_main_thread())
+            {
+                JobHeader* job = consume_main_thread_job();
+                if (job) return job;
+            }
             WorkerThreadContext* ctx = get_current_thread_worker_context();
-            ctx->m_lock.lock();
-            if (ctx->m_jobs.empty())
+            // Consume jobs from higher priority levels firstly, and prefer stealing jobs of higher 
+            // priority levels to consuming local jobs of lower priority levels.
+            for (u32 priority = 0; priority < NUM_JOB_PRIORITIES; ++priority)
             {
-                ctx->m_lock.unlock();
-                // Steal jobs from other threads.
-                JobHeader* job = steal_job(ctx);
+                JobHeader* job = ctx->m_jobs[priority].pop();
                 if (!job)
                 {
-                    yield_current_thread();
-                    return nullptr;
+                    // Steal jobs from other threads.
+                    job = steal_job(ctx, priority);
                 }
-                return job;
-            }
-            else
-            {
-                JobHeader* job = ctx->m_jobs.back();
-                ctx->m_jobs.pop_back();
-                ctx->m_lock.unlock();
-                return job;
+                if (job) return job;
             }
+            return nullptr;
         }
         static void finish_job(JobHeader* job)
         {
@@ -290,8 +648,9 @@ namespace Luna
                 usize alignment = job->m_alignment;
                 usize padding_size = JobHeader::get_padding_size(alignment);
                 void* raw_ptr = (void*)((usize)job->get_params() - padding_size);
+                u32 size_class = job->m_size_class;
                 job->~JobHeader();
-                memfree(raw_ptr, alignment);
+                free_job_block(raw_ptr, alignment, size_class);
             }
         }
         static void execute_job(JobHeader* job)
@@ -299,50 +658,188 @@ namespace Luna
             job->m_func(job->get_params());
             finish_job(job);
         }
-        static void worker_thread_sleep()
+        static void push_idle_worker_thread(WorkerThreadContext* ctx)
         {
-            WorkerThreadContext* ctx = get_current_thread_worker_context();
-            if (!ctx->m_wake_signal) ctx->m_wake_signal = new_signal(false);
-            // Add the current thread to sleep list.
-            g_sleep_worker_threads_lock.lock();
-            g_sleep_worker_threads.push_back(ctx);
-            g_sleep_worker_threads_lock.unlock();
+            u64 head = g_idle_worker_threads;
+            while (true)
+            {
+                ctx->m_next_idle = (u32)(head & U32_MAX);
+                u64 new_head = ((head >> 32) + 1) << 32 | (ctx->m_index + 1);
+                u64 prev = atom_compare_exchange_u64(&g_idle_worker_threads, new_head, head);
+                if (prev == head) break;
+                head = prev;
+            }
+        }
+        static WorkerThreadContext* pop_idle_worker_thread()
+        {
+            u64 head = g_idle_worker_threads;
+            while (head & U32_MAX)
+            {
+                WorkerThreadContext* ctx = g_worker_thread_contexts[(head & U32_MAX) - 1];
+                u64 new_head = ((head >> 32) + 1) << 32 | ctx->m_next_idle;
+                u64 prev = atom_compare_exchange_u64(&g_idle_worker_threads, new_head, head);
+                if (prev == head) return ctx;
+                head = prev;
+            }
+            return nullptr;
+        }
+        //! Wakes up at most `count` sleeping worker threads.
+        static void wake_worker_threads(usize count)
+        {
+            for (usize i = 0; i < count; ++i)
+            {
+                WorkerThreadContext* ctx = pop_idle_worker_thread();
+                if (!ctx) break;
+                atom_exchange_u32(&ctx->m_idle, 0);
+                ctx->m_wake_signal->trigger();
+            }
+        }
+        //! Backs off the current worker thread when no job is available. The back off time grows
+        //! exponentially with `round`.
+        static void worker_thread_backoff(u32 round)
+        {
+            if (round < 6)
+            {
+                u32 num_pauses = 1 << (round * 2);
+                for (u32 i = 0; i < num_pauses; ++i) cpu_relax();
+            }
+            else
+            {
+                yield_current_thread();
+            }
+        }
+        static void worker_thread_sleep(WorkerThreadContext* ctx)
+        {
+            // The context may still be in the idle stack if it finds jobs after being pushed 
+            // to the stack last time, do not push it twice.
+            if (atom_exchange_u32(&ctx->m_idle, 1) == 0)
+            {
+                push_idle_worker_thread(ctx);
+            }
+            // Check jobs again, since jobs may be submitted after the last check but before 
+            // this thread is pushed to the idle stack, and the submitter may not see this thread.
+            JobHeader* job = consume_job();
+            if (job)
+            {
+                execute_job(job);
+                return;
+            }
             ctx->m_wake_signal->wait();
         }
         static void worker_thread_run(void* params)
         {
+            WorkerThreadContext* ctx = get_current_thread_worker_context();
+            ctx->m_wake_signal = new_signal(false);
+            u32 idle_rounds = 0;
             while (!g_job_system_exiting)
             {
                 JobHeader* job = consume_job();
                 if (job)
                 {
                     execute_job(job);
+                    idle_rounds = 0;
+                }
+                else if (idle_rounds < g_worker_spin_count)
+                {
+                    // Spin for a while before sleeping, so that bursty jobs do not need to wake up threads.
+                    worker_thread_backoff(idle_rounds);
+                    ++idle_rounds;
                 }
                 else
                 {
-                    worker_thread_sleep();
+                    worker_thread_sleep(ctx);
+                    idle_rounds = 0;
                 }
             }
         }
-        LUNA_JOBSYSTEM_API job_id_t submit_job(void* params)
+        inline job_id_t push_job(WorkerThreadContext* ctx, void* params, JobPriority priority)
         {
             JobHeader* job = get_job_header(params);
             job_id_t id = allocate_job_id();
             job->m_id = id;
+            ctx->m_jobs[(u32)priority].push(job);
+            return id;
+        }
+        LUNA_JOBSYSTEM_API job_id_t submit_job(void* params, JobPriority priority)
+        {
             WorkerThreadContext* ctx = get_current_thread_worker_context();
-            LockGuard lock(ctx->m_lock);
-            ctx->m_jobs.push_back(job);
+            job_id_t id = push_job(ctx, params, priority);
             // Wake up one worker thread if any.
-            g_sleep_worker_threads_lock.lock();
-            if (!g_sleep_worker_threads.empty())
+            wake_worker_threads(1);
+            return id;
+        }
+        static void submit_job_continuations(JobHeader* jobs)
+        {
+            WorkerThreadContext* ctx = get_current_thread_worker_context();
+            usize num_jobs = 0;
+            while (jobs)
             {
-                WorkerThreadContext* worker = g_sleep_worker_threads.back();
-                g_sleep_worker_threads.pop_back();
-                worker->m_wake_signal->trigger();
+                JobHeader* next = jobs->m_next_continuation;
+                jobs->m_next_continuation = nullptr;
+                ctx->m_jobs[(u32)jobs->m_priority].push(jobs);
+                jobs = next;
+                ++num_jobs;
+            }
+            wake_worker_threads(num_jobs);
+        }
+        LUNA_JOBSYSTEM_API job_id_t submit_job_after(void* params, job_id_t dependency, JobPriority priority)
+        {
+            JobHeader* job = get_job_header(params);
+            job_id_t id = allocate_job_id();
+            job->m_id = id;
+            job->m_priority = priority;
+            if (!add_job_continuation(dependency, job))
+            {
+                // The dependency is already finished, submit the job directly.
+                WorkerThreadContext* ctx = get_current_thread_worker_context();
+                ctx->m_jobs[(u32)priority].push(job);
+                wake_worker_threads(1);
             }
-            g_sleep_worker_threads_lock.unlock();
             return id;
         }
+        LUNA_JOBSYSTEM_API void* allocate_task_frame(usize size)
+        {
+            u32 size_class;
+            return allocate_job_block(size, MAX_ALIGN, size_class);
+        }
+        LUNA_JOBSYSTEM_API void free_task_frame(void* frame, usize size)
+        {
+            free_job_block(frame, MAX_ALIGN, get_job_size_class(size, MAX_ALIGN));
+        }
+        LUNA_JOBSYSTEM_API void submit_jobs(Span<void* const> params, Span<job_id_t> out_job_ids, JobPriority priority)
+        {
+            lucheck(out_job_ids.empty() || out_job_ids.size() == params.size());
+            WorkerThreadContext* ctx = get_current_thread_worker_context();
+            for (usize i = 0; i < params.size(); ++i)
+            {
+                job_id_t id = push_job(ctx, params[i], priority);
+                if (!out_job_ids.empty()) out_job_ids[i] = id;
+            }
+            wake_worker_threads(params.size());
+        }
+        LUNA_JOBSYSTEM_API void set_worker_spin_count(u32 spin_count)
+        {
+            g_worker_spin_count = spin_count;
+        }
+        LUNA_JOBSYSTEM_API job_id_t submit_main_thread_job(void* params)
+        {
+            JobHeader* job = get_job_header(params);
+            job_id_t id = allocate_job_id();
+            job->m_id = id;
+            LockGuard guard(g_main_thread_jobs_lock);
+            g_main_thread_jobs.push_back(job);
+            return id;
+        }
+        LUNA_JOBSYSTEM_API void run_main_thread_jobs()
+        {
+            lucheck_msg(get_current_thread() == get_main_thread(), "run_main_thread_jobs can only be called from the main thread.");
+            JobHeader* job = consume_main_thread_job();
+            while (job)
+            {
+                execute_job(job);
+                job = consume_main_thread_job();
+            }
+        }
         LUNA_JOBSYSTEM_API job_id_t get_current_job_id(void* params)
         {
             JobHeader* job = get_job_header(params);
@@ -357,7 +854,30 @@ namespace Luna
                 {
                     execute_job(next_job);
                 }
+                else
+                {
+                    yield_current_thread();
+                }
+            }
+        }
+
+        LUNA_JOBSYSTEM_API u32 get_num_worker_threads()
+        {
+            return (u32)g_worker_threads.size();
+        }
+        LUNA_JOBSYSTEM_API JobAllocationStats get_job_allocation_stats()
+        {
+            JobAllocationStats stats;
+            u32 num_contexts = get_num_worker_thread_contexts();
+            for (u32 i = 0; i < num_contexts; ++i)
+            {
+                WorkerThreadContext* ctx = g_worker_thread_contexts[i];
+                if (!ctx) continue;
+                stats.num_job_allocations += ctx->m_num_job_allocations;
+                stats.num_pool_hits += ctx->m_num_pool_hits;
+                stats.num_heap_allocations += ctx->m_num_heap_allocations;
             }
+            return stats;
         }
 
         struct JobSystemModule : public Module
@@ -365,6 +885,8 @@ namespace Luna
             virtual const c8* get_name() override { return "JobSystem"; }
             virtual RV on_init() override
             {
+                register_boxed_type<JobGraph>();
+                impl_interface_for_type<JobGraph, IJobGraph>();
                 return job_system_init();
             }
             virtual void on_close() override
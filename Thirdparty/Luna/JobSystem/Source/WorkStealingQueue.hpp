@@ -0,0 +1,158 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file WorkStealingQueue.hpp
+* @author JXMaster
+* @date 2026/10/17
+* @brief The lock-free work-stealing deque (Chase-Lev deque) used by worker threads.
+*/
+#pragma once
+#include <Luna/Runtime/Base.hpp>
+#include <Luna/Runtime/Memory.hpp>
+#include <atomic>
+
+namespace Luna
+{
+    namespace JobSystem
+    {
+        //! A lock-free single-producer, multiple-consumer deque.
+        //! @details Only the owner thread can call @ref push and @ref pop, which operate on the bottom end of the
+        //! deque in LIFO order. Any other thread can call @ref steal, which takes elements from the top end of the deque
+        //! in FIFO order.
+        //!
+        //! Memory orders follow the C11 version of the Chase-Lev deque described in "Correct and Efficient Work-Stealing 
+        //! for Weak Memory Models" (Lê et al.), so that the deque also works on weakly ordered platforms like ARM64.
+        //!
+        //! The element buffer grows when full. Old buffers may still be read by concurrent thieves, so they
+        //! are retired instead of being freed, and are released when the queue is destroyed.
+        template <typename _Ty>
+        class WorkStealingQueue
+        {
+            struct Buffer
+            {
+                Buffer* m_retired;
+                i64 m_mask;
+                std::atomic<_Ty*> m_elements[1];
+
+                static Buffer* alloc(i64 capacity)
+                {
+                    Buffer* buf = (Buffer*)memalloc(sizeof(Buffer) + sizeof(std::atomic<_Ty*>) * (capacity - 1), alignof(Buffer));
+                    buf->m_retired = nullptr;
+                    buf->m_mask = capacity - 1;
+                    for (i64 i = 0; i < capacity; ++i)
+                    {
+                        new (&buf->m_elements[i]) std::atomic<_Ty*>(nullptr);
+                    }
+                    return buf;
+                }
+                _Ty* get(i64 index) const { return m_elements[index & m_mask].load(std::memory_order_relaxed); }
+                void set(i64 index, _Ty* value) { m_elements[index & m_mask].store(value, std::memory_order_relaxed); }
+            };
+
+            // `m_top` is modified by thieves and `m_bottom` is modified by the owner,
+            // so place them into different cache lines to prevent false sharing.
+            alignas(64) std::atomic<i64> m_top;
+            alignas(64) std::atomic<i64> m_bottom;
+            std::atomic<Buffer*> m_buffer;
+
+            Buffer* grow(Buffer* buf, i64 top, i64 bottom)
+            {
+                Buffer* new_buf = Buffer::alloc((buf->m_mask + 1) * 2);
+                for (i64 i = top; i < bottom; ++i)
+                {
+                    new_buf->set(i, buf->get(i));
+                }
+                new_buf->m_retired = buf;
+                // Publishes copied elements to thieves that load the new buffer.
+                m_buffer.store(new_buf, std::memory_order_release);
+                return new_buf;
+            }
+        public:
+            //! Constructs one empty queue.
+            //! @param[in] initial_capacity The initial capacity of the queue. This must be powers of 2.
+            WorkStealingQueue(i64 initial_capacity = 256) :
+                m_top(0),
+                m_bottom(0),
+                m_buffer(Buffer::alloc(initial_capacity)) {}
+            WorkStealingQueue(const WorkStealingQueue&) = delete;
+            WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+            ~WorkStealingQueue()
+            {
+                Buffer* buf = m_buffer.load(std::memory_order_relaxed);
+                while (buf)
+                {
+                    Buffer* retired = buf->m_retired;
+                    memfree(buf, alignof(Buffer));
+                    buf = retired;
+                }
+            }
+            //! Checks whether the queue is empty when this function is called.
+            bool empty() const
+            {
+                return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+            }
+            //! Pushes one element to the bottom of the queue. This can only be called from the owner thread.
+            void push(_Ty* value)
+            {
+                i64 b = m_bottom.load(std::memory_order_relaxed);
+                i64 t = m_top.load(std::memory_order_acquire);
+                Buffer* buf = m_buffer.load(std::memory_order_relaxed);
+                if (b - t > buf->m_mask)
+                {
+                    buf = grow(buf, t, b);
+                }
+                buf->set(b, value);
+                // Publishes the element to thieves.
+                m_bottom.store(b + 1, std::memory_order_release);
+            }
+            //! Pops one element from the bottom of the queue. This can only be called from the owner thread.
+            //! @return Returns the popped element, or `nullptr` if the queue is empty.
+            _Ty* pop()
+            {
+                i64 b = m_bottom.load(std::memory_order_relaxed) - 1;
+                Buffer* buf = m_buffer.load(std::memory_order_relaxed);
+                m_bottom.store(b, std::memory_order_relaxed);
+                // Orders the write of `m_bottom` before the following read of `m_top`, paired with the fence in `steal`.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                i64 t = m_top.load(std::memory_order_relaxed);
+                if (t > b)
+                {
+                    // The queue is empty.
+                    m_bottom.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                _Ty* value = buf->get(b);
+                if (t == b)
+                {
+                    // This is the last element, race with thieves.
+                    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    {
+                        value = nullptr;
+                    }
+                    m_bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return value;
+            }
+            //! Steals one element from the top of the queue. This can be called from any thread.
+            //! @return Returns the stolen element, or `nullptr` if the queue is empty or if the steal races
+            //! with another consumer.
+            _Ty* steal()
+            {
+                i64 t = m_top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // Pairs with the release store in `push`, so that the element is visible once `b` is seen.
+                i64 b = m_bottom.load(std::memory_order_acquire);
+                if (t >= b) return nullptr;
+                Buffer* buf = m_buffer.load(std::memory_order_acquire);
+                _Ty* value = buf->get(t);
+                if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    return nullptr;
+                }
+                return value;
+            }
+        };
+    }
+}
@@ -0,0 +1,290 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Task.hpp
+* @author JXMaster
+* @date 2026/10/17
+* @brief Coroutine tasks that run on the job system.
+* @note This header is experimental. The SDK is built with C++17, so no module in the SDK includes this header,
+* and it is only compiled by applications that include it with C++20 coroutine support enabled.
+*/
+#pragma once
+#include "JobSystem.hpp"
+#include <Luna/Runtime/Assert.hpp>
+
+// Coroutine tasks require C++20 coroutine support from the compiler.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define LUNA_JOBSYSTEM_TASK_SUPPORTED 1
+
+namespace Luna
+{
+    namespace JobSystem
+    {
+        //! @addtogroup JobSystem
+        //! @{
+
+        template <typename _Ty> class Task;
+
+        namespace Impl
+        {
+            struct TaskResumeJobParams
+            {
+                void* m_handle;
+            };
+            inline void task_resume_job(void* params)
+            {
+                std::coroutine_handle<>::from_address(((TaskResumeJobParams*)params)->m_handle).resume();
+            }
+            //! Creates one job that resumes the specified coroutine when being executed.
+            inline void* new_task_resume_job(std::coroutine_handle<> handle)
+            {
+                TaskResumeJobParams* params = (TaskResumeJobParams*)new_job(task_resume_job, sizeof(TaskResumeJobParams), alignof(TaskResumeJobParams));
+                params->m_handle = handle.address();
+                return params;
+            }
+
+            struct TaskPromiseBase
+            {
+                //! The coroutine that awaits this task, resumed when this task returns.
+                std::coroutine_handle<> m_continuation;
+                //! The job ID finished when this task returns, if this task is started by @ref Task::start.
+                job_id_t m_job_id = INVALID_JOB_ID;
+
+                static void* operator new(usize size)
+                {
+                    return allocate_task_frame(size);
+                }
+                static void operator delete(void* frame, usize size)
+                {
+                    free_task_frame(frame, size);
+                }
+
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept { return false; }
+                    template <typename _Promise>
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<_Promise> handle) noexcept
+                    {
+                        TaskPromiseBase& promise = handle.promise();
+                        // Read all data before finishing the job ID, since the frame may be destroyed
+                        // by the waiting thread as soon as the job ID is finished.
+                        std::coroutine_handle<> continuation = promise.m_continuation;
+                        job_id_t job_id = promise.m_job_id;
+                        if (job_id != INVALID_JOB_ID) finish_job_id(job_id);
+                        if (continuation) return continuation;
+                        return std::noop_coroutine();
+                    }
+                    void await_resume() const noexcept {}
+                };
+
+                std::suspend_always initial_suspend() noexcept { return {}; }
+                FinalAwaiter final_suspend() noexcept { return {}; }
+                void unhandled_exception() { lupanic_msg_always("Unhandled exception in job system task."); }
+            };
+
+            template <typename _Ty>
+            struct TaskPromise : TaskPromiseBase
+            {
+                alignas(_Ty) u8 m_value[sizeof(_Ty)];
+                bool m_has_value = false;
+
+                ~TaskPromise()
+                {
+                    if (m_has_value) get_value().~_Ty();
+                }
+                _Ty& get_value()
+                {
+                    luassert(m_has_value);
+                    return *(_Ty*)m_value;
+                }
+                Task<_Ty> get_return_object();
+                template <typename _Rty>
+                void return_value(_Rty&& value)
+                {
+                    new (m_value) _Ty(forward<_Rty>(value));
+                    m_has_value = true;
+                }
+            };
+
+            template <>
+            struct TaskPromise<void> : TaskPromiseBase
+            {
+                void get_value() {}
+                Task<void> get_return_object();
+                void return_void() {}
+            };
+        }
+
+        //! Represents one coroutine that runs on the job system.
+        //! @details A function returns `Task<_Ty>` becomes one coroutine that can use `co_await` to wait for other tasks,
+        //! jobs and the job system without blocking the thread:
+        //! * `co_await task` starts `task` on the current thread and resumes the current coroutine with the task result when
+        //! `task` returns.
+        //! * `co_await schedule(priority)` suspends the current coroutine and resumes it on one worker thread, so that the
+        //! following code runs in parallel with the code that starts the task.
+        //! * `co_await wait_job_async(job)` suspends the current coroutine until `job` is finished. The coroutine is submitted
+        //! as a continuation job of `job` by @ref submit_job_after, so no thread is blocked.
+        //!
+        //! The task does not start until being awaited or being started by @ref start. Coroutine frames are allocated by
+        //! @ref allocate_task_frame, and are destroyed when the task object is destroyed.
+        //!
+        //! Coroutine tasks are experimental. The SDK itself is built with C++17 and does not use them, so this header is 
+        //! header-only and is not compiled by any SDK module.
+        //! @par Valid Usage
+        //! * Coroutine tasks are only available when the code is compiled with C++20 coroutine support, in which case
+        //! `LUNA_JOBSYSTEM_TASK_SUPPORTED` is defined.
+        template <typename _Ty = void>
+        class Task
+        {
+        public:
+            using promise_type = Impl::TaskPromise<_Ty>;
+
+            Task() = default;
+            explicit Task(std::coroutine_handle<promise_type> handle) :
+                m_handle(handle) {}
+            Task(const Task&) = delete;
+            Task& operator=(const Task&) = delete;
+            Task(Task&& rhs) :
+                m_handle(rhs.m_handle)
+            {
+                rhs.m_handle = nullptr;
+            }
+            Task& operator=(Task&& rhs)
+            {
+                reset();
+                m_handle = rhs.m_handle;
+                rhs.m_handle = nullptr;
+                return *this;
+            }
+            ~Task()
+            {
+                reset();
+            }
+            //! Checks whether this task object holds one coroutine.
+            bool valid() const { return (bool)m_handle; }
+            //! Checks whether the coroutine has returned.
+            bool done() const { return m_handle && m_handle.done(); }
+            //! Starts the task on one worker thread.
+            //! @param[in] priority The priority of the job that starts the task.
+            //! @return Returns one job ID that will be finished when the task returns. Use @ref wait_job to wait for the task
+            //! from a thread that is not running a coroutine, then call @ref get to fetch the result.
+            //! @par Valid Usage
+            //! * The task must not be started or awaited before.
+            job_id_t start(JobPriority priority = JobPriority::normal)
+            {
+                luassert(m_handle && !m_handle.done());
+                job_id_t id = allocate_job_id();
+                m_handle.promise().m_job_id = id;
+                submit_job(Impl::new_task_resume_job(m_handle), priority);
+                return id;
+            }
+            //! Gets the result of the task.
+            //! @par Valid Usage
+            //! * The task must have returned.
+            decltype(auto) get()
+            {
+                luassert(done());
+                return m_handle.promise().get_value();
+            }
+            //! Releases the coroutine frame held by this task.
+            //! @par Valid Usage
+            //! * The coroutine must not be running when this is called.
+            void reset()
+            {
+                if (m_handle)
+                {
+                    m_handle.destroy();
+                    m_handle = nullptr;
+                }
+            }
+
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> m_handle;
+
+                bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    m_handle.promise().m_continuation = awaiting;
+                    // Runs the task on the current thread, the awaiting coroutine is resumed when the task returns.
+                    return m_handle;
+                }
+                decltype(auto) await_resume()
+                {
+                    return m_handle.promise().get_value();
+                }
+            };
+            Awaiter operator co_await() const noexcept
+            {
+                return Awaiter{ m_handle };
+            }
+        private:
+            std::coroutine_handle<promise_type> m_handle;
+        };
+
+        namespace Impl
+        {
+            template <typename _Ty>
+            inline Task<_Ty> TaskPromise<_Ty>::get_return_object()
+            {
+                return Task<_Ty>(std::coroutine_handle<TaskPromise<_Ty>>::from_promise(*this));
+            }
+            inline Task<void> TaskPromise<void>::get_return_object()
+            {
+                return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+            }
+        }
+
+        //! The awaitable object returned by @ref schedule.
+        struct ScheduleAwaiter
+        {
+            JobPriority m_priority;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                submit_job(Impl::new_task_resume_job(handle), m_priority);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        //! Suspends the current coroutine and resumes it as one job, so that the rest of the coroutine can be executed
+        //! by any worker thread.
+        //! @param[in] priority The priority of the job that resumes the coroutine.
+        //! @return Returns one object that should be awaited by `co_await`.
+        inline ScheduleAwaiter schedule(JobPriority priority = JobPriority::normal)
+        {
+            return ScheduleAwaiter{ priority };
+        }
+
+        //! The awaitable object returned by @ref wait_job_async.
+        struct JobAwaiter
+        {
+            job_id_t m_job;
+            JobPriority m_priority;
+
+            bool await_ready() const noexcept { return is_job_finished(m_job); }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                submit_job_after(Impl::new_task_resume_job(handle), m_job, m_priority);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        //! Suspends the current coroutine until the specified job is finished.
+        //! @param[in] job The job ID to wait.
+        //! @param[in] priority The priority of the job that resumes the coroutine.
+        //! @return Returns one object that should be awaited by `co_await`.
+        inline JobAwaiter wait_job_async(job_id_t job, JobPriority priority = JobPriority::normal)
+        {
+            return JobAwaiter{ job, priority };
+        }
+
+        //! @}
+    }
+}
+
+#endif
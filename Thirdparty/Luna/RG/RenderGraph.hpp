@@ -24,6 +24,13 @@ namespace Luna
             Name name;
             //! The render pass type.
             Name type;
+            //! Whether to execute this render pass on one asynchronous compute queue.
+            //! @details If this is `true` and the device has one compute queue, the render pass is recorded to one command buffer
+            //! of the compute queue, and may run in parallel with render passes of the graphics queue. The render graph inserts 
+            //! fences between queues based on input and output connections of render passes.
+            //! 
+            //! The render pass should only record compute and copy commands if this is `true`.
+            bool async_compute = false;
         };
 
         //! Specifies the residency type of one resource in one render graph.
@@ -37,7 +44,8 @@ namespace Luna
             //! The render graph allocates this resource when the graph is being compiled, 
             //! and does not release it after the render graph execution is finished.
             //! 
-            //! This resource will be released when the render graph is destructed or recompiled.
+            //! This resource will be released when the render graph is destructed or recompiled, unless the resource is 
+            //! reused by the recompiled graph or is kept by one graph in the compiled graph cache.
             persistent = 1,
             //! This resource is imported to the render graph. 
             //! The render graph does not manage the resource lifetime.
@@ -98,6 +106,63 @@ namespace Luna
             //! Whether to enable render pass time profiling. If this is `true`, the render graph creates one query heap
             //! that can be used by the render pass object to record start and end time of the render pass.
             bool enable_time_profiling = false;
+            //! Whether to record render passes in parallel. If this is `true`, @ref IRenderGraph::execute records every render pass 
+            //! to its own command buffer using multiple threads of the job system, then submits command buffers in execution order. 
+            //! Render pass objects must be able to record commands concurrently in such case.
+            bool enable_parallel_recording = false;
+            //! Whether to reuse render pass objects, persistent resources and transient memory heaps of former compiled graphs
+            //! when compiling the render graph. See @ref IRenderGraph::compile for details.
+            //! @details This is disabled by default, since compile callbacks of reused render passes are not called.
+            bool enable_incremental_compilation = false;
+            //! The maximum number of former compiled graphs kept by the render graph.
+            //! @details When @ref IRenderGraph::compile is called with one descriptor and configuration that matches one 
+            //! cached compiled graph, the cached graph is restored without compiling, so that the application can switch between
+            //! several graph variants (like toggling one effect) without recompiling them every time. Every cached graph keeps its 
+            //! render pass objects, persistent resources and transient memory alive. This is `0` by default, which disables caching.
+            //! This takes effect only if @ref enable_incremental_compilation is `true`.
+            u32 compiled_graph_cache_size = 0;
+        };
+
+        //! Describes the work done by the last call to @ref IRenderGraph::compile.
+        struct RenderGraphCompileStatistics
+        {
+            //! Whether the compiled graph is restored from the compiled graph cache.
+            bool cache_hit = false;
+            //! The number of enabled render passes whose compile callbacks are called.
+            u32 num_compiled_passes = 0;
+            //! The number of enabled render passes whose render pass objects are reused from former compiled graphs.
+            u32 num_reused_passes = 0;
+            //! The number of persistent resources created.
+            u32 num_created_persistent_resources = 0;
+            //! The number of persistent resources reused from former compiled graphs.
+            u32 num_reused_persistent_resources = 0;
+            //! The number of transient memory heaps reused from former compiled graphs.
+            u32 num_reused_transient_heaps = 0;
+            //! The CPU time used to compile the graph, in seconds.
+            f64 compile_time = 0.0;
+        };
+
+        //! Describes memory usage of transient resources in one compiled render graph.
+        struct TransientMemoryStatistics
+        {
+            //! The number of transient resources that are used by enabled passes.
+            u32 num_transient_resources = 0;
+            //! The number of memory heaps allocated for transient resources.
+            u32 num_transient_heaps = 0;
+            //! The total size of memory heaps allocated for transient resources, in bytes. 
+            //! This is the peak transient memory usage of the render graph.
+            u64 transient_memory_size = 0;
+            //! The estimated memory size required if every transient resource uses its own memory without aliasing, in bytes.
+            u64 unaliased_transient_memory_size = 0;
+        };
+
+        //! Describes how much asynchronous compute work overlaps with graphics work in the last execution.
+        struct AsyncComputeStatistics
+        {
+            //! The total time when at least one render pass is running on the compute queue, in GPU ticks.
+            u64 async_compute_time = 0;
+            //! The total time when render passes are running on both the compute queue and the graphics queue, in GPU ticks.
+            u64 overlapped_time = 0;
         };
 
         //! @interface IRenderGraph
@@ -129,8 +194,23 @@ namespace Luna
             //! 3. Determines the lifetime of every transient resource.
             //! 4. Initialize resource descriptors using user-defined descriptors.
             //! 5. Calls the compile callback of every render pass in execution order to get render pass objects.
-            //! 6. Create persistent resources.
-            //! 7. Create time query heap if needed.
+            //! 6. Assign transient resources to memory heaps so that resources whose lifetimes do not overlap share one heap, 
+            //! then allocate memory for heaps.
+            //! 7. Compute resource barriers between render passes using resource states declared by render passes, and 
+            //! compute fences between asynchronous compute render passes and graphics render passes.
+            //! 8. Create persistent resources.
+            //! 9. Create time query heap if needed.
+            //! 
+            //! If @ref RenderGraphCompileConfig::enable_incremental_compilation is `true`, compiling is incremental. If the descriptor 
+            //! and the configuration match one graph compiled before that is still in the compiled graph cache, that graph is 
+            //! restored directly. Otherwise, for every enabled render pass whose type, connections and connected resource descriptors 
+            //! before step 5 match one render pass compiled before, the former render pass object and declared resource descriptors 
+            //! and states are reused without calling the compile callback. Persistent resources whose names and descriptors are not 
+            //! changed, and transient memory heaps that hold the same resources, are also reused.
+            //! 
+            //! Because of reuse, compile callbacks should only depend on the pass type userdata and the resources connected to
+            //! the pass when incremental compilation is enabled. Otherwise, every compile callback is called, and the compiled graph
+            //! cache is not used. In both cases, external resources set before are kept if the resource is still external.
             //! @param[in] config The compilation configuration.
             virtual RV compile(const RenderGraphCompileConfig& config) = 0;
 
@@ -156,9 +236,23 @@ namespace Luna
 
             //! Executes the render graph.
             //! @details This will execute all enabled render passes in order.
+            //! 
+            //! If @ref RenderGraphCompileConfig::enable_parallel_recording is `true`, or if any render pass is executed on the
+            //! asynchronous compute queue, render passes are recorded to command buffers owned by the render graph. In such case, 
+            //! this function submits `cmdbuf` firstly, so that commands recorded to `cmdbuf` before this call are executed before 
+            //! render passes, then submits command buffers of render passes in execution order. The user must not submit `cmdbuf` 
+            //! again, and should wait for `cmdbuf` and reset it before recording new commands to it. The render graph keeps command 
+            //! buffers for several frames in flight, and only waits for one command buffer when it is reused and is still being executed.
+            //! 
+            //! Asynchronous compute passes start after all graphics work submitted before this call, and graphics work submitted 
+            //! to the command queue of `cmdbuf` after this call starts after all asynchronous compute passes are finished, so 
+            //! resources shared with graphics work outside of the render graph, including passes of the last and the next execution, 
+            //! are synchronized.
             //! @param[in] cmdbuf The command buffer used to record render commands of this render graph.
             //! @par Valid Usage
             //! * @ref compile must be called before calling this function.
+            //! * `cmdbuf` must be in recording state, and must not be submitted by the user after this call if render passes are 
+            //! recorded to command buffers owned by the render graph.
             virtual RV execute(RHI::ICommandBuffer* cmdbuf) = 0;
 
             //! Gets one persistent resource.
@@ -173,6 +267,23 @@ namespace Luna
             //! every time span in this array maps to the corresponding render pass returned by @ref get_enabled_render_passes.
             //! The time is measured in GPU ticks, and can be converted to seconds by dividing with @ref RHI::IDevice::get_command_queue_timestamp_frequency.
             virtual RV get_pass_time_intervals(Vector<u64>& pass_times) = 0;
+
+            //! Gets memory usage of transient resources.
+            //! @details This should be called after @ref compile, or empty statistics will be returned.
+            //! @return Returns memory usage of transient resources planned by the last compilation.
+            virtual TransientMemoryStatistics get_transient_memory_statistics() = 0;
+
+            //! Gets the time that asynchronous compute render passes overlap with graphics render passes in the last execution.
+            //! @details This is computed from timestamps written by render passes, so @ref RenderGraphCompileConfig::enable_time_profiling 
+            //! must be `true`, and every render pass should write beginning and ending timestamps to the query heap returned 
+            //! by @ref IRenderPassContext::get_timestamp_query_heap. The command buffers of the last execution must be finished 
+            //! before calling this function. Timestamps of both queues are assumed to use the same time base.
+            //! @return Returns the overlapping statistics. Returns zero statistics if time profiling is disabled.
+            virtual R<AsyncComputeStatistics> get_async_compute_statistics() = 0;
+
+            //! Gets the statistics of the last compilation.
+            //! @return Returns the statistics of the last call to @ref compile.
+            virtual RenderGraphCompileStatistics get_compile_statistics() = 0;
         };
 
         //! Creates one new render graph.
@@ -157,6 +157,25 @@ namespace Luna
             //! @param[in] render_pass The render pass to set.
             //! The render graph will keep a strong reference to this object until the render graph is destructed or recompiled.
             virtual void set_render_pass_object(IRenderPass* render_pass) = 0;
+            //! Declares the state of one buffer resource when this render pass is executed.
+            //! @details The render graph uses declared states to compute resource barriers between render passes, and 
+            //! submits them in batches before render passes are executed, so the render pass object should not submit barriers for 
+            //! resources whose states are declared. Resources whose states are not declared are not transitioned by the render graph, 
+            //! and the render pass object should transition them itself. Since such states are unknown when compiling, the next render 
+            //! pass that declares the state of the resource transitions it from the state tracked by the command buffer 
+            //! (@ref RHI::BufferStateFlag::automatic).
+            //! @param[in] resource The resource id returned by @ref get_input_resource or @ref get_output_resource.
+            //! @param[in] state The state of the resource when this render pass is executed. This must not be @ref RHI::BufferStateFlag::automatic.
+            //! @par Valid Usage
+            //! * `resource` must specify one valid buffer resource.
+            virtual void set_buffer_state(usize resource, RHI::BufferStateFlag state) = 0;
+            //! Declares the state of one texture resource when this render pass is executed.
+            //! @details See @ref set_buffer_state for details.
+            //! @param[in] resource The resource id returned by @ref get_input_resource or @ref get_output_resource.
+            //! @param[in] state The state of the resource when this render pass is executed. This must not be @ref RHI::TextureStateFlag::automatic.
+            //! @par Valid Usage
+            //! * `resource` must specify one valid texture resource.
+            virtual void set_texture_state(usize resource, RHI::TextureStateFlag state) = 0;
         };
 
         //! The function called by the render graph to produce the render pass object using input and output resources.
@@ -13,6 +13,7 @@
 #include <Luna/Runtime/Module.hpp>
 #include "RenderGraph.hpp"
 #include "../RG.hpp"
+#include <Luna/JobSystem/JobSystem.hpp>
 namespace Luna
 {
     namespace RG
@@ -22,12 +23,20 @@ namespace Luna
             virtual const c8* get_name() override { return "RG"; }
             virtual RV on_register() override
             {
-                return add_dependency_module(this, module_rhi());
+                lutry
+                {
+                    luexp(add_dependency_module(this, module_rhi()));
+                    luexp(add_dependency_module(this, module_job_system()));
+                }
+                lucatchret;
+                return ok;
             }
             virtual RV on_init() override
             {
                 register_boxed_type<RenderGraph>();
-                impl_interface_for_type<RenderGraph, IRenderGraph, IRenderPassContext, IRenderGraphCompiler>();
+                impl_interface_for_type<RenderGraph, IRenderGraph, IRenderGraphCompiler>();
+                register_boxed_type<RenderPassContext>();
+                impl_interface_for_type<RenderPassContext, IRenderPassContext>();
                 g_render_pass_types_mtx = new_mutex();
                 return ok;
             }
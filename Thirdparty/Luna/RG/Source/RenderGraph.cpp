@@ -11,6 +11,10 @@
 #define LUNA_RG_API LUNA_EXPORT
 #include "RenderGraph.hpp"
 #include "RenderPass.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/Runtime/Hash.hpp>
+#include <Luna/Runtime/Time.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 
 namespace Luna
 {
@@ -59,7 +63,740 @@ namespace Luna
             return true;
         }
 
+        //! Estimates the memory size of one resource. This is used only for choosing heaps for transient resources,
+        //! the real heap size is determined by the RHI device.
+        inline u64 estimate_resource_size(const ResourceDesc& desc)
+        {
+            if (desc.type == ResourceType::buffer) return desc.buffer.size;
+            auto& tex = desc.texture;
+            u64 size = (u64)tex.width * tex.height * tex.depth * tex.array_size * tex.sample_count * RHI::bits_per_pixel(tex.format) / 8;
+            // The full mip chain takes about 4/3 of the size of the first mip.
+            if (tex.mip_levels != 1) size = size * 4 / 3;
+            return size;
+        }
+
+        template <typename _Ty>
+        inline void hash_value(u64& h, const _Ty& value)
+        {
+            h = memhash64(&value, sizeof(_Ty), h);
+        }
+        inline void hash_name(u64& h, const Name& name)
+        {
+            hash_value(h, name.id());
+        }
+        // Descriptors may contain padding bytes, so hash and compare them member by member.
+        inline void hash_resource_desc(u64& h, const ResourceDesc& desc)
+        {
+            hash_value(h, desc.type);
+            hash_value(h, desc.memory_type);
+            if (desc.type == ResourceType::buffer)
+            {
+                hash_value(h, desc.buffer.size);
+                hash_value(h, desc.buffer.usages);
+                hash_value(h, desc.buffer.flags);
+            }
+            else
+            {
+                auto& tex = desc.texture;
+                hash_value(h, tex.type);
+                hash_value(h, tex.format);
+                hash_value(h, tex.width);
+                hash_value(h, tex.height);
+                hash_value(h, tex.depth);
+                hash_value(h, tex.array_size);
+                hash_value(h, tex.mip_levels);
+                hash_value(h, tex.sample_count);
+                hash_value(h, tex.usages);
+                hash_value(h, tex.flags);
+            }
+        }
+        inline bool equal_resource_desc(const ResourceDesc& lhs, const ResourceDesc& rhs)
+        {
+            if (lhs.type != rhs.type || lhs.memory_type != rhs.memory_type) return false;
+            if (lhs.type == ResourceType::buffer)
+            {
+                return lhs.buffer.size == rhs.buffer.size && lhs.buffer.usages == rhs.buffer.usages && lhs.buffer.flags == rhs.buffer.flags;
+            }
+            auto& a = lhs.texture;
+            auto& b = rhs.texture;
+            return a.type == b.type && a.format == b.format && a.width == b.width && a.height == b.height && a.depth == b.depth &&
+                a.array_size == b.array_size && a.mip_levels == b.mip_levels && a.sample_count == b.sample_count &&
+                a.usages == b.usages && a.flags == b.flags;
+        }
+        inline void hash_connections(u64& h, const Vector<RenderGraphConnection>& connections)
+        {
+            hash_value(h, connections.size());
+            for (auto& c : connections)
+            {
+                hash_value(h, c.pass);
+                hash_name(h, c.parameter);
+                hash_value(h, c.resource);
+            }
+        }
+        inline bool equal_connections(const Vector<RenderGraphConnection>& lhs, const Vector<RenderGraphConnection>& rhs)
+        {
+            if (lhs.size() != rhs.size()) return false;
+            for (usize i = 0; i < lhs.size(); ++i)
+            {
+                if (lhs[i].pass != rhs[i].pass || !(lhs[i].parameter == rhs[i].parameter) || lhs[i].resource != rhs[i].resource) return false;
+            }
+            return true;
+        }
+        //! Computes the key used to find compiled graphs in the compiled graph cache.
+        static u64 hash_render_graph(const RenderGraphDesc& desc, const RenderGraphCompileConfig& config)
+        {
+            u64 h = 0;
+            hash_value(h, config.enable_time_profiling);
+            hash_value(h, config.enable_parallel_recording);
+            hash_value(h, desc.passes.size());
+            for (auto& pass : desc.passes)
+            {
+                hash_name(h, pass.name);
+                hash_name(h, pass.type);
+                hash_value(h, pass.async_compute);
+            }
+            hash_value(h, desc.resources.size());
+            for (auto& res : desc.resources)
+            {
+                hash_value(h, res.type);
+                hash_value(h, res.flags);
+                hash_name(h, res.name);
+                hash_resource_desc(h, res.desc);
+            }
+            hash_connections(h, desc.input_connections);
+            hash_connections(h, desc.output_connections);
+            return h;
+        }
+        static bool equal_render_graph(const RenderGraphDesc& lhs, const RenderGraphDesc& rhs)
+        {
+            if (lhs.passes.size() != rhs.passes.size() || lhs.resources.size() != rhs.resources.size()) return false;
+            for (usize i = 0; i < lhs.passes.size(); ++i)
+            {
+                auto& a = lhs.passes[i];
+                auto& b = rhs.passes[i];
+                if (!(a.name == b.name) || !(a.type == b.type) || a.async_compute != b.async_compute) return false;
+            }
+            for (usize i = 0; i < lhs.resources.size(); ++i)
+            {
+                auto& a = lhs.resources[i];
+                auto& b = rhs.resources[i];
+                if (a.type != b.type || a.flags != b.flags || !(a.name == b.name) || !equal_resource_desc(a.desc, b.desc)) return false;
+            }
+            return equal_connections(lhs.input_connections, rhs.input_connections) &&
+                equal_connections(lhs.output_connections, rhs.output_connections);
+        }
+
+        RV RenderGraph::plan_transient_resources(const Vector<CompiledState*>& former)
+        {
+            lutry
+            {
+                m_transient_heaps.clear();
+                m_transient_memory_statistics = TransientMemoryStatistics();
+                Vector<usize> resources;
+                Vector<u64> sizes(m_resource_data.size(), 0);
+                for (usize i = 0; i < m_resource_data.size(); ++i)
+                {
+                    auto& res = m_resource_data[i];
+                    if (m_desc.resources[i].type != RenderGraphResourceType::transient || res.m_first_access == USIZE_MAX) continue;
+                    if (!is_resource_desc_valid(res.m_resource_desc))
+                    {
+                        return set_error(BasicError::bad_data(), "Cannot create transient resource %s because the resource layout is not specified.", m_desc.resources[i].name.c_str());
+                    }
+                    resources.push_back(i);
+                    sizes[i] = estimate_resource_size(res.m_resource_desc);
+                    m_transient_memory_statistics.unaliased_transient_memory_size += sizes[i];
+                }
+                // Place large resources firstly, so that small resources can reuse heaps created for large resources.
+                sort(resources.begin(), resources.end(), [&](usize lhs, usize rhs) { return sizes[lhs] > sizes[rhs]; });
+                Vector<RHI::BufferDesc> buffers;
+                Vector<RHI::TextureDesc> textures;
+                auto collect_descs = [&](const TransientHeap& heap)
+                {
+                    buffers.clear();
+                    textures.clear();
+                    for (usize r : heap.m_resources)
+                    {
+                        auto& desc = m_resource_data[r].m_resource_desc;
+                        if (desc.type == ResourceType::buffer) buffers.push_back(desc.buffer);
+                        else textures.push_back(desc.texture);
+                    }
+                };
+                for (usize r : resources)
+                {
+                    auto& res = m_resource_data[r];
+                    // Choose the heap that grows least when placing this resource, and prefer smaller heaps 
+                    // if multiple heaps have enough space.
+                    usize best_heap = USIZE_MAX;
+                    u64 best_growth = U64_MAX;
+                    u64 best_size = U64_MAX;
+                    for (usize h = 0; h < m_transient_heaps.size(); ++h)
+                    {
+                        auto& heap = m_transient_heaps[h];
+                        if (heap.m_memory_type != res.m_resource_desc.memory_type) continue;
+                        // Resources accessed by multiple queues are not aliased, since accesses from different queues 
+                        // are not ordered by pass order.
+                        if (res.m_queue_mask != 1 && res.m_queue_mask != 2) continue;
+                        if (heap.m_queue_mask != res.m_queue_mask) continue;
+                        u64 growth = sizes[r] > heap.m_estimated_size ? sizes[r] - heap.m_estimated_size : 0;
+                        if (growth > best_growth || (growth == best_growth && heap.m_estimated_size >= best_size)) continue;
+                        bool overlapped = false;
+                        for (usize other : heap.m_resources)
+                        {
+                            auto& other_res = m_resource_data[other];
+                            if (res.m_first_access <= other_res.m_last_access && other_res.m_first_access <= res.m_last_access)
+                            {
+                                overlapped = true;
+                                break;
+                            }
+                        }
+                        if (overlapped) continue;
+                        collect_descs(heap);
+                        if (res.m_resource_desc.type == ResourceType::buffer) buffers.push_back(res.m_resource_desc.buffer);
+                        else textures.push_back(res.m_resource_desc.texture);
+                        if (!m_device->is_resources_aliasing_compatible(heap.m_memory_type, { buffers.data(), buffers.size() }, { textures.data(), textures.size() })) continue;
+                        best_heap = h;
+                        best_growth = growth;
+                        best_size = heap.m_estimated_size;
+                    }
+                    if (best_heap == USIZE_MAX)
+                    {
+                        best_heap = m_transient_heaps.size();
+                        TransientHeap heap;
+                        heap.m_memory_type = res.m_resource_desc.memory_type;
+                        heap.m_queue_mask = res.m_queue_mask;
+                        m_transient_heaps.push_back(move(heap));
+                    }
+                    auto& heap = m_transient_heaps[best_heap];
+                    heap.m_resources.push_back(r);
+                    heap.m_estimated_size = max(heap.m_estimated_size, sizes[r]);
+                    res.m_transient_heap = best_heap;
+                }
+                // Allocate memory for heaps. Memory of one former heap can be reused if the former heap holds resources
+                // with the same descriptors in the same order.
+                Vector<RHI::IDeviceMemory*> reused_memory;
+                for (auto& heap : m_transient_heaps)
+                {
+                    for (CompiledState* state : former)
+                    {
+                        for (auto& former_heap : state->m_transient_heaps)
+                        {
+                            if (!former_heap.m_memory || former_heap.m_memory_type != heap.m_memory_type || 
+                                former_heap.m_queue_mask != heap.m_queue_mask ||
+                                former_heap.m_resources.size() != heap.m_resources.size()) continue;
+                            bool compatible = true;
+                            for (usize i = 0; i < heap.m_resources.size(); ++i)
+                            {
+                                if (!equal_resource_desc(m_resource_data[heap.m_resources[i]].m_resource_desc, 
+                                    state->m_resource_data[former_heap.m_resources[i]].m_resource_desc))
+                                {
+                                    compatible = false;
+                                    break;
+                                }
+                            }
+                            if (!compatible) continue;
+                            // One heap memory cannot be used by two heaps of the same graph.
+                            bool used = false;
+                            for (auto m : reused_memory)
+                            {
+                                if (m == former_heap.m_memory.get())
+                                {
+                                    used = true;
+                                    break;
+                                }
+                            }
+                            if (used) continue;
+                            heap.m_memory = former_heap.m_memory;
+                            reused_memory.push_back(heap.m_memory);
+                            ++m_compile_statistics.num_reused_transient_heaps;
+                            break;
+                        }
+                        if (heap.m_memory) break;
+                    }
+                    if (!heap.m_memory)
+                    {
+                        collect_descs(heap);
+                        luset(heap.m_memory, m_device->allocate_memory(heap.m_memory_type, { buffers.data(), buffers.size() }, { textures.data(), textures.size() }));
+                    }
+                    m_transient_memory_statistics.transient_memory_size += heap.m_memory->get_size();
+                }
+                m_transient_memory_statistics.num_transient_resources = (u32)resources.size();
+                m_transient_memory_statistics.num_transient_heaps = (u32)m_transient_heaps.size();
+            }
+            lucatchret;
+            return ok;
+        }
+
+        void RenderGraph::assign_command_queues()
+        {
+            m_async_compute_queue = U32_MAX;
+            for (usize i : m_enabled_passes)
+            {
+                if (!m_desc.passes[i].async_compute) continue;
+                // Use the first compute queue for asynchronous compute passes.
+                u32 num_queues = m_device->get_num_command_queues();
+                for (u32 q = 0; q < num_queues; ++q)
+                {
+                    if (m_device->get_command_queue_desc(q).type == RHI::CommandQueueType::compute)
+                    {
+                        m_async_compute_queue = q;
+                        break;
+                    }
+                }
+                break;
+            }
+            for (auto& res : m_resource_data) res.m_queue_mask = 0;
+            for (usize i : m_enabled_passes)
+            {
+                auto& pass = m_pass_data[i];
+                pass.m_async_compute = m_async_compute_queue != U32_MAX && m_desc.passes[i].async_compute;
+                u8 mask = pass.m_async_compute ? 2 : 1;
+                for (auto& r : pass.m_input_resources) m_resource_data[r.second].m_queue_mask |= mask;
+                for (auto& r : pass.m_output_resources) m_resource_data[r.second].m_queue_mask |= mask;
+            }
+        }
+
+        RV RenderGraph::plan_async_compute()
+        {
+            lutry
+            {
+                m_fences.clear();
+                m_frame_begin_fence.reset();
+                m_frame_end_fence.reset();
+                for (usize i : m_enabled_passes)
+                {
+                    auto& pass = m_pass_data[i];
+                    pass.m_wait_fences.clear();
+                    pass.m_signal_fences.clear();
+                }
+                if (m_async_compute_queue == U32_MAX) return ok;
+                // Synchronizes asynchronous compute passes with graphics work outside of this execution. 
+                usize first_compute_pass = USIZE_MAX;
+                usize last_compute_pass = USIZE_MAX;
+                for (usize i : m_enabled_passes)
+                {
+                    if (!m_pass_data[i].m_async_compute) continue;
+                    if (first_compute_pass == USIZE_MAX) first_compute_pass = i;
+                    last_compute_pass = i;
+                }
+                luset(m_frame_begin_fence, m_device->new_fence());
+                luset(m_frame_end_fence, m_device->new_fence());
+                m_pass_data[first_compute_pass].m_wait_fences.push_back(m_frame_begin_fence);
+                m_pass_data[last_compute_pass].m_signal_fences.push_back(m_frame_end_fence);
+                // Tracks the last writing pass and the last reading pass of every queue after the last write for every resource.
+                struct ResourceAccess
+                {
+                    usize last_write = USIZE_MAX;
+                    usize last_read[2] = { USIZE_MAX, USIZE_MAX };
+                };
+                Vector<ResourceAccess> accesses(m_resource_data.size());
+                // The last pass of the other queue that is known to be finished for passes of every queue.
+                usize synced[2] = { USIZE_MAX, USIZE_MAX };
+                for (usize i : m_enabled_passes)
+                {
+                    auto& pass = m_pass_data[i];
+                    u32 queue = pass.m_async_compute ? 1 : 0;
+                    // The last pass of the other queue that this pass depends on. Passes in the same queue are 
+                    // executed in order, so waiting for the last pass is enough.
+                    usize dependency = USIZE_MAX;
+                    auto add_dependency = [&](usize p)
+                    {
+                        if (p == USIZE_MAX || (m_pass_data[p].m_async_compute ? 1 : 0) == queue) return;
+                        dependency = dependency == USIZE_MAX ? p : max(dependency, p);
+                    };
+                    for (auto& r : pass.m_input_resources)
+                    {
+                        add_dependency(accesses[r.second].last_write);
+                    }
+                    for (auto& r : pass.m_output_resources)
+                    {
+                        auto& access = accesses[r.second];
+                        add_dependency(access.last_write);
+                        add_dependency(access.last_read[1 - queue]);
+                    }
+                    // Graphics passes that transition resources for this pass at their ends.
+                    for (usize p : pass.m_handoff_passes)
+                    {
+                        add_dependency(p);
+                    }
+                    // Skip the fence if one former pass of the same queue already waits for the dependency or later passes.
+                    if (dependency != USIZE_MAX && (synced[queue] == USIZE_MAX || dependency > synced[queue]))
+                    {
+                        lulet(fence, m_device->new_fence());
+                        m_fences.push_back(fence);
+                        m_pass_data[dependency].m_signal_fences.push_back(fence);
+                        pass.m_wait_fences.push_back(fence);
+                        synced[queue] = dependency;
+                    }
+                    for (auto& r : pass.m_input_resources)
+                    {
+                        accesses[r.second].last_read[queue] = i;
+                    }
+                    for (auto& r : pass.m_output_resources)
+                    {
+                        auto& access = accesses[r.second];
+                        access.last_write = i;
+                        access.last_read[0] = USIZE_MAX;
+                        access.last_read[1] = USIZE_MAX;
+                    }
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+
+        //! Checks whether one barrier is required between two accesses that use the same state.
+        inline bool need_barrier_for_same_state(ResourceType type, u32 state)
+        {
+            // Shader writes to the same resource must be ordered even if the state is not changed.
+            if (type == ResourceType::buffer)
+            {
+                return (state & (u32)(RHI::BufferStateFlag::shader_write_ps | RHI::BufferStateFlag::shader_write_cs)) != 0;
+            }
+            return (state & (u32)(RHI::TextureStateFlag::shader_write_ps | RHI::TextureStateFlag::shader_write_cs)) != 0;
+        }
+
+        //! Gets resource states that can be used by command buffers of compute queues.
+        inline u32 get_compute_queue_states(ResourceType type)
+        {
+            if (type == ResourceType::buffer)
+            {
+                return (u32)(RHI::BufferStateFlag::indirect_argument | RHI::BufferStateFlag::uniform_buffer_cs |
+                    RHI::BufferStateFlag::shader_read_cs | RHI::BufferStateFlag::shader_write_cs |
+                    RHI::BufferStateFlag::copy_dest | RHI::BufferStateFlag::copy_source);
+            }
+            return (u32)(RHI::TextureStateFlag::shader_read_cs | RHI::TextureStateFlag::shader_write_cs |
+                RHI::TextureStateFlag::copy_dest | RHI::TextureStateFlag::copy_source);
+        }
+
+        void RenderGraph::plan_barriers()
+        {
+            m_barriers.clear();
+            // The last declared state of every resource, `0` if the resource is not accessed yet or the state is unknown.
+            Vector<u32> states(m_resource_data.size(), 0);
+            // The last graphics queue pass that declares the state of every resource.
+            Vector<usize> last_graphics_pass(m_resource_data.size(), USIZE_MAX);
+            for (auto& pass : m_pass_data)
+            {
+                pass.m_end_barriers.clear();
+                pass.m_handoff_passes.clear();
+            }
+            for (usize p = 0; p < m_pass_data.size(); ++p)
+            {
+                auto& pass = m_pass_data[p];
+                pass.m_first_barrier = m_barriers.size();
+                pass.m_num_barriers = 0;
+                if (!pass.m_enabled) continue;
+                // Collects states declared for every resource in this pass. Passes on the asynchronous compute queue 
+                // cannot use graphics-only states, so such states are removed.
+                auto get_declared_state = [&](usize h)
+                {
+                    u32 after = 0;
+                    for (auto& state : pass.m_resource_states)
+                    {
+                        if (state.first == h) after |= state.second;
+                    }
+                    if (pass.m_async_compute) after &= get_compute_queue_states(m_resource_data[h].m_resource_desc.type);
+                    return after;
+                };
+                // Transient resources are created in aliasing memory, so emit one aliasing barrier that also 
+                // transitions the resource to the first state.
+                for (usize h : pass.m_create_resources)
+                {
+                    u32 after = get_declared_state(h);
+                    BarrierData barrier;
+                    barrier.m_resource = h;
+                    barrier.m_before = (u32)RHI::TextureStateFlag::automatic;
+                    barrier.m_after = after;
+                    barrier.m_flags = RHI::ResourceBarrierFlag::aliasing;
+                    m_barriers.push_back(barrier);
+                    states[h] = after;
+                    if (!pass.m_async_compute) last_graphics_pass[h] = p;
+                }
+                for (auto& state : pass.m_resource_states)
+                {
+                    usize h = state.first;
+                    bool created = false;
+                    for (usize c : pass.m_create_resources)
+                    {
+                        if (c == h)
+                        {
+                            created = true;
+                            break;
+                        }
+                    }
+                    if (created) continue;
+                    // Merge all states declared for the same resource in this pass.
+                    bool first_declaration = true;
+                    for (auto& other : pass.m_resource_states)
+                    {
+                        if (&other == &state) break;
+                        if (other.first == h)
+                        {
+                            first_declaration = false;
+                            break;
+                        }
+                    }
+                    if (!first_declaration) continue;
+                    u32 after = get_declared_state(h);
+                    if (!after) continue;
+                    ResourceType type = m_resource_data[h].m_resource_desc.type;
+                    u32 before = states[h];
+                    if (pass.m_async_compute && (before & ~get_compute_queue_states(type)))
+                    {
+                        // The resource is left in graphics-only states by one graphics pass, so the graphics pass transitions 
+                        // it at its end, and this pass waits for the graphics pass.
+                        usize graphics_pass = last_graphics_pass[h];
+                        BarrierData barrier;
+                        barrier.m_resource = h;
+                        barrier.m_before = before;
+                        barrier.m_after = after;
+                        barrier.m_flags = RHI::ResourceBarrierFlag::none;
+                        m_pass_data[graphics_pass].m_end_barriers.push_back(barrier);
+                        pass.m_handoff_passes.push_back(graphics_pass);
+                        before = after;
+                    }
+                    states[h] = after;
+                    if (!pass.m_async_compute) last_graphics_pass[h] = p;
+                    if (before == after && !need_barrier_for_same_state(type, after)) continue;
+                    BarrierData barrier;
+                    barrier.m_resource = h;
+                    // Let the command buffer load the state for the first access.
+                    barrier.m_before = before ? before : (u32)RHI::TextureStateFlag::automatic;
+                    barrier.m_after = after;
+                    barrier.m_flags = RHI::ResourceBarrierFlag::none;
+                    m_barriers.push_back(barrier);
+                }
+                // Resources accessed without declared states may be transitioned by the pass itself, so their states are 
+                // unknown after this pass, and the next barrier loads the state tracked by the command buffer.
+                auto forget_undeclared_state = [&](usize h)
+                {
+                    for (auto& state : pass.m_resource_states)
+                    {
+                        if (state.first == h) return;
+                    }
+                    states[h] = 0;
+                };
+                for (auto& r : pass.m_input_resources) forget_undeclared_state(r.second);
+                for (auto& r : pass.m_output_resources) forget_undeclared_state(r.second);
+                pass.m_num_barriers = m_barriers.size() - pass.m_first_barrier;
+            }
+            // End barriers are added when planning later passes, so reserve barrier arrays after all passes are planned.
+            for (auto& pass : m_pass_data)
+            {
+                if (!pass.m_enabled) continue;
+                usize num_buffer_barriers = 0;
+                for (usize i = pass.m_first_barrier; i < pass.m_first_barrier + pass.m_num_barriers; ++i)
+                {
+                    if (m_resource_data[m_barriers[i].m_resource].m_resource_desc.type == ResourceType::buffer) ++num_buffer_barriers;
+                }
+                usize num_end_buffer_barriers = 0;
+                for (auto& barrier : pass.m_end_barriers)
+                {
+                    if (m_resource_data[barrier.m_resource].m_resource_desc.type == ResourceType::buffer) ++num_end_buffer_barriers;
+                }
+                pass.m_buffer_barriers.reserve(max(num_buffer_barriers, num_end_buffer_barriers));
+                pass.m_texture_barriers.reserve(max(pass.m_num_barriers - num_buffer_barriers, pass.m_end_barriers.size() - num_end_buffer_barriers));
+            }
+        }
+
+        void RenderGraph::submit_barriers(RHI::ICommandBuffer* cmdbuf, PassData& pass, const BarrierData* barriers, usize num_barriers)
+        {
+            if (!num_barriers) return;
+            auto& buffer_barriers = pass.m_buffer_barriers;
+            auto& texture_barriers = pass.m_texture_barriers;
+            buffer_barriers.clear();
+            texture_barriers.clear();
+            for (usize i = 0; i < num_barriers; ++i)
+            {
+                auto& barrier = barriers[i];
+                auto& res = m_resource_data[barrier.m_resource];
+                if (!res.m_resource) continue;
+                if (res.m_resource_desc.type == ResourceType::texture)
+                {
+                    Ref<RHI::ITexture> tex = res.m_resource;
+                    texture_barriers.push_back({ tex, RHI::TEXTURE_BARRIER_ALL_SUBRESOURCES, (RHI::TextureStateFlag)barrier.m_before, (RHI::TextureStateFlag)barrier.m_after, barrier.m_flags });
+                }
+                else
+                {
+                    Ref<RHI::IBuffer> buf = res.m_resource;
+                    buffer_barriers.push_back({ buf, (RHI::BufferStateFlag)barrier.m_before, (RHI::BufferStateFlag)barrier.m_after, barrier.m_flags });
+                }
+            }
+            if (!buffer_barriers.empty() || !texture_barriers.empty())
+            {
+                cmdbuf->resource_barrier({ buffer_barriers.data(), buffer_barriers.size() }, { texture_barriers.data(), texture_barriers.size() });
+            }
+        }
+
+        const RenderGraph::PassData* RenderGraph::find_reusable_pass(usize pass, const Vector<CompiledState*>& former)
+        {
+            auto& data = m_pass_data[pass];
+            for (CompiledState* state : former)
+            {
+                for (auto& other : state->m_pass_data)
+                {
+                    if (!other.m_enabled || other.m_claimed || !other.m_render_pass || !(other.m_type == data.m_type) ||
+                        other.m_compile_inputs.size() != data.m_compile_inputs.size()) continue;
+                    bool compatible = true;
+                    for (usize k = 0; k < data.m_compile_inputs.size() && compatible; ++k)
+                    {
+                        auto& a = data.m_compile_inputs[k];
+                        auto& b = other.m_compile_inputs[k];
+                        if (!(a.m_parameter == b.m_parameter) || a.m_output != b.m_output || !equal_resource_desc(a.m_desc, b.m_desc))
+                        {
+                            compatible = false;
+                            break;
+                        }
+                        // Parameters bound to the same resource must still be bound to the same resource, so that
+                        // declared descriptors and states can be mapped to resources of this pass.
+                        for (usize l = 0; l < k; ++l)
+                        {
+                            if ((data.m_compile_inputs[l].m_resource == a.m_resource) != (other.m_compile_inputs[l].m_resource == b.m_resource))
+                            {
+                                compatible = false;
+                                break;
+                            }
+                        }
+                    }
+                    if (compatible)
+                    {
+                        other.m_claimed = true;
+                        return &other;
+                    }
+                }
+            }
+            return nullptr;
+        }
+        Ref<RHI::IResource> RenderGraph::find_reusable_persistent_resource(usize resource, const Vector<CompiledState*>& former)
+        {
+            auto& node = m_desc.resources[resource];
+            auto& desc = m_resource_data[resource].m_resource_desc;
+            for (CompiledState* state : former)
+            {
+                auto& resources = state->m_compiled_desc.resources;
+                for (usize i = 0; i < resources.size(); ++i)
+                {
+                    // Resources without names can only be matched by indices.
+                    if (node.name ? !(resources[i].name == node.name) : i != resource) continue;
+                    auto& res = state->m_resource_data[i];
+                    if (resources[i].type != RenderGraphResourceType::persistent || !res.m_resource || 
+                        !equal_resource_desc(res.m_resource_desc, desc)) continue;
+                    // One resource cannot be used by two resources of the same graph.
+                    bool used = false;
+                    for (usize j = 0; j < resource; ++j)
+                    {
+                        if (m_resource_data[j].m_resource == res.m_resource)
+                        {
+                            used = true;
+                            break;
+                        }
+                    }
+                    if (!used) return res.m_resource;
+                }
+            }
+            return nullptr;
+        }
         RV RenderGraph::compile(const RenderGraphCompileConfig& config)
+        {
+            u64 begin_ticks = get_ticks();
+            m_compile_statistics = RenderGraphCompileStatistics();
+            u64 hash = hash_render_graph(m_desc, config);
+            auto is_same_graph = [&](const CompiledState& state)
+            {
+                return state.m_compiled && state.m_compiled_hash == hash &&
+                    state.m_enable_time_profiling == config.enable_time_profiling &&
+                    state.m_enable_parallel_recording == config.enable_parallel_recording &&
+                    equal_render_graph(state.m_compiled_desc, m_desc);
+            };
+            lutry
+            {
+                // Move the current compiled graph out, so that the current graph can be compiled from empty state.
+                CompiledState previous;
+                swap_compiled_state(previous);
+                if (!config.enable_incremental_compilation)
+                {
+                    m_compiled_graph_cache.clear();
+                }
+                else if (is_same_graph(previous))
+                {
+                    swap_compiled_state(previous);
+                    m_compile_statistics.cache_hit = true;
+                }
+                else
+                {
+                    for (auto iter = m_compiled_graph_cache.begin(); iter != m_compiled_graph_cache.end(); ++iter)
+                    {
+                        if (is_same_graph(*iter))
+                        {
+                            swap_compiled_state(*iter);
+                            m_compiled_graph_cache.erase(iter);
+                            m_compile_statistics.cache_hit = true;
+                            break;
+                        }
+                    }
+                }
+                if (!m_compile_statistics.cache_hit)
+                {
+                    Vector<CompiledState*> former;
+                    if (config.enable_incremental_compilation)
+                    {
+                        if (previous.m_compiled) former.push_back(&previous);
+                        for (auto& state : m_compiled_graph_cache) former.push_back(&state);
+                    }
+                    RV r = compile_graph(config, former);
+                    for (CompiledState* state : former)
+                    {
+                        for (auto& pass : state->m_pass_data) pass.m_claimed = false;
+                    }
+                    if (failed(r))
+                    {
+                        // Restore the former compiled graph.
+                        swap_compiled_state(previous);
+                        return r;
+                    }
+                    m_compiled_desc = m_desc;
+                    m_compiled_hash = hash;
+                    m_compiled = true;
+                }
+                // Keep external resources set for the former graph.
+                if (previous.m_compiled)
+                {
+                    auto& resources = previous.m_compiled_desc.resources;
+                    for (usize i = 0; i < m_desc.resources.size() && i < resources.size(); ++i)
+                    {
+                        if (m_desc.resources[i].type == RenderGraphResourceType::external && resources[i].type == RenderGraphResourceType::external &&
+                            m_desc.resources[i].name == resources[i].name && previous.m_resource_data[i].m_resource)
+                        {
+                            m_resource_data[i].m_resource = previous.m_resource_data[i].m_resource;
+                        }
+                    }
+                }
+                if (previous.m_compiled && config.enable_incremental_compilation && config.compiled_graph_cache_size)
+                {
+                    m_compiled_graph_cache.insert(m_compiled_graph_cache.begin(), move(previous));
+                }
+                while (m_compiled_graph_cache.size() > config.compiled_graph_cache_size)
+                {
+                    m_compiled_graph_cache.pop_back();
+                }
+                // Recreate time query heap.
+                if (m_enable_time_profiling)
+                {
+                    if (!m_time_query_heap || m_time_query_heap_capacity < m_num_enabled_passes)
+                    {
+                        RHI::QueryHeapDesc desc;
+                        desc.type = RHI::QueryType::timestamp;
+                        desc.count = m_num_enabled_passes * 2;
+                        luset(m_time_query_heap, m_device->new_query_heap(desc));
+                        m_time_query_heap_capacity = m_num_enabled_passes;
+                    }
+                }
+            }
+            lucatchret;
+            m_compile_statistics.compile_time = (f64)(get_ticks() - begin_ticks) / get_ticks_per_second();
+            return ok;
+        }
+        RV RenderGraph::compile_graph(const RenderGraphCompileConfig& config, const Vector<CompiledState*>& former)
         {
             lutry
             {
@@ -67,16 +804,20 @@ namespace Luna
                 m_resource_data.resize(m_desc.resources.size());
                 m_pass_data.clear();
                 m_pass_data.resize(m_desc.passes.size());
+                m_enabled_passes.clear();
                 m_enable_time_profiling = config.enable_time_profiling;
+                m_enable_parallel_recording = config.enable_parallel_recording;
                 Vector<ResourceTrackData> resource_track_data(m_resource_data.size());
                 // Initialize pass data and resource track data.
                 for (auto& i : m_desc.input_connections)
                 {
                     m_pass_data[i.pass].m_input_resources.insert(make_pair(i.parameter, i.resource));
+                    m_pass_data[i.pass].m_compile_inputs.push_back({ i.parameter, i.resource, false, ResourceDesc() });
                 }
                 for (auto& i : m_desc.output_connections)
                 {
                     m_pass_data[i.pass].m_output_resources.insert(make_pair(i.parameter, i.resource));
+                    m_pass_data[i.pass].m_compile_inputs.push_back({ i.parameter, i.resource, true, ResourceDesc() });
                     auto& res = resource_track_data[i.resource];
                     res.write_passes.push_back(i.pass);
                 }
@@ -138,26 +879,76 @@ namespace Luna
                     m_current_compile_pass = i;
                     if(m_pass_data[i].m_enabled)
                     {
+                        auto ctx = new_object<RenderPassContext>();
+                        ctx->m_graph = this;
+                        ctx->m_pass = i;
+                        ctx->m_time_query_index = num_enabled_passes;
+                        m_pass_data[i].m_context = ctx;
+                        m_enabled_passes.push_back(i);
                         ++num_enabled_passes;
-                        MutexGuard guard(g_render_pass_types_mtx);
-                        auto iter = g_render_pass_types.find(m_desc.passes[i].type);
-                        if(iter == g_render_pass_types.end())
+                        auto& pass = m_pass_data[i];
+                        pass.m_type = m_desc.passes[i].type;
+                        for (auto& input : pass.m_compile_inputs)
+                        {
+                            input.m_desc = m_resource_data[input.m_resource].m_resource_desc;
+                        }
+                        const PassData* reusable = config.enable_incremental_compilation ? find_reusable_pass(i, former) : nullptr;
+                        if (reusable)
                         {
-                            return set_error(BasicError::not_found(), "Render pass type \"%s\" is not found.", m_desc.passes[i].type.c_str());
+                            // Replay the compile result of the former pass on resources of this pass.
+                            pass.m_render_pass = reusable->m_render_pass;
+                            pass.m_compile_outputs = reusable->m_compile_outputs;
+                            for (usize k = 0; k < pass.m_compile_inputs.size(); ++k)
+                            {
+                                m_resource_data[pass.m_compile_inputs[k].m_resource].m_resource_desc = pass.m_compile_outputs[k];
+                            }
+                            for (auto& state : reusable->m_resource_states)
+                            {
+                                for (usize k = 0; k < reusable->m_compile_inputs.size(); ++k)
+                                {
+                                    if (reusable->m_compile_inputs[k].m_resource == state.first)
+                                    {
+                                        pass.m_resource_states.push_back(make_pair(pass.m_compile_inputs[k].m_resource, state.second));
+                                        break;
+                                    }
+                                }
+                            }
+                            ++m_compile_statistics.num_reused_passes;
+                        }
+                        else
+                        {
+                            {
+                                MutexGuard guard(g_render_pass_types_mtx);
+                                auto iter = g_render_pass_types.find(m_desc.passes[i].type);
+                                if(iter == g_render_pass_types.end())
+                                {
+                                    return set_error(BasicError::not_found(), "Render pass type \"%s\" is not found.", m_desc.passes[i].type.c_str());
+                                }
+                                luexp(iter->compile(iter->userdata.get(), this));
+                            }
+                            for (auto& input : pass.m_compile_inputs)
+                            {
+                                pass.m_compile_outputs.push_back(m_resource_data[input.m_resource].m_resource_desc);
+                            }
+                            ++m_compile_statistics.num_compiled_passes;
                         }
-                        luexp(iter->compile(iter->userdata.get(), this));
                     }
                 }
                 // Resolve transient resource lifetime.
                 for(usize i = 0; i < resource_track_data.size(); ++i)
                 {
                     auto& res = resource_track_data[i];
+                    m_resource_data[i].m_first_access = res.first_access;
+                    m_resource_data[i].m_last_access = res.last_access;
                     if(m_desc.resources[i].type == RenderGraphResourceType::transient && res.first_access != USIZE_MAX)
                     {
                         m_pass_data[resource_track_data[i].first_access].m_create_resources.push_back(i);
-                        m_pass_data[resource_track_data[i].last_access].m_release_resources.push_back(i);
                     }
                 }
+                assign_command_queues();
+                luexp(plan_transient_resources(former));
+                plan_barriers();
+                luexp(plan_async_compute());
                 // Create persistent resources.
                 for(usize i = 0; i < m_desc.resources.size(); ++i)
                 {
@@ -166,6 +957,16 @@ namespace Luna
                         auto& res = m_resource_data[i];
                         if(is_resource_desc_valid(res.m_resource_desc))
                         {
+                            if (config.enable_incremental_compilation)
+                            {
+                                res.m_resource = find_reusable_persistent_resource(i, former);
+                                if (res.m_resource)
+                                {
+                                    ++m_compile_statistics.num_reused_persistent_resources;
+                                    continue;
+                                }
+                            }
+                            ++m_compile_statistics.num_created_persistent_resources;
                             if (res.m_resource_desc.type == ResourceType::buffer)
                             {
                                 luset(res.m_resource, m_device->new_buffer(res.m_resource_desc.memory_type, res.m_resource_desc.buffer));
@@ -182,19 +983,9 @@ namespace Luna
                         }
                     }
                 }
-                // Recreate time query heap.
-                if (m_enable_time_profiling)
-                {
-                    if (!m_time_query_heap || m_time_query_heap_capacity < num_enabled_passes)
-                    {
-                        RHI::QueryHeapDesc desc;
-                        desc.type = RHI::QueryType::timestamp;
-                        desc.count = num_enabled_passes * 2;
-                        luset(m_time_query_heap, m_device->new_query_heap(desc));
-                        m_time_query_heap_capacity = num_enabled_passes;
-                    }
-                }
                 m_num_enabled_passes = num_enabled_passes;
+                m_record_results.clear();
+                m_record_results.resize(num_enabled_passes);
             }
             lucatchret;
             return ok;
@@ -210,61 +1001,131 @@ namespace Luna
                 }
             }
         }
+        RV RenderGraph::record_pass(usize pass, RHI::ICommandBuffer* cmdbuf)
+        {
+            lutry
+            {
+                auto& data = m_pass_data[pass];
+                for (usize h : data.m_create_resources)
+                {
+                    cmdbuf->attach_device_object(m_resource_data[h].m_resource);
+                }
+                submit_barriers(cmdbuf, data, m_barriers.data() + data.m_first_barrier, data.m_num_barriers);
+                RenderPassContext* ctx = data.m_context;
+                ctx->m_cmdbuf = cmdbuf;
+                if (m_desc.passes[pass].name) cmdbuf->begin_event(m_desc.passes[pass].name.c_str());
+                RV r = data.m_render_pass->execute(ctx);
+                if (m_desc.passes[pass].name) cmdbuf->end_event();
+                submit_barriers(cmdbuf, data, data.m_end_barriers.data(), data.m_end_barriers.size());
+                // Temporary resources are kept alive by the command buffer.
+                ctx->m_temporary_resources.clear();
+                ctx->m_temporary_memory.clear();
+                ctx->m_cmdbuf.reset();
+                luexp(r);
+            }
+            lucatchret;
+            return ok;
+        }
+        RV RenderGraph::prepare_command_buffer(FrameCommandBuffer& cmdbuf, u32 command_queue_index)
+        {
+            lutry
+            {
+                if (cmdbuf.m_cmdbuf && cmdbuf.m_cmdbuf->get_command_queue_index() != command_queue_index)
+                {
+                    if (cmdbuf.m_submitted) cmdbuf.m_cmdbuf->wait();
+                    cmdbuf.m_cmdbuf.reset();
+                    cmdbuf.m_submitted = false;
+                }
+                if (!cmdbuf.m_cmdbuf)
+                {
+                    luset(cmdbuf.m_cmdbuf, m_device->new_command_buffer(command_queue_index));
+                }
+                else if (cmdbuf.m_submitted)
+                {
+                    // The command buffer is submitted `NUM_FRAMES_IN_FLIGHT` executions before, which usually finishes already.
+                    cmdbuf.m_cmdbuf->wait();
+                    luexp(cmdbuf.m_cmdbuf->reset());
+                }
+                cmdbuf.m_submitted = false;
+            }
+            lucatchret;
+            return ok;
+        }
         RV RenderGraph::execute(RHI::ICommandBuffer* cmdbuf)
         {
             lutry
             {
-                m_transient_memory.clear();
-                m_cmdbuf = cmdbuf;
-                m_current_time_query_index = 0;
-                for(usize i = 0; i < m_pass_data.size(); ++i)
+                // Allocates transient resources of all passes before recording, so that resource objects
+                // can be read by all passes.
+                for (usize i : m_enabled_passes)
                 {
-                    auto& data = m_pass_data[i];
-                    if(!data.m_enabled) continue;
-                    // Allocates resources.
-                    Vector<RHI::BufferBarrier> buffer_barriers;
-                    Vector<RHI::TextureBarrier> texture_barriers;
-                    for(usize h : data.m_create_resources)
+                    for(usize h : m_pass_data[i].m_create_resources)
                     {
                         auto& res = m_resource_data[h];
-                        if(is_resource_desc_valid(res.m_resource_desc))
-                        {
-                            luset(res.m_resource, allocate_transient_resource(res.m_resource_desc));
-                            cmdbuf->attach_device_object(res.m_resource);
-                            if(m_desc.resources[h].name) res.m_resource->set_name(m_desc.resources[h].name.c_str());
-                        }
-                        else
-                        {
-                            return set_error(BasicError::bad_data(), "Cannot create transient resource %s because the resource layout is not specified.", m_desc.resources[h].name.c_str());
-                        }
-                        if (res.m_resource_desc.type == ResourceType::texture)
+                        luset(res.m_resource, create_transient_resource(h));
+                        if(m_desc.resources[h].name) res.m_resource->set_name(m_desc.resources[h].name.c_str());
+                    }
+                }
+                if (!m_enable_parallel_recording && m_async_compute_queue == U32_MAX)
+                {
+                    for (usize i : m_enabled_passes)
+                    {
+                        luexp(record_pass(i, cmdbuf));
+                    }
+                }
+                else
+                {
+                    u32 graphics_queue_index = cmdbuf->get_command_queue_index();
+                    m_frame_index = (m_frame_index + 1) % NUM_FRAMES_IN_FLIGHT;
+                    for (usize i : m_enabled_passes)
+                    {
+                        auto& data = m_pass_data[i];
+                        u32 command_queue_index = data.m_async_compute ? m_async_compute_queue : graphics_queue_index;
+                        luexp(prepare_command_buffer(data.m_cmdbufs[m_frame_index], command_queue_index));
+                    }
+                    if (m_enable_parallel_recording)
+                    {
+                        JobSystem::parallel_for(0, m_enabled_passes.size(), 1, [this](usize i)
                         {
-                            Ref<RHI::ITexture> tex = res.m_resource;
-                            texture_barriers.push_back({ tex, RHI::TEXTURE_BARRIER_ALL_SUBRESOURCES, RHI::TextureStateFlag::automatic, RHI::TextureStateFlag::none, RHI::ResourceBarrierFlag::aliasing });
-                        }
-                        else
+                            usize pass = m_enabled_passes[i];
+                            m_record_results[i] = record_pass(pass, m_pass_data[pass].m_cmdbufs[m_frame_index].m_cmdbuf);
+                        });
+                    }
+                    else
+                    {
+                        for (usize i = 0; i < m_enabled_passes.size(); ++i)
                         {
-                            Ref<RHI::IBuffer> buf = res.m_resource;
-                            buffer_barriers.push_back({ buf, RHI::BufferStateFlag::automatic, RHI::BufferStateFlag::none, RHI::ResourceBarrierFlag::aliasing });
+                            usize pass = m_enabled_passes[i];
+                            m_record_results[i] = record_pass(pass, m_pass_data[pass].m_cmdbufs[m_frame_index].m_cmdbuf);
                         }
                     }
-                    if (!buffer_barriers.empty() || !texture_barriers.empty()) cmdbuf->resource_barrier({ buffer_barriers.data(), buffer_barriers.size() }, {texture_barriers.data(), texture_barriers.size()});
-                    m_current_pass = i;
-                    if (m_desc.passes[i].name) cmdbuf->begin_event(m_desc.passes[i].name.c_str());
-                    luexp(m_pass_data[i].m_render_pass->execute(this));
-                    if (m_desc.passes[i].name) cmdbuf->end_event();
-                    for(auto& res : m_temporary_resources)
+                    for (auto& r : m_record_results)
                     {
-                        release_transient_resource(res);
+                        luexp(r);
                     }
-                    m_temporary_resources.clear();
-                    // Release resources.
-                    for(usize h : data.m_release_resources)
+                    // Commands recorded to `cmdbuf` by the user before this call must be executed before render passes.
+                    RHI::IFence* frame_begin_fence = m_frame_begin_fence.get();
+                    luexp(cmdbuf->submit({}, { &frame_begin_fence, (usize)(frame_begin_fence ? 1 : 0) }, true));
+                    // Command buffers in the same queue are executed in submission order, so barriers recorded
+                    // in every pass are still valid. Passes are submitted in execution order, so every fence is 
+                    // signaled before it is waited.
+                    for (usize i : m_enabled_passes)
                     {
-                        auto& res = m_resource_data[h];
-                        release_transient_resource(res.m_resource);
+                        auto& data = m_pass_data[i];
+                        auto& frame_cmdbuf = data.m_cmdbufs[m_frame_index];
+                        luexp(frame_cmdbuf.m_cmdbuf->submit({ data.m_wait_fences.data(), data.m_wait_fences.size() }, 
+                            { data.m_signal_fences.data(), data.m_signal_fences.size() }, true));
+                        frame_cmdbuf.m_submitted = true;
+                    }
+                    if (m_frame_end_fence)
+                    {
+                        // Blocks later graphics work until the last asynchronous compute pass is finished.
+                        auto& end_cmdbuf = m_frame_end_cmdbufs[m_frame_index];
+                        luexp(prepare_command_buffer(end_cmdbuf, graphics_queue_index));
+                        RHI::IFence* frame_end_fence = m_frame_end_fence.get();
+                        luexp(end_cmdbuf.m_cmdbuf->submit({ &frame_end_fence, 1 }, {}, true));
+                        end_cmdbuf.m_submitted = true;
                     }
-                    ++m_current_time_query_index;
                 }
             }
             lucatchret;
@@ -288,23 +1149,141 @@ namespace Luna
             lucatchret;
             return ok;
         }
-        R<Ref<RHI::IResource>> RenderGraph::allocate_temporary_resource(const ResourceDesc& desc)
+        //! Merges overlapping time intervals and returns the total length of merged intervals.
+        static u64 merge_time_intervals(Vector<Pair<u64, u64>>& intervals)
+        {
+            sort(intervals.begin(), intervals.end(), [](const Pair<u64, u64>& lhs, const Pair<u64, u64>& rhs) { return lhs.first < rhs.first; });
+            usize num_merged = 0;
+            u64 total = 0;
+            for (usize i = 0; i < intervals.size(); ++i)
+            {
+                if (num_merged && intervals[i].first <= intervals[num_merged - 1].second)
+                {
+                    intervals[num_merged - 1].second = max(intervals[num_merged - 1].second, intervals[i].second);
+                }
+                else
+                {
+                    intervals[num_merged] = intervals[i];
+                    ++num_merged;
+                }
+            }
+            intervals.resize(num_merged);
+            for (auto& i : intervals) total += i.second - i.first;
+            return total;
+        }
+        R<AsyncComputeStatistics> RenderGraph::get_async_compute_statistics()
+        {
+            AsyncComputeStatistics ret;
+            lutry
+            {
+                if (!m_enable_time_profiling || !m_num_enabled_passes) return ret;
+                Vector<u64> times((usize)m_num_enabled_passes * 2);
+                luexp(m_time_query_heap->get_timestamp_values(0, m_num_enabled_passes * 2, times.data()));
+                Vector<Pair<u64, u64>> graphics_intervals;
+                Vector<Pair<u64, u64>> compute_intervals;
+                for (usize i = 0; i < m_enabled_passes.size(); ++i)
+                {
+                    auto interval = make_pair(times[i * 2], times[i * 2 + 1]);
+                    if (m_pass_data[m_enabled_passes[i]].m_async_compute) compute_intervals.push_back(interval);
+                    else graphics_intervals.push_back(interval);
+                }
+                merge_time_intervals(graphics_intervals);
+                ret.async_compute_time = merge_time_intervals(compute_intervals);
+                // Intersects two sorted interval lists.
+                usize g = 0;
+                usize c = 0;
+                while (g < graphics_intervals.size() && c < compute_intervals.size())
+                {
+                    u64 begin = max(graphics_intervals[g].first, compute_intervals[c].first);
+                    u64 end = min(graphics_intervals[g].second, compute_intervals[c].second);
+                    if (begin < end) ret.overlapped_time += end - begin;
+                    if (graphics_intervals[g].second < compute_intervals[c].second) ++g;
+                    else ++c;
+                }
+            }
+            lucatchret;
+            return ret;
+        }
+        RHI::IResource* RenderPassContext::get_input(const Name& name)
         {
+            auto& data = m_graph->m_pass_data[m_pass];
+            auto iter = data.m_input_resources.find(name);
+            if(iter == data.m_input_resources.end()) return nullptr;
+            return m_graph->m_resource_data[iter->second].m_resource;
+        }
+        RHI::IResource* RenderPassContext::get_output(const Name& name)
+        {
+            auto& data = m_graph->m_pass_data[m_pass];
+            auto iter = data.m_output_resources.find(name);
+            if(iter == data.m_output_resources.end()) return nullptr;
+            return m_graph->m_resource_data[iter->second].m_resource;
+        }
+        RHI::IQueryHeap* RenderPassContext::get_timestamp_query_heap(u32* begin_index, u32* end_index)
+        {
+            if(m_graph->m_enable_time_profiling)
+            {
+                if(begin_index) *begin_index = m_time_query_index * 2;
+                if(end_index) *end_index = m_time_query_index * 2 + 1;
+                return m_graph->m_time_query_heap;
+            }
+            if(begin_index) *begin_index = 0;
+            if(end_index) *end_index = 0;
+            return nullptr;
+        }
+        R<Ref<RHI::IResource>> RenderPassContext::allocate_temporary_resource(const ResourceDesc& desc)
+        {
+            RHI::IDevice* device = m_graph->m_device;
             Ref<RHI::IResource> ret;
             lutry
             {
-                luset(ret, allocate_transient_resource(desc));
+                // Try to reuse one memory block released by this pass.
+                for (auto iter = m_temporary_memory.begin(); iter != m_temporary_memory.end(); ++iter)
+                {
+                    if (desc.type == ResourceType::texture)
+                    {
+                        auto r = device->new_aliasing_texture(*iter, desc.texture);
+                        if (succeeded(r)) ret = r.get();
+                    }
+                    else
+                    {
+                        auto r = device->new_aliasing_buffer(*iter, desc.buffer);
+                        if (succeeded(r)) ret = r.get();
+                    }
+                    if (ret)
+                    {
+                        m_temporary_memory.erase(iter);
+                        break;
+                    }
+                }
+                if (!ret)
+                {
+                    // Try to allocate one new block.
+                    if (desc.type == ResourceType::texture)
+                    {
+                        auto tex = desc.texture;
+                        tex.flags |= RHI::ResourceFlag::allow_aliasing;
+                        luset(ret, device->new_texture(desc.memory_type, tex));
+                    }
+                    else
+                    {
+                        auto buffer = desc.buffer;
+                        buffer.flags |= RHI::ResourceFlag::allow_aliasing;
+                        luset(ret, device->new_buffer(desc.memory_type, buffer));
+                    }
+                }
+                m_cmdbuf->attach_device_object(ret);
                 m_temporary_resources.push_back(ret);
             }
             lucatchret;
             return ret;
         }
-        void RenderGraph::release_temporary_resource(RHI::IResource* res)
+        void RenderPassContext::release_temporary_resource(RHI::IResource* res)
         {
             for(auto iter = m_temporary_resources.begin(); iter != m_temporary_resources.end(); ++iter)
             {
                 if(iter->get() == res)
                 {
+                    m_temporary_memory.push_back(res->get_memory());
                     m_temporary_resources.erase(iter);
                     return;
                 }
@@ -9,11 +9,40 @@
 */
 #pragma once
 #include "../RenderGraph.hpp"
+#include <Luna/Runtime/Mutex.hpp>
 namespace Luna
 {
     namespace RG
     {
-        struct RenderGraph : IRenderGraph, IRenderGraphCompiler, IRenderPassContext
+        struct RenderGraph;
+
+        // The execution context passed to one render pass. Every pass has its own context, so that 
+        // passes can be recorded by multiple threads at the same time.
+        struct RenderPassContext : IRenderPassContext
+        {
+            lustruct("RG::RenderPassContext", "{3b1e8c57-9d42-4f0a-a6e3-71c5d2b8f4a9}");
+            luiimpl();
+
+            // The render graph owns contexts, so use raw pointer here to prevent circular reference.
+            RenderGraph* m_graph;
+            usize m_pass;
+            u32 m_time_query_index;
+            Ref<RHI::ICommandBuffer> m_cmdbuf;
+            Vector<Ref<RHI::IResource>> m_temporary_resources;
+            // The memory blocks of released temporary resources, which can be reused by temporary resources of this pass.
+            // Every pass has its own blocks, so that memory is never reused by passes that may execute at the same time on 
+            // different command buffers or queues.
+            Vector<Ref<RHI::IDeviceMemory>> m_temporary_memory;
+
+            virtual RHI::ICommandBuffer* get_command_buffer() override { return m_cmdbuf; }
+            virtual RHI::IResource* get_input(const Name& name) override;
+            virtual RHI::IResource* get_output(const Name& name) override;
+            virtual RHI::IQueryHeap* get_timestamp_query_heap(u32* begin_index, u32* end_index) override;
+            virtual R<Ref<RHI::IResource>> allocate_temporary_resource(const ResourceDesc& desc) override;
+            virtual void release_temporary_resource(RHI::IResource* res) override;
+        };
+
+        struct RenderGraph : IRenderGraph, IRenderGraphCompiler
         {
             lustruct("RG::RenderGraph", "{feefd806-4b82-48cd-b350-f8fc9387fc65}");
             luiimpl();
@@ -21,95 +50,226 @@ namespace Luna
             Ref<RHI::IDevice> m_device;
             RenderGraphDesc m_desc;
 
+            // One resource connected to one pass, used to check whether the compile result of one pass can be reused.
+            struct PassCompileInput
+            {
+                Name m_parameter;
+                usize m_resource;
+                bool m_output;
+                // The resource descriptor before calling the compile callback.
+                ResourceDesc m_desc;
+            };
+            // The number of command buffers allocated for every pass when render passes are recorded to command buffers
+            // owned by the render graph. The command buffer of one execution is reused only after this number of executions, 
+            // so that the host does not wait for the last execution and executions of several frames can overlap.
+            static constexpr u32 NUM_FRAMES_IN_FLIGHT = 3;
+            // One command buffer owned by the render graph.
+            struct FrameCommandBuffer
+            {
+                Ref<RHI::ICommandBuffer> m_cmdbuf;
+                bool m_submitted = false;
+            };
+            // One resource barrier computed when compiling the render graph.
+            struct BarrierData
+            {
+                usize m_resource;
+                // `RHI::BufferStateFlag` or `RHI::TextureStateFlag` depending on the resource type.
+                u32 m_before;
+                u32 m_after;
+                RHI::ResourceBarrierFlag m_flags;
+            };
             // Produced by compiling the render graph.
             struct PassData
             {
                 HashMap<Name, usize> m_input_resources;
                 HashMap<Name, usize> m_output_resources;
-                // The indices of `m_transient_resources` that should be released when this node is finished.
+                // The pass type and connected resources before calling the compile callback.
+                Name m_type;
+                Vector<PassCompileInput> m_compile_inputs;
+                // The descriptors of resources in `m_compile_inputs` after calling the compile callback.
+                Vector<ResourceDesc> m_compile_outputs;
+                // The indices of transient resources that should be created when this node is started.
                 Vector<usize> m_create_resources;
-                Vector<usize> m_release_resources;
+                // The resource states declared by the render pass.
+                Vector<Pair<usize, u32>> m_resource_states;
+                // The range of `m_barriers` that should be submitted before this pass is executed.
+                usize m_first_barrier = 0;
+                usize m_num_barriers = 0;
+                // Barriers that should be submitted after this pass is executed. These transition resources from graphics-only 
+                // states to states used by later passes on the asynchronous compute queue, since command buffers of compute 
+                // queues cannot use graphics-only states.
+                Vector<BarrierData> m_end_barriers;
+                // Graphics queue passes whose end barriers transition resources for this pass.
+                Vector<usize> m_handoff_passes;
+                // Reserved when compiling so that barriers are submitted without allocating memory.
+                Vector<RHI::BufferBarrier> m_buffer_barriers;
+                Vector<RHI::TextureBarrier> m_texture_barriers;
                 Ref<IRenderPass> m_render_pass;
+                Ref<RenderPassContext> m_context;
+                // The command buffers used to record this pass in every frame in flight, if render passes are recorded to 
+                // command buffers owned by the render graph.
+                FrameCommandBuffer m_cmdbufs[NUM_FRAMES_IN_FLIGHT];
+                // Fences to wait before and signal after this pass is executed.
+                Vector<RHI::IFence*> m_wait_fences;
+                Vector<RHI::IFence*> m_signal_fences;
+                // Whether this pass is executed on the asynchronous compute queue.
+                bool m_async_compute = false;
                 bool m_enabled = false;
+                // Whether this pass of one former compiled graph is reused by the pass being compiled, so that one render 
+                // pass object is never shared by two passes. Cleared when the compilation ends.
+                bool m_claimed = false;
             };
             struct ResourceData
             {
                 ResourceDesc m_resource_desc;
                 Ref<RHI::IResource> m_resource;
+                // The index of the pass that accesses this resource firstly, or `USIZE_MAX` if this resource is not used.
+                usize m_first_access = USIZE_MAX;
+                // The index of the pass that accesses this resource lastly.
+                usize m_last_access = 0;
+                // The index of `m_transient_heaps` that stores this resource if this is one transient resource.
+                usize m_transient_heap = USIZE_MAX;
+                // Bit 0 is set if this resource is accessed by graphics queue passes, bit 1 is set if this resource is
+                // accessed by asynchronous compute queue passes.
+                u8 m_queue_mask = 0;
+            };
+            // One memory heap shared by transient resources whose lifetimes do not overlap.
+            struct TransientHeap
+            {
+                RHI::MemoryType m_memory_type;
+                // The queue mask of all resources placed in this heap.
+                u8 m_queue_mask;
+                // The indices of resources placed in this heap.
+                Vector<usize> m_resources;
+                u64 m_estimated_size = 0;
+                Ref<RHI::IDeviceMemory> m_memory;
             };
             Vector<PassData> m_pass_data;
+            Vector<BarrierData> m_barriers;
             Vector<ResourceData> m_resource_data;
-            bool m_enable_time_profiling;
+            Vector<TransientHeap> m_transient_heaps;
+            TransientMemoryStatistics m_transient_memory_statistics;
+            bool m_enable_time_profiling = false;
+            bool m_enable_parallel_recording = false;
+            // The command queue used by asynchronous compute passes, or `U32_MAX` if no async compute pass is used.
+            u32 m_async_compute_queue = U32_MAX;
+            // Cross-queue fences used by passes.
+            Vector<Ref<RHI::IFence>> m_fences;
+            // Signaled by the graphics queue before the first pass and waited by the first asynchronous compute pass, so that
+            // asynchronous compute passes do not overwrite resources still used by graphics work submitted before, including
+            // graphics passes of the last execution.
+            Ref<RHI::IFence> m_frame_begin_fence;
+            // Signaled by the last asynchronous compute pass and waited by the graphics queue after the last pass, so that 
+            // graphics work submitted after the execution, including passes of the next execution, sees writes of 
+            // asynchronous compute passes.
+            Ref<RHI::IFence> m_frame_end_fence;
 
             Ref<RHI::IQueryHeap> m_time_query_heap;
             u32 m_time_query_heap_capacity = 0;
-            u32 m_current_time_query_index = 0;
-            u32 m_num_enabled_passes;
+            u32 m_num_enabled_passes = 0;
+            Vector<usize> m_enabled_passes;
 
             // Compile context.
             usize m_current_compile_pass;
 
+            // The descriptor and configuration used to compile the current graph.
+            RenderGraphDesc m_compiled_desc;
+            u64 m_compiled_hash = 0;
+            bool m_compiled = false;
+            // One compiled graph that is not being used. This stores all members produced by compiling the 
+            // render graph, see `swap_compiled_state`.
+            struct CompiledState
+            {
+                RenderGraphDesc m_compiled_desc;
+                u64 m_compiled_hash = 0;
+                bool m_compiled = false;
+                bool m_enable_time_profiling = false;
+                bool m_enable_parallel_recording = false;
+                Vector<PassData> m_pass_data;
+                Vector<BarrierData> m_barriers;
+                Vector<ResourceData> m_resource_data;
+                Vector<TransientHeap> m_transient_heaps;
+                TransientMemoryStatistics m_transient_memory_statistics;
+                u32 m_async_compute_queue = U32_MAX;
+                Vector<Ref<RHI::IFence>> m_fences;
+                Ref<RHI::IFence> m_frame_begin_fence;
+                Ref<RHI::IFence> m_frame_end_fence;
+                u32 m_num_enabled_passes = 0;
+                Vector<usize> m_enabled_passes;
+                Vector<RV> m_record_results;
+            };
+            // Former compiled graphs, the most recently used graph comes first.
+            Vector<CompiledState> m_compiled_graph_cache;
+            RenderGraphCompileStatistics m_compile_statistics;
+            // Exchanges the current compiled graph with `state`.
+            void swap_compiled_state(CompiledState& state)
+            {
+                swap(m_compiled_desc, state.m_compiled_desc);
+                swap(m_compiled_hash, state.m_compiled_hash);
+                swap(m_compiled, state.m_compiled);
+                swap(m_enable_time_profiling, state.m_enable_time_profiling);
+                swap(m_enable_parallel_recording, state.m_enable_parallel_recording);
+                m_pass_data.swap(state.m_pass_data);
+                m_barriers.swap(state.m_barriers);
+                m_resource_data.swap(state.m_resource_data);
+                m_transient_heaps.swap(state.m_transient_heaps);
+                swap(m_transient_memory_statistics, state.m_transient_memory_statistics);
+                swap(m_async_compute_queue, state.m_async_compute_queue);
+                m_fences.swap(state.m_fences);
+                swap(m_frame_begin_fence, state.m_frame_begin_fence);
+                swap(m_frame_end_fence, state.m_frame_end_fence);
+                swap(m_num_enabled_passes, state.m_num_enabled_passes);
+                m_enabled_passes.swap(state.m_enabled_passes);
+                m_record_results.swap(state.m_record_results);
+            }
+            // Compiles the current descriptor. `former` are compiled graphs whose results can be reused.
+            RV compile_graph(const RenderGraphCompileConfig& config, const Vector<CompiledState*>& former);
+            // Finds one pass in former compiled graphs whose compile result can be reused by the specified pass, and marks 
+            // the found pass as claimed.
+            const PassData* find_reusable_pass(usize pass, const Vector<CompiledState*>& former);
+            // Finds one persistent resource in former compiled graphs that can be reused by the specified resource.
+            Ref<RHI::IResource> find_reusable_persistent_resource(usize resource, const Vector<CompiledState*>& former);
+
             // Execution context.
-            Ref<RHI::ICommandBuffer> m_cmdbuf;
-            Vector<Ref<RHI::IResource>> m_temporary_resources;
-            usize m_current_pass;
+            // The recording result of every enabled pass when passes are recorded in parallel.
+            Vector<RV> m_record_results;
+            // The index of command buffers in `PassData::m_cmdbufs` used by the current execution.
+            u32 m_frame_index = 0;
+            // The command buffers submitted to the graphics queue after all passes to wait for `m_frame_end_fence`.
+            FrameCommandBuffer m_frame_end_cmdbufs[NUM_FRAMES_IN_FLIGHT];
+            // Prepares one command buffer owned by the render graph for recording. This waits for the command buffer 
+            // only if it is submitted and still being executed.
+            RV prepare_command_buffer(FrameCommandBuffer& cmdbuf, u32 command_queue_index);
 
-            Vector<Ref<RHI::IDeviceMemory>> m_transient_memory;
-            R<Ref<RHI::IResource>> allocate_transient_resource(const ResourceDesc& desc)
+            // Assigns transient resources to heaps and allocates heap memory. Memory of heaps in `former` compiled
+            // graphs that hold the same resources is reused.
+            RV plan_transient_resources(const Vector<CompiledState*>& former);
+            // Selects command queues for passes.
+            void assign_command_queues();
+            // Computes fences between passes of different queues.
+            RV plan_async_compute();
+            // Computes resource barriers between passes from resource states declared by passes.
+            void plan_barriers();
+            // Submits barriers computed by `plan_barriers` for the specified pass.
+            void submit_barriers(RHI::ICommandBuffer* cmdbuf, PassData& pass, const BarrierData* barriers, usize num_barriers);
+            // Records commands of the specified pass to the command buffer.
+            RV record_pass(usize pass, RHI::ICommandBuffer* cmdbuf);
+            // Creates one transient resource in its planned heap.
+            R<Ref<RHI::IResource>> create_transient_resource(usize resource)
             {
-                // Try to reuse one memory block.
-                Ref<RHI::IResource> ret;
-                auto iter = m_transient_memory.begin();
-                while (iter != m_transient_memory.end())
-                {
-                    if (desc.type == ResourceType::texture)
-                    {
-                        auto r = m_device->new_aliasing_texture(*iter, desc.texture);
-                        if (succeeded(r))
-                        {
-                            ret = r.get();
-                            m_transient_memory.erase(iter);
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        auto r = m_device->new_aliasing_buffer(*iter, desc.buffer);
-                        if (succeeded(r))
-                        {
-                            ret = r.get();
-                            m_transient_memory.erase(iter);
-                            break;
-                        }
-                    }
-                    ++iter;
-                }
-                if (!ret)
+                auto& res = m_resource_data[resource];
+                RHI::IDeviceMemory* memory = m_transient_heaps[res.m_transient_heap].m_memory;
+                if (res.m_resource_desc.type == ResourceType::texture)
                 {
-                    // Try to allocate one new block.
-                    if (desc.type == ResourceType::texture)
-                    {
-                        auto tex = desc.texture;
-                        tex.flags |= RHI::ResourceFlag::allow_aliasing;
-                        auto r = m_device->new_texture(desc.memory_type, tex);
-                        if (failed(r)) return r.errcode();
-                        ret = r.get();
-                    }
-                    else
-                    {
-                        auto buffer = desc.buffer;
-                        buffer.flags |= RHI::ResourceFlag::allow_aliasing;
-                        auto r = m_device->new_buffer(desc.memory_type, buffer);
-                        if (failed(r)) return r.errcode();
-                        ret = r.get();
-                    }
+                    auto r = m_device->new_aliasing_texture(memory, res.m_resource_desc.texture);
+                    if (failed(r)) return r.errcode();
+                    return Ref<RHI::IResource>(r.get());
                 }
-                return ret;
-            }
-            void release_transient_resource(RHI::IResource* resource)
-            {
-                m_transient_memory.push_back(resource->get_memory());
+                auto r = m_device->new_aliasing_buffer(memory, res.m_resource_desc.buffer);
+                if (failed(r)) return r.errcode();
+                return Ref<RHI::IResource>(r.get());
             }
+
             virtual RHI::IDevice* get_device() override { return m_device.get(); }
             virtual const RenderGraphDesc& get_desc() override { return m_desc; }
             virtual void set_desc(const RenderGraphDesc& desc) override { m_desc = desc; }
@@ -136,6 +296,9 @@ namespace Luna
                 return nullptr;
             }
             virtual RV get_pass_time_intervals(Vector<u64>& pass_time_intervals) override;
+            virtual TransientMemoryStatistics get_transient_memory_statistics() override { return m_transient_memory_statistics; }
+            virtual R<AsyncComputeStatistics> get_async_compute_statistics() override;
+            virtual RenderGraphCompileStatistics get_compile_statistics() override { return m_compile_statistics; }
 
             virtual usize get_input_resource(const Name& name) override
             {
@@ -166,38 +329,16 @@ namespace Luna
             {
                 m_pass_data[m_current_compile_pass].m_render_pass = render_pass;
             }
-
-            virtual RHI::ICommandBuffer* get_command_buffer() override { return m_cmdbuf; }
-            virtual RHI::IResource* get_input(const Name& name) override
-            {
-                auto& data = m_pass_data[m_current_pass];
-                auto iter = data.m_input_resources.find(name);
-                if(iter == data.m_input_resources.end()) return nullptr;
-                auto h = iter->second;
-                return m_resource_data[h].m_resource;
-            }
-            virtual RHI::IResource* get_output(const Name& name) override
+            virtual void set_buffer_state(usize resource, RHI::BufferStateFlag state) override
             {
-                auto& data = m_pass_data[m_current_pass];
-                auto iter = data.m_output_resources.find(name);
-                if(iter == data.m_output_resources.end()) return nullptr;
-                auto h = iter->second;
-                return m_resource_data[h].m_resource;
+                lucheck(resource < m_resource_data.size() && state != RHI::BufferStateFlag::automatic);
+                m_pass_data[m_current_compile_pass].m_resource_states.push_back(make_pair(resource, (u32)state));
             }
-            virtual RHI::IQueryHeap* get_timestamp_query_heap(u32* begin_index, u32* end_index) override
+            virtual void set_texture_state(usize resource, RHI::TextureStateFlag state) override
             {
-                if(m_enable_time_profiling)
-                {
-                    if(begin_index) *begin_index = m_current_time_query_index * 2;
-                    if(end_index) *end_index = m_current_time_query_index * 2 + 1;
-                    return m_time_query_heap;
-                }
-                if(begin_index) *begin_index = 0;
-                if(end_index) *end_index = 0;
-                return nullptr;
+                lucheck(resource < m_resource_data.size() && state != RHI::TextureStateFlag::automatic);
+                m_pass_data[m_current_compile_pass].m_resource_states.push_back(make_pair(resource, (u32)state));
             }
-            virtual R<Ref<RHI::IResource>> allocate_temporary_resource(const ResourceDesc& desc) override;
-            virtual void release_temporary_resource(RHI::IResource* res) override;
         };
     }
 }
@@ -462,6 +462,46 @@ namespace Luna
                 size(size),
                 format(format) {}
         };
+        //! The argument structure read by @ref ICommandBuffer::draw_indirect for every draw.
+        //! @details The layout of this structure matches the layout required by all backends, so it can be written directly
+        //! by shaders.
+        struct DrawIndirectArguments
+        {
+            //! The number of vertices to draw for every instance.
+            u32 vertex_count_per_instance;
+            //! The number of instances to draw.
+            u32 instance_count;
+            //! The position of the first vertex to draw.
+            u32 start_vertex_location;
+            //! The index of the first instance to draw.
+            u32 start_instance_location;
+        };
+        //! The argument structure read by @ref ICommandBuffer::draw_indexed_indirect for every draw.
+        //! @details The layout of this structure matches the layout required by all backends, so it can be written directly
+        //! by shaders.
+        struct DrawIndexedIndirectArguments
+        {
+            //! The number of indices to draw for every instance.
+            u32 index_count_per_instance;
+            //! The number of instances to draw.
+            u32 instance_count;
+            //! The position of the first index to draw.
+            u32 start_index_location;
+            //! The offset added to all indices before dereferring vertex data.
+            i32 base_vertex_location;
+            //! The index of the first instance to draw.
+            u32 start_instance_location;
+        };
+        //! The argument structure read by @ref ICommandBuffer::dispatch_indirect.
+        struct DispatchIndirectArguments
+        {
+            //! The number of thread groups to emit in the first dimension.
+            u32 thread_group_count_x;
+            //! The number of thread groups to emit in the second dimension.
+            u32 thread_group_count_y;
+            //! The number of thread groups to emit in the third dimension.
+            u32 thread_group_count_z;
+        };
         //! @interface ICommandBuffer
         //! Used to allocate memory for commands, record commands, submitting 
         //! commands to GPU and tracks the state of the submitted commands.
@@ -520,6 +560,10 @@ namespace Luna
             //! * draw_indexed
             //! * draw_instanced
             //! * draw_indexed_instanced
+            //! * draw_indirect
+            //! * draw_indexed_indirect
+            //! * draw_indirect_count
+            //! * draw_indexed_indirect_count
             //! * clear_color_attachment
             //! * clear_depth_stencil_attachment
             //! 
@@ -634,6 +678,66 @@ namespace Luna
             //! Instance data in range [`start_instance_location`, `start_instance_location + instance_count`) will be used.
             virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
                 i32 base_vertex_location, u32 start_instance_location) = 0;
+
+            //! Draws non-indexed, instanced primitives using arguments stored in one buffer.
+            //! @param[in] buffer The buffer that stores @ref DrawIndirectArguments for every draw.
+            //! @param[in] offset The offset, in bytes, of the first argument structure in `buffer`.
+            //! @param[in] draw_count The number of draws to execute.
+            //! @param[in] stride The distance, in bytes, between two adjacent argument structures in `buffer`.
+            //! @par Valid Usage
+            //! * `buffer` must be created with @ref BufferUsageFlag::indirect_buffer, and must be in 
+            //! @ref BufferStateFlag::indirect_argument state when the command is executed.
+            //! * `offset` must be a multiple of 4.
+            //! * `stride` must be a multiple of 4 and not smaller than `sizeof(DrawIndirectArguments)`.
+            //! * If @ref DeviceFeature::multi_draw_indirect is not supported, `draw_count` must be 0 or 1.
+            virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride = sizeof(DrawIndirectArguments)) = 0;
+
+            //! Draws indexed, instanced primitives using arguments stored in one buffer.
+            //! @param[in] buffer The buffer that stores @ref DrawIndexedIndirectArguments for every draw.
+            //! @param[in] offset The offset, in bytes, of the first argument structure in `buffer`.
+            //! @param[in] draw_count The number of draws to execute.
+            //! @param[in] stride The distance, in bytes, between two adjacent argument structures in `buffer`.
+            //! @par Valid Usage
+            //! * `buffer` must be created with @ref BufferUsageFlag::indirect_buffer, and must be in 
+            //! @ref BufferStateFlag::indirect_argument state when the command is executed.
+            //! * `offset` must be a multiple of 4.
+            //! * `stride` must be a multiple of 4 and not smaller than `sizeof(DrawIndexedIndirectArguments)`.
+            //! * If @ref DeviceFeature::multi_draw_indirect is not supported, `draw_count` must be 0 or 1.
+            virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride = sizeof(DrawIndexedIndirectArguments)) = 0;
+
+            //! Draws non-indexed, instanced primitives using arguments and the draw count stored in buffers.
+            //! @details The number of draws executed is the minimum of the `u32` value read from `count_buffer` and `max_draw_count`.
+            //! @param[in] buffer The buffer that stores @ref DrawIndirectArguments for every draw.
+            //! @param[in] offset The offset, in bytes, of the first argument structure in `buffer`.
+            //! @param[in] count_buffer The buffer that stores the draw count.
+            //! @param[in] count_buffer_offset The offset, in bytes, of the draw count in `count_buffer`.
+            //! @param[in] max_draw_count The maximum number of draws to execute.
+            //! @param[in] stride The distance, in bytes, between two adjacent argument structures in `buffer`.
+            //! @par Valid Usage
+            //! * @ref DeviceFeature::draw_indirect_count must be supported.
+            //! * `buffer` and `count_buffer` must be created with @ref BufferUsageFlag::indirect_buffer, and must be in 
+            //! @ref BufferStateFlag::indirect_argument state when the command is executed.
+            //! * `offset` and `count_buffer_offset` must be multiples of 4.
+            //! * `stride` must be a multiple of 4 and not smaller than `sizeof(DrawIndirectArguments)`.
+            virtual void draw_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+                u32 max_draw_count, u32 stride = sizeof(DrawIndirectArguments)) = 0;
+
+            //! Draws indexed, instanced primitives using arguments and the draw count stored in buffers.
+            //! @details The number of draws executed is the minimum of the `u32` value read from `count_buffer` and `max_draw_count`.
+            //! @param[in] buffer The buffer that stores @ref DrawIndexedIndirectArguments for every draw.
+            //! @param[in] offset The offset, in bytes, of the first argument structure in `buffer`.
+            //! @param[in] count_buffer The buffer that stores the draw count.
+            //! @param[in] count_buffer_offset The offset, in bytes, of the draw count in `count_buffer`.
+            //! @param[in] max_draw_count The maximum number of draws to execute.
+            //! @param[in] stride The distance, in bytes, between two adjacent argument structures in `buffer`.
+            //! @par Valid Usage
+            //! * @ref DeviceFeature::draw_indirect_count must be supported.
+            //! * `buffer` and `count_buffer` must be created with @ref BufferUsageFlag::indirect_buffer, and must be in 
+            //! @ref BufferStateFlag::indirect_argument state when the command is executed.
+            //! * `offset` and `count_buffer_offset` must be multiples of 4.
+            //! * `stride` must be a multiple of 4 and not smaller than `sizeof(DrawIndexedIndirectArguments)`.
+            virtual void draw_indexed_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+                u32 max_draw_count, u32 stride = sizeof(DrawIndexedIndirectArguments)) = 0;
             
             //! Starts one occlusion query.
             //! @param[in] mode The working mode of the new occlusion query.
@@ -657,6 +761,7 @@ namespace Luna
             //! * set_compute_descriptor_set
             //! * set_compute_descriptor_sets
             //! * dispatch
+            //! * dispatch_indirect
             //! @param[in] desc The compute pass descriptor.
             virtual void begin_compute_pass(const ComputePassDesc& desc = ComputePassDesc()) = 0;
 
@@ -691,6 +796,14 @@ namespace Luna
             //! @param[in] thread_group_count_z The number of thread groups to emit in the third dimension.
             virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) = 0;
 
+            //! Dispatches one compute task using arguments stored in one buffer.
+            //! @param[in] buffer The buffer that stores one @ref DispatchIndirectArguments.
+            //! @param[in] offset The offset, in bytes, of the argument structure in `buffer`. This must be a multiple of 4.
+            //! @par Valid Usage
+            //! * `buffer` must be created with @ref BufferUsageFlag::indirect_buffer, and must be in 
+            //! @ref BufferStateFlag::indirect_argument state when the command is executed.
+            virtual void dispatch_indirect(IBuffer* buffer, u64 offset) = 0;
+
             //! Ends a compute pass.
             virtual void end_compute_pass() = 0;
 
@@ -797,6 +910,12 @@ namespace Luna
             //! from host side. If this is `false`, the command buffer cannot be waited from host, and the behavior of 
             //! calling @ref ICommandBuffer::wait is undefined. Setting this to `false` may improve queue performance, and 
             //! the command buffer can still be waited by other command buffers using fences.
+            //! @param[in] wait_values The values to wait for timeline fences in `wait_fences`. If not empty, this must have the 
+            //! same size as `wait_fences`, and the value at index `i` is used if `wait_fences[i]` is a timeline fence. Values for 
+            //! binary fences are ignored.
+            //! @param[in] signal_values The values to signal for timeline fences in `signal_fences`. If not empty, this must have the 
+            //! same size as `signal_fences`, and the value at index `i` is used if `signal_fences[i]` is a timeline fence. Values for 
+            //! binary fences are ignored.
             //! 
             //! @remark Command buffers submitted to the same command queue are processed by their submission order without overlapping, so
             //! that one command buffer will not be executed until all previous command buffers in the same command queue are 
@@ -804,7 +923,10 @@ namespace Luna
             //! 
             //! If `signal_fences` is not empty, the system guarantees that all commands in the submission is finished, and all 
             //! writes to the memory in the submission is made visible before fences are signaled.
-            virtual RV submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting) = 0;
+            //! @par Valid Usage
+            //! * If `wait_fences` or `signal_fences` contains timeline fences, `wait_values` or `signal_values` must not be empty.
+            virtual RV submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+                Span<const u64> wait_values = {}, Span<const u64> signal_values = {}) = 0;
         };
 
         //! @}
@@ -315,6 +315,18 @@ namespace Luna
             }
         };
 
+        //! Specifies additional flags for one descriptor set.
+        enum class DescriptorSetFlag : u8
+        {
+            none = 0,
+            //! This descriptor set is only used for a short time, like one frame.
+            //! @details Transient descriptor sets are allocated from transient descriptor pools, which do not free descriptor sets
+            //! individually, but recycle all descriptor sets in bulk once all descriptor sets allocated from the pool are released. 
+            //! This makes allocating and releasing descriptor sets faster, but keeping one transient descriptor set alive for a 
+            //! long time prevents the whole pool from being recycled. This flag may be ignored by backends that do not use descriptor pools.
+            transient = 0x01,
+        };
+
         //! Describes one descriptor set.
         struct DescriptorSetDesc
         {
@@ -324,11 +336,38 @@ namespace Luna
             //! set, this is the number of variable descriptors being allocated for this else.
             //! Otherwise, this should always be 0.
             u32 num_variable_descriptors = 0;
+            //! Additional flags for this descriptor set.
+            DescriptorSetFlag flags = DescriptorSetFlag::none;
 
             DescriptorSetDesc() {}
-            DescriptorSetDesc(IDescriptorSetLayout* layout, u32 num_variable_descriptors = 0) :
+            DescriptorSetDesc(IDescriptorSetLayout* layout, u32 num_variable_descriptors = 0, DescriptorSetFlag flags = DescriptorSetFlag::none) :
                 layout(layout),
-                num_variable_descriptors(num_variable_descriptors) {}
+                num_variable_descriptors(num_variable_descriptors),
+                flags(flags) {}
+        };
+
+        //! Describes descriptor set allocation statistics of one device.
+        struct DescriptorPoolStatistics
+        {
+            //! The number of descriptor pools created by the device.
+            u32 num_pools = 0;
+            //! The number of descriptor pools used for transient descriptor sets.
+            u32 num_transient_pools = 0;
+            //! The number of descriptor sets that are not released.
+            u64 num_allocated_sets = 0;
+            //! The maximum number of descriptor sets that can be allocated from all descriptor pools.
+            u64 max_sets = 0;
+            //! The number of allocations that fail because the free space of one pool is fragmented, 
+            //! in which case the descriptor set is allocated from another pool.
+            u64 num_fragmented_allocations = 0;
+            //! The number of allocations that fail because one pool runs out of memory, 
+            //! in which case the descriptor set is allocated from another pool.
+            u64 num_pool_overflows = 0;
+            //! The total number of descriptor sets allocated.
+            u64 num_allocations = 0;
+            //! The total CPU time used to allocate descriptor sets, in seconds. 
+            //! The allocation throughput can be computed by dividing `num_allocations` with this.
+            f64 allocation_time = 0.0;
         };
 
         //! Describes one descriptor set write operation.
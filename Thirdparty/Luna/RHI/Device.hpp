@@ -16,6 +16,8 @@
 #include "Fence.hpp"
 #include "QueryHeap.hpp"
 #include "Adapter.hpp"
+#include <Luna/Runtime/Blob.hpp>
+#include <Luna/Runtime/Path.hpp>
 
 #ifndef LUNA_RHI_API
 #define LUNA_RHI_API
@@ -37,6 +39,14 @@ namespace Luna
             pixel_shader_write,
             //! The alignment requiremtn for the buffer data start location and size.
             uniform_buffer_data_alignment,
+            //! Allow @ref ICommandBuffer::draw_indirect and @ref ICommandBuffer::draw_indexed_indirect to
+            //! be called with `draw_count` greater than 1.
+            multi_draw_indirect,
+            //! Allow @ref ICommandBuffer::draw_indirect_count and @ref ICommandBuffer::draw_indexed_indirect_count
+            //! to be called.
+            draw_indirect_count,
+            //! Allow @ref FenceType::timeline to be used when creating fences.
+            timeline_fence,
         };
 
         //! Represents the device feature check result.
@@ -50,6 +60,12 @@ namespace Luna
                 bool pixel_shader_write;
                 //! The feature check result of @ref DeviceFeature::uniform_buffer_data_alignment.
                 u32 uniform_buffer_data_alignment;
+                //! The feature check result of @ref DeviceFeature::multi_draw_indirect.
+                bool multi_draw_indirect;
+                //! The feature check result of @ref DeviceFeature::draw_indirect_count.
+                bool draw_indirect_count;
+                //! The feature check result of @ref DeviceFeature::timeline_fence.
+                bool timeline_fence;
             };
         };
 
@@ -186,6 +202,10 @@ namespace Luna
             //! @param[in] desc The descriptor object.
             //! @return Returns the created descriptor set object.
             virtual R<Ref<IDescriptorSet>> new_descriptor_set(const DescriptorSetDesc& desc) = 0;
+            //! Gets descriptor set allocation statistics of the device.
+            //! @return Returns descriptor set allocation statistics. Returns zero statistics if the backend does not use 
+            //! descriptor pools.
+            virtual DescriptorPoolStatistics get_descriptor_pool_statistics() = 0;
 
             //! Gets the number of command queues of the device.
             //! @return Returns the number of command queues of the device.
@@ -220,8 +240,11 @@ namespace Luna
             virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) = 0;
 
             //! Creates one new fence that can be used to synchronize execution of multiple command buffers.
+            //! @param[in] type The fence type.
             //! @return Returns the created fence object.
-            virtual R<Ref<IFence>> new_fence() = 0;
+            //! Returns @ref BasicError::not_supported if `type` is @ref FenceType::timeline and @ref DeviceFeature::timeline_fence 
+            //! is not supported.
+            virtual R<Ref<IFence>> new_fence(FenceType type = FenceType::binary) = 0;
 
             //! Creates one swap chain and binds it to the specified window.
             //! @param[in] command_queue_index The command queue attached to the swap chain. Present commands will only be 
@@ -233,6 +256,23 @@ namespace Luna
             //! * `command_queue_index` must be in range [`0`, `get_num_command_queues()`).
             //! * The swap chain specified by `command_queue_index` must have @ref CommandQueueFlag::presenting being set.
             virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) = 0;
+
+            //! Gets the pipeline cache data of the device.
+            //! @details The pipeline cache stores compiled results of pipeline states created by this device. The data can be 
+            //! stored and passed to @ref load_pipeline_cache_data in later runs, so that pipeline states can be created without
+            //! compiling shaders again.
+            //! @return Returns the pipeline cache data. Returns one empty blob if the backend does not support pipeline caches.
+            virtual R<Blob> get_pipeline_cache_data() = 0;
+
+            //! Merges pipeline cache data returned by @ref get_pipeline_cache_data into the pipeline cache of the device.
+            //! @details Data produced by another adapter or another driver version is ignored. The data is also ignored if 
+            //! the backend does not support pipeline caches.
+            //! @param[in] data The pipeline cache data to load.
+            //! @par Possible Errors:
+            //! * BasicError::bad_data if the data is corrupted.
+            //! @par Valid Usage
+            //! * This must not be called when pipeline states are being created by other threads.
+            virtual RV load_pipeline_cache_data(Span<const byte_t> data) = 0;
         };
 
         //! Creates one device using the specified adapter.
@@ -243,6 +283,18 @@ namespace Luna
         //! Gets the main device of the platform.
         //! @return Returns the main device of the platform.
         LUNA_RHI_API IDevice* get_main_device();
+        //! Loads pipeline cache data from one file and merges the data into the pipeline cache of the device.
+        //! @details This should be called once after the device is created and before pipeline states are created.
+        //! @param[in] device The device to load pipeline cache data to.
+        //! @param[in] path The VFS path of the pipeline cache file. 
+        //! If the file does not exist, this function does nothing and succeeds.
+        LUNA_RHI_API RV load_pipeline_cache(IDevice* device, const Path& path);
+        //! Saves pipeline cache data of the device to one file.
+        //! @details This should be called before the application exits so that pipeline states compiled in this run 
+        //! can be reused by later runs.
+        //! @param[in] device The device whose pipeline cache data is saved.
+        //! @param[in] path The VFS path of the pipeline cache file. The file will be overwritten if it exists.
+        LUNA_RHI_API RV save_pipeline_cache(IDevice* device, const Path& path);
 
         //! @}
     }
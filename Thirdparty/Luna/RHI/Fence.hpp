@@ -16,6 +16,22 @@ namespace Luna
         //! @addtogroup RHI
         //! @{
         
+        //! Specifies the fence type.
+        enum class FenceType : u8
+        {
+            //! The fence has two states: signaled and unsignaled. Signal operations and wait operations on the fence 
+            //! must occur in discrete 1:1 pairs.
+            binary = 0,
+            //! The fence holds one 64-bit unsigned integer value that increases monotonically. Every signal operation sets the 
+            //! fence value to the specified value, and every wait operation waits until the fence value is greater than or equal
+            //! to the specified value. The fence value can also be waited, queried and signaled from host.
+            //! 
+            //! The fence value is 0 when the fence is created.
+            //! 
+            //! This fence type is available only if @ref DeviceFeature::timeline_fence is supported.
+            timeline = 1,
+        };
+
         //! @interface IFence
         //! Represents a synchronization object that can be used to synchronize commands executed in different command queues.
         //! @details A fence is a synchronization primitive that can be used to insert a dependency between queue operations. 
@@ -24,16 +40,40 @@ namespace Luna
         //! processes the operation, it will signal all signal targets, so that other operations waiting on these fences can be 
         //! processed.
         //! 
-        //! Every fence has two states: signaled and unsignaled. The fence state is managed by the device automatically, 
+        //! For binary fences, every fence has two states: signaled and unsignaled. The fence state is managed by the device automatically, 
         //! one fence is created in unsignaled state, every signal operation changes the fence state from unsignaled to 
         //! signaled, and every wait operation resets the fence state to unsignaled. To use fence objects properly,
         //! the user must ensure that signal operations and wait operations on the same fence should occur in discrete 1:1 pairs 
         //! (every two signal operations should have one wait operations in between, every two wait operations should one signal 
         //! operations in between).
+        //! 
+        //! For timeline fences, the value to wait or signal is specified for every fence when submitting command buffers, and 
+        //! one signaled value can be waited by any number of wait operations. This can be used to limit the number of frames in 
+        //! flight with one fence: signal value `N` when submitting frame `N`, and wait for value `N - M` from host before recording 
+        //! frame `N`, where `M` is the maximum number of frames in flight.
         struct IFence : virtual IDeviceChild
         {
             luiid("{126700A9-A8CC-45FE-AC5F-C68879B8D7FD}");
 
+            //! Gets the type of this fence.
+            virtual FenceType get_type() = 0;
+
+            //! Gets the current value of the fence.
+            //! @return Returns the current value of the fence. Returns 0 for binary fences.
+            virtual u64 get_completed_value() = 0;
+
+            //! Blocks the current thread until the fence value is greater than or equal to the specified value.
+            //! @param[in] value The value to wait.
+            //! @param[in] timeout The maximum time to wait in nanoseconds. Specify `U64_MAX` to wait infinitely.
+            //! @return Returns @ref BasicError::timeout if the fence value is not reached before timeout.
+            //! Returns @ref BasicError::not_supported if this is not a timeline fence.
+            virtual RV wait(u64 value, u64 timeout = U64_MAX) = 0;
+
+            //! Sets the fence value from host.
+            //! @param[in] value The value to set. This must be greater than the current value of the fence, and 
+            //! must be greater than all pending signal values of the fence.
+            //! @return Returns @ref BasicError::not_supported if this is not a timeline fence.
+            virtual RV signal(u64 value) = 0;
         };
 
         //! @}
@@ -0,0 +1,84 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file NullDevice.hpp
+* @author JXMaster
+* @date 2026/10/17
+* @brief Statistics interface of the null (headless) RHI backend.
+*/
+#pragma once
+#include "Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! @addtogroup RHI
+        //! @{
+
+        //! Describes the commands recorded by one device of the null backend.
+        //! @details Commands recorded in command buffers are counted when the command buffer is submitted, so commands in
+        //! command buffers that are reset without being submitted are not counted.
+        struct CommandRecordingStatistics
+        {
+            //! The number of command buffer submissions.
+            u64 num_submits = 0;
+            //! The number of render passes.
+            u64 num_render_passes = 0;
+            //! The number of compute passes.
+            u64 num_compute_passes = 0;
+            //! The number of copy passes.
+            u64 num_copy_passes = 0;
+            //! The number of draw calls, including indirect draw calls. Every indirect call is counted as one draw call
+            //! regardless of its draw count.
+            u64 num_draws = 0;
+            //! The number of indirect draw calls.
+            u64 num_indirect_draws = 0;
+            //! The number of dispatch calls, including indirect dispatch calls.
+            u64 num_dispatches = 0;
+            //! The number of pipeline state changes.
+            u64 num_pipeline_state_changes = 0;
+            //! The number of descriptor sets bound to pipelines.
+            u64 num_descriptor_set_bindings = 0;
+            //! The number of @ref ICommandBuffer::resource_barrier calls.
+            u64 num_barrier_calls = 0;
+            //! The number of buffer and texture barriers.
+            u64 num_barriers = 0;
+            //! The number of copy commands.
+            u64 num_copies = 0;
+            //! The number of bytes copied by copy commands whose source is one upload buffer.
+            u64 num_bytes_uploaded = 0;
+            //! The number of @ref IDescriptorSet::update_descriptors calls.
+            u64 num_descriptor_updates = 0;
+            //! The number of descriptors written by @ref IDescriptorSet::update_descriptors.
+            u64 num_descriptor_writes = 0;
+            //! The number of bytes written to upload buffers by host, reported by @ref IBuffer::unmap.
+            u64 num_bytes_written_by_host = 0;
+            //! The number of presentations of swap chains.
+            u64 num_presents = 0;
+        };
+
+        //! @interface INullDevice
+        //! Implemented by devices of the null backend (@ref BackendType::null), which validates and records all commands
+        //! without executing them on GPU.
+        //! @details The null backend can be used to measure the CPU overhead of rendering code in isolation, or to run
+        //! rendering code on machines without GPU. Use `query_interface<INullDevice>(device->get_object())` to fetch this
+        //! interface from one device.
+        //!
+        //! All functions of this interface are thread-safe.
+        struct INullDevice : virtual Interface
+        {
+            luiid("{4b6f0e7d-2c31-4f8a-9d5e-a1c7b3e82f60}");
+
+            //! Gets the commands recorded by this device since the device is created or the statistics are reset.
+            virtual CommandRecordingStatistics get_statistics() = 0;
+
+            //! Resets all statistics to 0.
+            virtual void reset_statistics() = 0;
+        };
+
+        //! @}
+    }
+}
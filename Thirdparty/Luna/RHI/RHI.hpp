@@ -29,6 +29,8 @@ namespace Luna
             vulkan,
             //! The Apple Metal backend.
             metal,
+            //! The null backend that validates and records commands without GPU, see @ref INullDevice.
+            null,
         };
 
         //! Gets the backend type.
@@ -28,6 +28,8 @@ namespace Luna
                 case BackendType::d3d12: return ShaderCompiler::TargetFormat::dxil;
                 case BackendType::vulkan: return ShaderCompiler::TargetFormat::spir_v;
                 case BackendType::metal: return ShaderCompiler::TargetFormat::msl;
+                // Shaders are never executed by the null backend, so they are only validated.
+                case BackendType::null: return ShaderCompiler::TargetFormat::none;
             }
             lupanic();
             return ShaderCompiler::TargetFormat::none;
@@ -11,6 +11,7 @@
 #define LUNA_RHI_API LUNA_EXPORT
 #include "../Utility.hpp"
 #include "../Device.hpp"
+#include "../UploadRingBuffer.hpp"
 
 namespace Luna
 {
@@ -23,11 +24,24 @@ namespace Luna
             u64 slice_pitch;
             Format pixel_format;
         };
-        LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies)
+        static RV copy_resource_data_impl(ICommandBuffer* command_buffer, IUploadRingBuffer* upload_ring, Span<const CopyResourceData> copies)
         {
             auto dev = command_buffer->get_device();
+            if (upload_ring)
+            {
+                // Copies staged through the upload ring are only recorded, so read operations cannot be performed.
+                for (auto& i : copies)
+                {
+                    if (i.op == ResourceDataCopyOp::read_buffer || i.op == ResourceDataCopyOp::read_texture)
+                    {
+                        return set_error(BasicError::bad_arguments(), "copy_resource_data with one upload ring cannot read data from resources.");
+                    }
+                }
+            }
             // Allocate one upload and one readback heap.
             u64 upload_buffer_size = 0;
+            // The alignment of the whole upload data block, used when staging through the upload ring.
+            u64 upload_alignment = 4;
             u64 readback_buffer_size = 0;
             Vector<CopyBufferPlacementInfo> placements;
             Vector<BufferBarrier> buffer_barriers;
@@ -69,6 +83,7 @@ namespace Luna
                     u64 offset = align_upper(upload_buffer_size, alignment);
                     placements.push_back({ offset, row_pitch, slice_pitch, desc.format });
                     upload_buffer_size = offset + size;
+                    upload_alignment = max(upload_alignment, alignment);
                     texture_barriers.emplace_back(i.write_texture_desc.dst, i.write_texture_desc.dst_subresource, TextureStateFlag::automatic, TextureStateFlag::copy_dest);
                 }
             }
@@ -78,10 +93,24 @@ namespace Luna
                 Ref<IBuffer> readback_buffer;
                 void* upload_data = nullptr;
                 void* readback_data = nullptr;
+                // The offset of the upload data block in `upload_buffer`.
+                u64 upload_offset = 0;
                 if (upload_buffer_size)
                 {
-                    luset(upload_buffer, dev->new_buffer(MemoryType::upload, BufferDesc(BufferUsageFlag::copy_source, upload_buffer_size)));
-                    luexp(upload_buffer->map(0, 0, &upload_data));
+                    if (upload_ring)
+                    {
+                        lucheck_msg(test_flags(upload_ring->get_desc().usages, BufferUsageFlag::copy_source), 
+                            "The upload ring must be created with BufferUsageFlag::copy_source to stage copies.");
+                        lulet(allocation, upload_ring->allocate(upload_buffer_size, upload_alignment));
+                        upload_buffer = allocation.buffer;
+                        upload_offset = allocation.offset;
+                        upload_data = allocation.data;
+                    }
+                    else
+                    {
+                        luset(upload_buffer, dev->new_buffer(MemoryType::upload, BufferDesc(BufferUsageFlag::copy_source, upload_buffer_size)));
+                        luexp(upload_buffer->map(0, 0, &upload_data));
+                    }
                     // Fill upload data.
                     for (usize i = 0; i < copies.size(); ++i)
                     {
@@ -99,7 +128,10 @@ namespace Luna
                                 (usize)placement.row_pitch, copy.write_texture_desc.src_row_pitch, (usize)placement.slice_pitch, copy.write_texture_desc.src_slice_pitch);
                         }
                     }
-                    upload_buffer->unmap(0, USIZE_MAX);
+                    if (!upload_ring)
+                    {
+                        upload_buffer->unmap(0, USIZE_MAX);
+                    }
                 }
                 if (readback_buffer_size)
                 {
@@ -120,7 +152,7 @@ namespace Luna
                     else if (copy.op == ResourceDataCopyOp::write_buffer)
                     {
                         auto& desc = copy.write_buffer_desc;
-                        command_buffer->copy_buffer(desc.dst, desc.dst_offset, upload_buffer, placement.offset, desc.copy_size);
+                        command_buffer->copy_buffer(desc.dst, desc.dst_offset, upload_buffer, upload_offset + placement.offset, desc.copy_size);
                     }
                     else if (copy.op == ResourceDataCopyOp::read_texture)
                     {
@@ -133,10 +165,12 @@ namespace Luna
                     {
                         auto& desc = copy.write_texture_desc;
                         command_buffer->copy_buffer_to_texture(desc.dst, desc.dst_subresource, desc.dst_x, desc.dst_y, desc.dst_z, 
-                            upload_buffer, placement.offset, (u32)placement.row_pitch, (u32)placement.slice_pitch, desc.copy_width, desc.copy_height, desc.copy_depth);
+                            upload_buffer, upload_offset + placement.offset, (u32)placement.row_pitch, (u32)placement.slice_pitch, desc.copy_width, desc.copy_height, desc.copy_depth);
                     }
                 }
                 command_buffer->end_copy_pass();
+                // Copies staged through the upload ring are submitted by the user with other commands of the frame.
+                if (upload_ring) return ok;
                 // Submit copy command to GPU and wait for completion.
                 luexp(command_buffer->submit({}, {}, true));
                 command_buffer->wait();
@@ -167,5 +201,13 @@ namespace Luna
             lucatchret;
             return ok;
         }
+        LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies)
+        {
+            return copy_resource_data_impl(command_buffer, nullptr, copies);
+        }
+        LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, IUploadRingBuffer* upload_ring, Span<const CopyResourceData> copies)
+        {
+            return copy_resource_data_impl(command_buffer, upload_ring, copies);
+        }
     }
 }
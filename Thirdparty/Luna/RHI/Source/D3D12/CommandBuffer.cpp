@@ -578,6 +578,22 @@ namespace Luna
             assert_graphcis_context();
             m_li->DrawInstanced(vertex_count_per_instance, instance_count, start_vertex_location, start_instance_location);
         }
+        void CommandBuffer::execute_indirect(D3D12_INDIRECT_ARGUMENT_TYPE type, IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+            u32 max_command_count, u32 stride)
+        {
+            lutsassert();
+            auto signature = m_device->get_command_signature(type, stride);
+            if (failed(signature))
+            {
+                // Signatures for default strides are created when the device is created, so this only fails for custom strides.
+                lupanic_msg_always("Failed to create command signature for indirect commands.");
+                return;
+            }
+            BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+            BufferResource* c = count_buffer ? cast_object<BufferResource>(count_buffer->get_object()) : nullptr;
+            m_li->ExecuteIndirect(signature.get(), max_command_count, b->m_res.Get(), offset,
+                c ? c->m_res.Get() : nullptr, count_buffer_offset);
+        }
         void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
         {
             lutsassert();
@@ -954,8 +970,11 @@ namespace Luna
                 m_li->ResourceBarrier((UINT)m_tracking_system.m_barriers.size(), m_tracking_system.m_barriers.data());
             }
         }
-        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting)
+        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+            Span<const u64> wait_values, Span<const u64> signal_values)
         {
+            lucheck_msg(wait_values.empty() || wait_values.size() == wait_fences.size(), "wait_values must be empty or have the same size as wait_fences.");
+            lucheck_msg(signal_values.empty() || signal_values.size() == signal_fences.size(), "signal_values must be empty or have the same size as signal_fences.");
             lutsassert();
             assert_no_context();
             HRESULT hr;
@@ -965,10 +984,18 @@ namespace Luna
 
             auto& queue = m_device->m_command_queues[m_queue];
 
-            for (IFence* f : wait_fences)
+            for (usize i = 0; i < wait_fences.size(); ++i)
             {
-                Fence* fence = cast_object<Fence>(f->get_object());
-                queue->m_command_queue->Wait(fence->m_fence.Get(), fence->m_wait_value);
+                Fence* fence = cast_object<Fence>(wait_fences[i]->get_object());
+                if (fence->m_type == FenceType::timeline)
+                {
+                    lucheck_msg(!wait_values.empty(), "wait_values must be specified when waiting for timeline fences.");
+                    queue->m_command_queue->Wait(fence->m_fence.Get(), wait_values[i]);
+                }
+                else
+                {
+                    queue->m_command_queue->Wait(fence->m_fence.Get(), fence->m_wait_value);
+                }
             }
 
             // Resolve barriers.
@@ -1013,11 +1040,19 @@ namespace Luna
                 hr = queue->m_command_queue->Signal(m_fence.Get(), m_wait_value);
                 if (FAILED(hr)) return encode_hresult(hr);
             }
-            for (IFence* f : signal_fences)
+            for (usize i = 0; i < signal_fences.size(); ++i)
             {
-                Fence* fence = cast_object<Fence>(f->get_object());
-                ++fence->m_wait_value;
-                hr = queue->m_command_queue->Signal(fence->m_fence.Get(), fence->m_wait_value);
+                Fence* fence = cast_object<Fence>(signal_fences[i]->get_object());
+                if (fence->m_type == FenceType::timeline)
+                {
+                    lucheck_msg(!signal_values.empty(), "signal_values must be specified when signaling timeline fences.");
+                    hr = queue->m_command_queue->Signal(fence->m_fence.Get(), signal_values[i]);
+                }
+                else
+                {
+                    ++fence->m_wait_value;
+                    hr = queue->m_command_queue->Signal(fence->m_fence.Get(), fence->m_wait_value);
+                }
                 if (FAILED(hr)) return encode_hresult(hr);
             }
             return ok;
@@ -238,11 +238,42 @@ namespace Luna
                     m_rtv_heap.init(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
                     m_dsv_heap.init(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
                 }
-
+                // Create command signatures for default strides, so that failures are reported here instead of 
+                // being reported when recording indirect commands.
+                luexp(get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, sizeof(DrawIndirectArguments)));
+                luexp(get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, sizeof(DrawIndexedIndirectArguments)));
+                luexp(get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH, sizeof(DispatchIndirectArguments)));
             }
             lucatchret;
             return ok;
         }
+        R<ID3D12CommandSignature*> Device::get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE type, u32 stride)
+        {
+            u64 key = ((u64)type << 32) | (u64)stride;
+            LockGuard guard(m_command_signatures_lock);
+            auto iter = m_command_signatures.find(key);
+            if (iter != m_command_signatures.end())
+            {
+                return iter->second.Get();
+            }
+            D3D12_INDIRECT_ARGUMENT_DESC arg{};
+            arg.Type = type;
+            D3D12_COMMAND_SIGNATURE_DESC desc{};
+            desc.ByteStride = stride;
+            desc.NumArgumentDescs = 1;
+            desc.pArgumentDescs = &arg;
+            desc.NodeMask = 0;
+            ComPtr<ID3D12CommandSignature> signature;
+            // Root signature is not required if the command signature only changes draw or dispatch arguments.
+            lutry
+            {
+                luexp(encode_hresult(m_device->CreateCommandSignature(&desc, nullptr, IID_PPV_ARGS(&signature))));
+            }
+            lucatchret;
+            ID3D12CommandSignature* ret = signature.Get();
+            m_command_signatures.insert(make_pair(key, move(signature)));
+            return ret;
+        }
         DeviceFeatureData Device::check_feature(DeviceFeature feature)
         {
             DeviceFeatureData ret;
@@ -257,6 +288,15 @@ namespace Luna
             case DeviceFeature::uniform_buffer_data_alignment:
                 ret.uniform_buffer_data_alignment = 256;
                 break;
+            case DeviceFeature::multi_draw_indirect:
+                ret.multi_draw_indirect = true;
+                break;
+            case DeviceFeature::draw_indirect_count:
+                ret.draw_indirect_count = true;
+                break;
+            case DeviceFeature::timeline_fence:
+                ret.timeline_fence = true;
+                break;
             default: lupanic();
             }
             return ret;
@@ -478,11 +518,11 @@ namespace Luna
             }
             return Ref<IQueryHeap>(heap);
         }
-        R<Ref<IFence>> Device::new_fence()
+        R<Ref<IFence>> Device::new_fence(FenceType type)
         {
             Ref<Fence> fence = new_object<Fence>();
             fence->m_device = this;
-            RV r = fence->init();
+            RV r = fence->init(type);
             if (!r.valid())
             {
                 return r.errcode();
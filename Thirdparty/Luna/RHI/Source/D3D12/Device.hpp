@@ -17,6 +17,7 @@
 #include <Luna/Runtime/List.hpp>
 #include <Luna/Runtime/SpinLock.hpp>
 #include <Luna/Runtime/UniquePtr.hpp>
+#include <Luna/Runtime/HashMap.hpp>
 
 namespace Luna
 {
@@ -101,8 +102,15 @@ namespace Luna
             // Memory Allocator.
             ComPtr<D3D12MA::Allocator> m_allocator;
 
+            // Command signatures for indirect commands, indexed by argument type (high 32 bits) and stride (low 32 bits).
+            HashMap<u64, ComPtr<ID3D12CommandSignature>> m_command_signatures;
+            SpinLock m_command_signatures_lock;
+
             ~Device();
 
+            //! Gets the command signature used by `ExecuteIndirect`, creates it if not exist.
+            R<ID3D12CommandSignature*> get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE type, u32 stride);
+
             R<UniquePtr<CommandQueue>> new_command_queue(const CommandQueueDesc& desc);
             RV init(IDXGIAdapter* adapter);
             
@@ -120,13 +128,18 @@ namespace Luna
             virtual R<Ref<IPipelineState>> new_compute_pipeline_state(const ComputePipelineStateDesc& desc) override;
             virtual R<Ref<IDescriptorSetLayout>> new_descriptor_set_layout(const DescriptorSetLayoutDesc& desc) override;
             virtual R<Ref<IDescriptorSet>> new_descriptor_set(const DescriptorSetDesc& desc) override;
+            // Descriptor sets are not allocated from descriptor pools in this backend.
+            virtual DescriptorPoolStatistics get_descriptor_pool_statistics() override { return DescriptorPoolStatistics(); }
             virtual u32 get_num_command_queues() override;
             virtual CommandQueueDesc get_command_queue_desc(u32 command_queue_index) override;
             virtual R<Ref<ICommandBuffer>> new_command_buffer(u32 command_queue_index) override;
             virtual R<f64> get_command_queue_timestamp_frequency(u32 command_queue_index) override;
             virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
-            virtual R<Ref<IFence>> new_fence() override;
+            virtual R<Ref<IFence>> new_fence(FenceType type) override;
             virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+            // Pipeline caches are not implemented by this backend, so pipeline cache data is empty and ignored.
+            virtual R<Blob> get_pipeline_cache_data() override { return Blob(); }
+            virtual RV load_pipeline_cache_data(Span<const byte_t> data) override { return ok; }
         };
     }
 }
\ No newline at end of file
@@ -12,8 +12,9 @@ namespace Luna
 {
     namespace RHI
     {
-        RV Fence::init()
+        RV Fence::init(FenceType type)
         {
+            m_type = type;
             lutry
             {
                 luexp(encode_hresult(m_device->m_device->CreateFence(m_wait_value, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence))));
@@ -21,5 +22,29 @@ namespace Luna
             lucatchret;
             return ok;
         }
+        RV Fence::wait(u64 value, u64 timeout)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            if (m_fence->GetCompletedValue() >= value) return ok;
+            if (timeout == 0) return BasicError::timeout();
+            HANDLE event = ::CreateEventA(NULL, FALSE, FALSE, NULL);
+            if (!event) return BasicError::bad_platform_call();
+            RV r = encode_hresult(m_fence->SetEventOnCompletion(value, event));
+            if (succeeded(r))
+            {
+                u64 timeout_ms = timeout / 1000000;
+                DWORD wait_ms = timeout == U64_MAX ? INFINITE : (timeout_ms >= INFINITE ? INFINITE - 1 : (DWORD)timeout_ms);
+                DWORD res = ::WaitForSingleObject(event, wait_ms);
+                if (res == WAIT_TIMEOUT) r = BasicError::timeout();
+                else if (res != WAIT_OBJECT_0) r = BasicError::bad_platform_call();
+            }
+            ::CloseHandle(event);
+            return r;
+        }
+        RV Fence::signal(u64 value)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            return encode_hresult(m_fence->Signal(value));
+        }
     }
 }
\ No newline at end of file
@@ -20,11 +20,20 @@ namespace Luna
 
             Ref<Device> m_device;
             ComPtr<ID3D12Fence> m_fence;
+            //! For binary fences, this is the last signaled value and is increased by every signal operation.
             u64 m_wait_value = 0;
+            FenceType m_type = FenceType::binary;
 
-            RV init();
+            RV init(FenceType type);
             virtual IDevice* get_device() override { return m_device; }
             virtual void set_name(const c8* name) override { set_object_name(m_fence.Get(), name); }
+            virtual FenceType get_type() override { return m_type; }
+            virtual u64 get_completed_value() override
+            {
+                return m_type == FenceType::timeline ? m_fence->GetCompletedValue() : 0;
+            }
+            virtual RV wait(u64 value, u64 timeout) override;
+            virtual RV signal(u64 value) override;
         };
     }
 }
\ No newline at end of file
@@ -373,6 +373,28 @@ namespace Luna
             m_render->drawIndexedPrimitives(m_primitive_type, (NS::UInteger)index_count_per_instance, type, 
                 buffer->m_buffer.get(), (NS::UInteger)start_index_location, instance_count, (NS::Integer)base_vertex_location, start_instance_location);
         }
+        void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride)
+        {
+            assert_graphcis_context();
+            Buffer* b = cast_object<Buffer>(buffer->get_object());
+            // Metal reads one argument structure per draw call, so multi-draw is emulated by a loop.
+            for (u32 i = 0; i < draw_count; ++i)
+            {
+                m_render->drawPrimitives(m_primitive_type, b->m_buffer.get(), (NS::UInteger)(offset + (u64)i * stride));
+            }
+        }
+        void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride)
+        {
+            assert_graphcis_context();
+            Buffer* b = cast_object<Buffer>(buffer->get_object());
+            Buffer* index_buffer = cast_object<Buffer>(m_index_buffer_view.buffer->get_object());
+            MTL::IndexType type = encode_index_type(m_index_buffer_view.format);
+            for (u32 i = 0; i < draw_count; ++i)
+            {
+                m_render->drawIndexedPrimitives(m_primitive_type, type, index_buffer->m_buffer.get(), (NS::UInteger)m_index_buffer_view.offset,
+                    b->m_buffer.get(), (NS::UInteger)(offset + (u64)i * stride));
+            }
+        }
         void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
         {
             assert_graphcis_context();
@@ -535,6 +557,13 @@ namespace Luna
             m_compute->dispatchThreadgroups(MTL::Size::Make(thread_group_count_x, thread_group_count_y, thread_group_count_z), 
                 MTL::Size::Make(m_num_threads_per_group.x, m_num_threads_per_group.y, m_num_threads_per_group.z));
         }
+        void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+        {
+            assert_compute_context();
+            Buffer* b = cast_object<Buffer>(buffer->get_object());
+            m_compute->dispatchThreadgroups(b->m_buffer.get(), (NS::UInteger)offset,
+                MTL::Size::Make(m_num_threads_per_group.x, m_num_threads_per_group.y, m_num_threads_per_group.z));
+        }
         void CommandBuffer::end_compute_pass()
         {
             assert_compute_context();
@@ -697,8 +726,11 @@ namespace Luna
                  m_compute->memoryBarrier(resources, i);
              }
         }
-        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting)
+        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+            Span<const u64> wait_values, Span<const u64> signal_values)
         {
+            lucheck_msg(wait_values.empty() || wait_values.size() == wait_fences.size(), "wait_values must be empty or have the same size as wait_fences.");
+            lucheck_msg(signal_values.empty() || signal_values.size() == signal_fences.size(), "signal_values must be empty or have the same size as signal_fences.");
             AutoreleasePool pool;
             if(!wait_fences.empty())
             {
@@ -707,9 +739,18 @@ namespace Luna
                 for(IFence* fence : wait_fences)
                 {
                     Fence* f = cast_object<Fence>(fence->get_object());
-                    encoder->waitForFence(f->m_fence.get());
+                    if(f->m_type == FenceType::binary) encoder->waitForFence(f->m_fence.get());
                 }
                 encoder->endEncoding();
+                for(usize i = 0; i < wait_fences.size(); ++i)
+                {
+                    Fence* f = cast_object<Fence>(wait_fences[i]->get_object());
+                    if(f->m_type == FenceType::timeline)
+                    {
+                        lucheck_msg(!wait_values.empty(), "wait_values must be specified when waiting for timeline fences.");
+                        wait_buffer->encodeWait(f->m_event.get(), wait_values[i]);
+                    }
+                }
                 wait_buffer->commit();
             }
             if(!signal_fences.empty())
@@ -718,9 +759,18 @@ namespace Luna
                 for(IFence* fence : signal_fences)
                 {
                     Fence* f = cast_object<Fence>(fence->get_object());
-                    encoder->updateFence(f->m_fence.get());
+                    if(f->m_type == FenceType::binary) encoder->updateFence(f->m_fence.get());
                 }
                 encoder->endEncoding();
+                for(usize i = 0; i < signal_fences.size(); ++i)
+                {
+                    Fence* f = cast_object<Fence>(signal_fences[i]->get_object());
+                    if(f->m_type == FenceType::timeline)
+                    {
+                        lucheck_msg(!signal_values.empty(), "signal_values must be specified when signaling timeline fences.");
+                        m_buffer->encodeSignalEvent(f->m_event.get(), signal_values[i]);
+                    }
+                }
             }
             m_buffer->commit();
             return ok;
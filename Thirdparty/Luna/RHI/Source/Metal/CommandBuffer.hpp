@@ -95,6 +95,19 @@ namespace Luna
                 u32 start_instance_location) override;
             virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
                 i32 base_vertex_location, u32 start_instance_location) override;
+            virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride) override;
+            virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride) override;
+            // Count buffers are not supported by Metal render command encoders, see DeviceFeature::draw_indirect_count.
+            virtual void draw_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+                u32 max_draw_count, u32 stride) override
+            {
+                lupanic_msg("DeviceFeature::draw_indirect_count is not supported.");
+            }
+            virtual void draw_indexed_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+                u32 max_draw_count, u32 stride) override
+            {
+                lupanic_msg("DeviceFeature::draw_indirect_count is not supported.");
+            }
             virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) override;
             virtual void end_occlusion_query(u32 index) override;
             virtual void end_render_pass() override;
@@ -104,6 +117,7 @@ namespace Luna
             virtual void set_compute_descriptor_set(u32 index, IDescriptorSet* descriptor_set) override;
             virtual void set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
             virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) override;
+            virtual void dispatch_indirect(IBuffer* buffer, u64 offset) override;
             virtual void end_compute_pass() override;
             virtual void begin_copy_pass(const CopyPassDesc& desc) override;
             virtual void copy_resource(IResource* dst, IResource* src) override;
@@ -125,7 +139,8 @@ namespace Luna
                 u32 copy_width, u32 copy_height, u32 copy_depth) override;
             virtual void end_copy_pass() override;
             virtual void resource_barrier(Span<const BufferBarrier> buffer_barriers, Span<const TextureBarrier> texture_barriers) override;
-            virtual RV submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting) override;
+            virtual RV submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+                Span<const u64> wait_values, Span<const u64> signal_values) override;
         };
     }
 }
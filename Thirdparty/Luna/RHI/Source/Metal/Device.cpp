@@ -128,6 +128,15 @@ namespace Luna
             case DeviceFeature::uniform_buffer_data_alignment:
                 ret.uniform_buffer_data_alignment = 0;
                 break;
+            case DeviceFeature::multi_draw_indirect:
+                ret.multi_draw_indirect = true;
+                break;
+            case DeviceFeature::draw_indirect_count:
+                ret.draw_indirect_count = false;
+                break;
+            case DeviceFeature::timeline_fence:
+                ret.timeline_fence = true;
+                break;
             default: lupanic();
             }
             return ret;
@@ -342,14 +351,14 @@ namespace Luna
             lucatchret;
             return ret;
         }
-        R<Ref<IFence>> Device::new_fence()
+        R<Ref<IFence>> Device::new_fence(FenceType type)
         {
             Ref<IFence> ret;
             lutry
             {
                 Ref<Fence> fence = new_object<Fence>();
                 fence->m_device = this;
-                luexp(fence->init());
+                luexp(fence->init(type));
                 ret = fence;
             }
             lucatchret;
@@ -65,13 +65,18 @@ namespace Luna
             virtual R<Ref<IPipelineState>> new_compute_pipeline_state(const ComputePipelineStateDesc& desc) override;
             virtual R<Ref<IDescriptorSetLayout>> new_descriptor_set_layout(const DescriptorSetLayoutDesc& desc) override;
             virtual R<Ref<IDescriptorSet>> new_descriptor_set(const DescriptorSetDesc& desc) override;
+            // Descriptor sets are not allocated from descriptor pools in this backend.
+            virtual DescriptorPoolStatistics get_descriptor_pool_statistics() override { return DescriptorPoolStatistics(); }
             virtual u32 get_num_command_queues() override;
             virtual CommandQueueDesc get_command_queue_desc(u32 command_queue_index) override;
             virtual R<Ref<ICommandBuffer>> new_command_buffer(u32 command_queue_index) override;
             virtual R<f64> get_command_queue_timestamp_frequency(u32 command_queue_index) override;
             virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
-            virtual R<Ref<IFence>> new_fence() override;
+            virtual R<Ref<IFence>> new_fence(FenceType type) override;
             virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+            // Pipeline caches are not implemented by this backend, so pipeline cache data is empty and ignored.
+            virtual R<Blob> get_pipeline_cache_data() override { return Blob(); }
+            virtual RV load_pipeline_cache_data(Span<const byte_t> data) override { return ok; }
         };
 
         extern Ref<IDevice> g_main_device;
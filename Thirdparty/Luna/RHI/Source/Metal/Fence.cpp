@@ -8,14 +8,67 @@
 * @date 2023/8/3
 */
 #include "Fence.hpp"
+#include <Luna/Runtime/Time.hpp>
+#include <Luna/Runtime/Thread.hpp>
+#include <dispatch/dispatch.h>
 
 namespace Luna
 {
     namespace RHI
     {
-        RV Fence::init()
+        RV Fence::init(FenceType type)
         {
-            m_fence = box(m_device->m_device->newFence());
+            m_type = type;
+            if (type == FenceType::timeline)
+            {
+                m_event = box(m_device->m_device->newSharedEvent());
+                if (!m_event) return BasicError::not_supported();
+                m_listener = box(MTL::SharedEventListener::alloc()->init());
+            }
+            else
+            {
+                m_fence = box(m_device->m_device->newFence());
+            }
+            return ok;
+        }
+        RV Fence::wait(u64 value, u64 timeout)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            if (m_event->signaledValue() >= value) return ok;
+            if (timeout == 0) return BasicError::timeout();
+            if (m_listener)
+            {
+                dispatch_semaphore_t sem = dispatch_semaphore_create(0);
+                // The block may be called after this function returns on timeout, so it holds one extra reference to the semaphore.
+                dispatch_retain(sem);
+                m_event->notifyListener(m_listener.get(), value, ^(MTL::SharedEvent*, u64)
+                {
+                    dispatch_semaphore_signal(sem);
+                    dispatch_release(sem);
+                });
+                dispatch_time_t wait_time = timeout == U64_MAX ? DISPATCH_TIME_FOREVER : 
+                    dispatch_time(DISPATCH_TIME_NOW, (i64)min<u64>(timeout, (u64)I64_MAX));
+                long r = dispatch_semaphore_wait(sem, wait_time);
+                dispatch_release(sem);
+                return r == 0 ? ok : BasicError::timeout();
+            }
+            // Fall back to polling the value if the listener is not available.
+            u64 begin_ticks = get_ticks();
+            f64 ticks_per_ns = get_ticks_per_second() / 1000000000.0;
+            while (m_event->signaledValue() < value)
+            {
+                if (timeout != U64_MAX && (f64)(get_ticks() - begin_ticks) >= (f64)timeout * ticks_per_ns)
+                {
+                    return BasicError::timeout();
+                }
+                yield_current_thread();
+            }
+            return ok;
+        }
+        RV Fence::signal(u64 value)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            m_event->setSignaledValue(value);
             return ok;
         }
     }
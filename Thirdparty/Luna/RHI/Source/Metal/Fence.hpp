@@ -20,12 +20,30 @@ namespace Luna
             luiimpl();
 
             Ref<Device> m_device;
+            //! Used by binary fences.
             NSPtr<MTL::Fence> m_fence;
+            //! Used by timeline fences.
+            NSPtr<MTL::SharedEvent> m_event;
+            //! Used by timeline fences to wait for values without polling. 
+            //! This may be `nullptr` if the listener is not supported by the system.
+            NSPtr<MTL::SharedEventListener> m_listener;
+            FenceType m_type = FenceType::binary;
 
-            RV init();
+            RV init(FenceType type);
 
             virtual IDevice* get_device() override { return m_device; }
-            virtual void set_name(const c8* name) override  { set_object_name(m_fence.get(), name); }
+            virtual void set_name(const c8* name) override
+            {
+                if (m_type == FenceType::timeline) set_object_name(m_event.get(), name);
+                else set_object_name(m_fence.get(), name);
+            }
+            virtual FenceType get_type() override { return m_type; }
+            virtual u64 get_completed_value() override
+            {
+                return m_type == FenceType::timeline ? m_event->signaledValue() : 0;
+            }
+            virtual RV wait(u64 value, u64 timeout) override;
+            virtual RV signal(u64 value) override;
         };
     }
 }
\ No newline at end of file
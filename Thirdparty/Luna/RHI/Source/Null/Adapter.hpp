@@ -0,0 +1,31 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Adapter.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Common.hpp"
+#include "../../Adapter.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct Adapter : IAdapter
+        {
+            lustruct("RHI::Adapter", "{6a1f3c2e-8b47-4d09-a5e1-2f9c7d4b6e13}");
+            luiimpl();
+
+            virtual const c8* get_name() override
+            {
+                return "Null Adapter";
+            }
+        };
+        extern Vector<Ref<IAdapter>> g_adapters;
+        void init_adapters();
+    }
+}
@@ -0,0 +1,452 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CommandBuffer.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "CommandBuffer.hpp"
+#include "DescriptorSet.hpp"
+#include "Fence.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV CommandBuffer::reset()
+        {
+            assert_no_context();
+            m_objs.clear();
+            m_submitted = false;
+            m_num_open_events = 0;
+            m_graphics_pipeline_layout = nullptr;
+            m_graphics_pipeline_state = nullptr;
+            m_compute_pipeline_layout = nullptr;
+            m_compute_pipeline_state = nullptr;
+            m_index_buffer_set = false;
+            m_statistics = CommandRecordingStatistics();
+            return ok;
+        }
+        void CommandBuffer::attach_device_object(IDeviceChild* obj)
+        {
+            m_objs.push_back(obj);
+        }
+        void CommandBuffer::begin_event(const c8* event_name)
+        {
+            ++m_num_open_events;
+        }
+        void CommandBuffer::end_event()
+        {
+            lucheck_msg(m_num_open_events, "end_event is called without matching begin_event.");
+            --m_num_open_events;
+        }
+        void CommandBuffer::begin_pass_timestamp(IQueryHeap* heap, u32 begin_index, u32 end_index)
+        {
+            if (!heap) return;
+            QueryHeap* query_heap = cast_object<QueryHeap>(heap->get_object());
+            lucheck_msg(query_heap->m_desc.type == QueryType::timestamp || query_heap->m_desc.type == QueryType::timestamp_copy_queue,
+                "The timestamp query heap of one pass must be a timestamp query heap.");
+            if (begin_index != DONT_QUERY) query_heap->write_timestamp(begin_index);
+            m_timestamp_query_heap = query_heap;
+            m_timestamp_end_query_index = end_index;
+        }
+        void CommandBuffer::end_pass_timestamp()
+        {
+            if (m_timestamp_query_heap && m_timestamp_end_query_index != DONT_QUERY)
+            {
+                m_timestamp_query_heap->write_timestamp(m_timestamp_end_query_index);
+            }
+            m_timestamp_query_heap = nullptr;
+            m_timestamp_end_query_index = DONT_QUERY;
+        }
+        void CommandBuffer::begin_render_pass(const RenderPassDesc& desc)
+        {
+            lucheck_msg(!m_render_pass_begin && !m_compute_pass_begin && !m_copy_pass_begin, "begin_render_pass can only be called when no other pass is open.");
+            lucheck_msg(get_queue_type() == CommandQueueType::graphics, "Render passes can only be recorded in command buffers of graphics queues.");
+            bool has_attachment = desc.depth_stencil_attachment.texture != nullptr;
+            for (u32 i = 0; i < 8; ++i)
+            {
+                auto& src = desc.color_attachments[i];
+                if (!src.texture) break;
+                lucheck_msg(test_flags(src.texture->get_desc().usages, TextureUsageFlag::color_attachment),
+                    "Textures used as color attachments must have TextureUsageFlag::color_attachment set.");
+                has_attachment = true;
+            }
+            if (desc.depth_stencil_attachment.texture)
+            {
+                lucheck_msg(test_flags(desc.depth_stencil_attachment.texture->get_desc().usages, TextureUsageFlag::depth_stencil_attachment),
+                    "Textures used as depth stencil attachments must have TextureUsageFlag::depth_stencil_attachment set.");
+            }
+            lucheck_msg(has_attachment, "At least one color attachment or depth stencil attachment must be specified for one render pass.");
+            m_render_pass_begin = true;
+            m_graphics_pipeline_layout = nullptr;
+            m_graphics_pipeline_state = nullptr;
+            m_index_buffer_set = false;
+            m_occlusion_query_heap = desc.occlusion_query_heap ? cast_object<QueryHeap>(desc.occlusion_query_heap->get_object()) : nullptr;
+            begin_pass_timestamp(desc.timestamp_query_heap, desc.timestamp_query_begin_pass_write_index, desc.timestamp_query_end_pass_write_index);
+            ++m_statistics.num_render_passes;
+        }
+        void CommandBuffer::set_graphics_pipeline_layout(IPipelineLayout* pipeline_layout)
+        {
+            assert_graphcis_context();
+            lucheck_msg(pipeline_layout, "The pipeline layout must not be nullptr.");
+            m_graphics_pipeline_layout = cast_object<PipelineLayout>(pipeline_layout->get_object());
+        }
+        void CommandBuffer::set_graphics_pipeline_state(IPipelineState* pso)
+        {
+            assert_graphcis_context();
+            lucheck_msg(pso, "The pipeline state must not be nullptr.");
+            PipelineState* state = cast_object<PipelineState>(pso->get_object());
+            lucheck_msg(state->m_is_graphics, "Compute pipeline states cannot be set as graphics pipeline states.");
+            m_graphics_pipeline_state = state;
+            ++m_statistics.num_pipeline_state_changes;
+        }
+        void CommandBuffer::set_vertex_buffers(u32 start_slot, Span<const VertexBufferView> views)
+        {
+            assert_graphcis_context();
+            for (auto& view : views)
+            {
+                [[maybe_unused]] IBuffer* buffer = query_interface<IBuffer>(view.buffer->get_object());
+                lucheck_msg(buffer && test_flags(buffer->get_desc().usages, BufferUsageFlag::vertex_buffer),
+                    "Vertex buffers must have BufferUsageFlag::vertex_buffer set.");
+                lucheck_msg(buffer && view.offset + view.size <= buffer->get_desc().size, "The vertex buffer view is out of the buffer range.");
+            }
+        }
+        void CommandBuffer::set_index_buffer(const IndexBufferView& view)
+        {
+            assert_graphcis_context();
+            [[maybe_unused]] IBuffer* buffer = query_interface<IBuffer>(view.buffer->get_object());
+            lucheck_msg(buffer && test_flags(buffer->get_desc().usages, BufferUsageFlag::index_buffer),
+                "Index buffers must have BufferUsageFlag::index_buffer set.");
+            lucheck_msg(buffer && view.offset + view.size <= buffer->get_desc().size, "The index buffer view is out of the buffer range.");
+            lucheck_msg(view.format == Format::r16_uint || view.format == Format::r32_uint, "The index format must be Format::r16_uint or Format::r32_uint.");
+            m_index_buffer_set = true;
+        }
+        void CommandBuffer::set_graphics_descriptor_set(u32 index, IDescriptorSet* descriptor_set)
+        {
+            set_graphics_descriptor_sets(index, { &descriptor_set, 1 });
+        }
+        void CommandBuffer::set_graphics_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets)
+        {
+            assert_graphcis_context();
+            lucheck_msg(m_graphics_pipeline_layout, "Graphics pipeline layout must be set before binding descriptor sets.");
+            lucheck_msg(start_index + descriptor_sets.size() <= m_graphics_pipeline_layout->m_descriptor_set_layouts.size(),
+                "The descriptor set index is out of the range of the pipeline layout.");
+            m_statistics.num_descriptor_set_bindings += descriptor_sets.size();
+        }
+        void CommandBuffer::set_viewport(const Viewport& viewport)
+        {
+            assert_graphcis_context();
+        }
+        void CommandBuffer::set_viewports(Span<const Viewport> viewports)
+        {
+            assert_graphcis_context();
+        }
+        void CommandBuffer::set_scissor_rect(const RectI& rect)
+        {
+            assert_graphcis_context();
+        }
+        void CommandBuffer::set_scissor_rects(Span<const RectI> rects)
+        {
+            assert_graphcis_context();
+        }
+        void CommandBuffer::set_blend_factor(const Float4U& blend_factor)
+        {
+            assert_graphcis_context();
+        }
+        void CommandBuffer::set_stencil_ref(u32 stencil_ref)
+        {
+            assert_graphcis_context();
+        }
+        void CommandBuffer::validate_draw(bool indexed)
+        {
+            assert_graphcis_context();
+            lucheck_msg(m_graphics_pipeline_layout, "Graphics pipeline layout must be set before drawing.");
+            lucheck_msg(m_graphics_pipeline_state, "Graphics pipeline state must be set before drawing.");
+            lucheck_msg(!indexed || m_index_buffer_set, "Index buffer must be set before drawing indexed primitives.");
+        }
+        void CommandBuffer::validate_indirect_buffer(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride, u32 argument_size)
+        {
+            lucheck_msg(buffer, "The indirect argument buffer must not be nullptr.");
+            BufferDesc desc = buffer->get_desc();
+            lucheck_msg(test_flags(desc.usages, BufferUsageFlag::indirect_buffer), "Indirect argument buffers must have BufferUsageFlag::indirect_buffer set.");
+            lucheck_msg((offset % 4) == 0, "The offset of indirect arguments must be aligned to 4 bytes.");
+            lucheck_msg(draw_count <= 1 || stride >= argument_size, "The stride of indirect arguments must not be smaller than the argument size.");
+            lucheck_msg(!draw_count || offset + (u64)(draw_count - 1) * stride + argument_size <= desc.size,
+                "Indirect arguments are out of the buffer range.");
+        }
+        void CommandBuffer::draw(u32 vertex_count, u32 start_vertex_location)
+        {
+            validate_draw(false);
+            ++m_statistics.num_draws;
+        }
+        void CommandBuffer::draw_indexed(u32 index_count, u32 start_index_location, i32 base_vertex_location)
+        {
+            validate_draw(true);
+            ++m_statistics.num_draws;
+        }
+        void CommandBuffer::draw_instanced(u32 vertex_count_per_instance, u32 instance_count, u32 start_vertex_location,
+            u32 start_instance_location)
+        {
+            validate_draw(false);
+            ++m_statistics.num_draws;
+        }
+        void CommandBuffer::draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
+            i32 base_vertex_location, u32 start_instance_location)
+        {
+            validate_draw(true);
+            ++m_statistics.num_draws;
+        }
+        void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride)
+        {
+            validate_draw(false);
+            validate_indirect_buffer(buffer, offset, draw_count, stride, sizeof(DrawIndirectArguments));
+            ++m_statistics.num_draws;
+            ++m_statistics.num_indirect_draws;
+        }
+        void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride)
+        {
+            validate_draw(true);
+            validate_indirect_buffer(buffer, offset, draw_count, stride, sizeof(DrawIndexedIndirectArguments));
+            ++m_statistics.num_draws;
+            ++m_statistics.num_indirect_draws;
+        }
+        void CommandBuffer::draw_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+            u32 max_draw_count, u32 stride)
+        {
+            validate_draw(false);
+            validate_indirect_buffer(buffer, offset, max_draw_count, stride, sizeof(DrawIndirectArguments));
+            validate_indirect_buffer(count_buffer, count_buffer_offset, 1, 0, sizeof(u32));
+            ++m_statistics.num_draws;
+            ++m_statistics.num_indirect_draws;
+        }
+        void CommandBuffer::draw_indexed_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+            u32 max_draw_count, u32 stride)
+        {
+            validate_draw(true);
+            validate_indirect_buffer(buffer, offset, max_draw_count, stride, sizeof(DrawIndexedIndirectArguments));
+            validate_indirect_buffer(count_buffer, count_buffer_offset, 1, 0, sizeof(u32));
+            ++m_statistics.num_draws;
+            ++m_statistics.num_indirect_draws;
+        }
+        void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
+        {
+            assert_graphcis_context();
+            lucheck_msg(m_occlusion_query_heap, "Occlusion query heap must be specified in RenderPassDesc when using occlusion queries.");
+            lucheck_msg(index < m_occlusion_query_heap->m_desc.count, "The occlusion query index is out of range.");
+        }
+        void CommandBuffer::end_occlusion_query(u32 index)
+        {
+            assert_graphcis_context();
+            lucheck_msg(m_occlusion_query_heap, "Occlusion query heap must be specified in RenderPassDesc when using occlusion queries.");
+            lucheck_msg(index < m_occlusion_query_heap->m_desc.count, "The occlusion query index is out of range.");
+        }
+        void CommandBuffer::end_render_pass()
+        {
+            assert_graphcis_context();
+            end_pass_timestamp();
+            m_occlusion_query_heap = nullptr;
+            m_render_pass_begin = false;
+        }
+        void CommandBuffer::begin_compute_pass(const ComputePassDesc& desc)
+        {
+            lucheck_msg(!m_render_pass_begin && !m_compute_pass_begin && !m_copy_pass_begin, "begin_compute_pass can only be called when no other pass is open.");
+            lucheck_msg(get_queue_type() != CommandQueueType::copy, "Compute passes cannot be recorded in command buffers of copy queues.");
+            m_compute_pass_begin = true;
+            m_compute_pipeline_layout = nullptr;
+            m_compute_pipeline_state = nullptr;
+            begin_pass_timestamp(desc.timestamp_query_heap, desc.timestamp_query_begin_pass_write_index, desc.timestamp_query_end_pass_write_index);
+            ++m_statistics.num_compute_passes;
+        }
+        void CommandBuffer::set_compute_pipeline_layout(IPipelineLayout* pipeline_layout)
+        {
+            assert_compute_context();
+            lucheck_msg(pipeline_layout, "The pipeline layout must not be nullptr.");
+            m_compute_pipeline_layout = cast_object<PipelineLayout>(pipeline_layout->get_object());
+        }
+        void CommandBuffer::set_compute_pipeline_state(IPipelineState* pso)
+        {
+            assert_compute_context();
+            lucheck_msg(pso, "The pipeline state must not be nullptr.");
+            PipelineState* state = cast_object<PipelineState>(pso->get_object());
+            lucheck_msg(!state->m_is_graphics, "Graphics pipeline states cannot be set as compute pipeline states.");
+            m_compute_pipeline_state = state;
+            ++m_statistics.num_pipeline_state_changes;
+        }
+        void CommandBuffer::set_compute_descriptor_set(u32 index, IDescriptorSet* descriptor_set)
+        {
+            set_compute_descriptor_sets(index, { &descriptor_set, 1 });
+        }
+        void CommandBuffer::set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets)
+        {
+            assert_compute_context();
+            lucheck_msg(m_compute_pipeline_layout, "Compute pipeline layout must be set before binding descriptor sets.");
+            lucheck_msg(start_index + descriptor_sets.size() <= m_compute_pipeline_layout->m_descriptor_set_layouts.size(),
+                "The descriptor set index is out of the range of the pipeline layout.");
+            m_statistics.num_descriptor_set_bindings += descriptor_sets.size();
+        }
+        void CommandBuffer::dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z)
+        {
+            assert_compute_context();
+            lucheck_msg(m_compute_pipeline_layout, "Compute pipeline layout must be set before dispatching.");
+            lucheck_msg(m_compute_pipeline_state, "Compute pipeline state must be set before dispatching.");
+            ++m_statistics.num_dispatches;
+        }
+        void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+        {
+            assert_compute_context();
+            lucheck_msg(m_compute_pipeline_layout, "Compute pipeline layout must be set before dispatching.");
+            lucheck_msg(m_compute_pipeline_state, "Compute pipeline state must be set before dispatching.");
+            validate_indirect_buffer(buffer, offset, 1, 0, sizeof(DispatchIndirectArguments));
+            ++m_statistics.num_dispatches;
+        }
+        void CommandBuffer::end_compute_pass()
+        {
+            assert_compute_context();
+            end_pass_timestamp();
+            m_compute_pass_begin = false;
+        }
+        void CommandBuffer::begin_copy_pass(const CopyPassDesc& desc)
+        {
+            lucheck_msg(!m_render_pass_begin && !m_compute_pass_begin && !m_copy_pass_begin, "begin_copy_pass can only be called when no other pass is open.");
+            m_copy_pass_begin = true;
+            begin_pass_timestamp(desc.timestamp_query_heap, desc.timestamp_query_begin_pass_write_index, desc.timestamp_query_end_pass_write_index);
+            ++m_statistics.num_copy_passes;
+        }
+        void CommandBuffer::record_copy(IBuffer* src, u64 copy_bytes)
+        {
+            ++m_statistics.num_copies;
+            if (src && src->get_memory()->get_memory_type() == MemoryType::upload)
+            {
+                m_statistics.num_bytes_uploaded += copy_bytes;
+            }
+        }
+        void CommandBuffer::copy_resource(IResource* dst, IResource* src)
+        {
+            assert_copy_context();
+            IBuffer* src_buffer = query_interface<IBuffer>(src->get_object());
+            [[maybe_unused]] IBuffer* dst_buffer = query_interface<IBuffer>(dst->get_object());
+            lucheck_msg((src_buffer != nullptr) == (dst_buffer != nullptr), "copy_resource cannot copy data between buffers and textures.");
+            if (src_buffer)
+            {
+                lucheck_msg(src_buffer->get_desc().size == dst_buffer->get_desc().size, "Buffers copied by copy_resource must have the same size.");
+                record_copy(src_buffer, src_buffer->get_desc().size);
+            }
+            else
+            {
+                record_copy(nullptr, 0);
+            }
+        }
+        void CommandBuffer::copy_buffer(
+            IBuffer* dst, u64 dst_offset,
+            IBuffer* src, u64 src_offset,
+            u64 copy_bytes)
+        {
+            assert_copy_context();
+            lucheck_msg(test_flags(src->get_desc().usages, BufferUsageFlag::copy_source), "The source buffer must have BufferUsageFlag::copy_source set.");
+            lucheck_msg(test_flags(dst->get_desc().usages, BufferUsageFlag::copy_dest), "The destination buffer must have BufferUsageFlag::copy_dest set.");
+            lucheck_msg(src_offset + copy_bytes <= src->get_desc().size, "The copy range is out of the source buffer range.");
+            lucheck_msg(dst_offset + copy_bytes <= dst->get_desc().size, "The copy range is out of the destination buffer range.");
+            record_copy(src, copy_bytes);
+        }
+        void CommandBuffer::copy_texture(
+            ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+            ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+            u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            assert_copy_context();
+            lucheck_msg(test_flags(src->get_desc().usages, TextureUsageFlag::copy_source), "The source texture must have TextureUsageFlag::copy_source set.");
+            lucheck_msg(test_flags(dst->get_desc().usages, TextureUsageFlag::copy_dest), "The destination texture must have TextureUsageFlag::copy_dest set.");
+            record_copy(nullptr, 0);
+        }
+        void CommandBuffer::copy_buffer_to_texture(
+            ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+            IBuffer* src, u64 src_offset, u32 src_row_pitch, u32 src_slice_pitch,
+            u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            assert_copy_context();
+            lucheck_msg(test_flags(src->get_desc().usages, BufferUsageFlag::copy_source), "The source buffer must have BufferUsageFlag::copy_source set.");
+            lucheck_msg(test_flags(dst->get_desc().usages, TextureUsageFlag::copy_dest), "The destination texture must have TextureUsageFlag::copy_dest set.");
+            u64 copy_bytes = (u64)src_slice_pitch * copy_depth;
+            lucheck_msg(src_offset + copy_bytes <= src->get_desc().size, "The copy range is out of the source buffer range.");
+            record_copy(src, copy_bytes);
+        }
+        void CommandBuffer::copy_texture_to_buffer(
+            IBuffer* dst, u64 dst_offset, u32 dst_row_pitch, u32 dst_slice_pitch,
+            ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+            u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            assert_copy_context();
+            lucheck_msg(test_flags(src->get_desc().usages, TextureUsageFlag::copy_source), "The source texture must have TextureUsageFlag::copy_source set.");
+            lucheck_msg(test_flags(dst->get_desc().usages, BufferUsageFlag::copy_dest), "The destination buffer must have BufferUsageFlag::copy_dest set.");
+            lucheck_msg(dst_offset + (u64)dst_slice_pitch * copy_depth <= dst->get_desc().size, "The copy range is out of the destination buffer range.");
+            record_copy(nullptr, 0);
+        }
+        void CommandBuffer::end_copy_pass()
+        {
+            assert_copy_context();
+            end_pass_timestamp();
+            m_copy_pass_begin = false;
+        }
+        void CommandBuffer::resource_barrier(Span<const BufferBarrier> buffer_barriers, Span<const TextureBarrier> texture_barriers)
+        {
+            assert_non_render_pass();
+            for ([[maybe_unused]] auto& barrier : buffer_barriers)
+            {
+                lucheck_msg(barrier.buffer, "BufferBarrier::buffer must not be nullptr.");
+            }
+            for ([[maybe_unused]] auto& barrier : texture_barriers)
+            {
+                lucheck_msg(barrier.texture, "TextureBarrier::texture must not be nullptr.");
+            }
+            ++m_statistics.num_barrier_calls;
+            m_statistics.num_barriers += buffer_barriers.size() + texture_barriers.size();
+        }
+        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+            Span<const u64> wait_values, Span<const u64> signal_values)
+        {
+            lucheck_msg(wait_values.empty() || wait_values.size() == wait_fences.size(), "wait_values must be empty or have the same size as wait_fences.");
+            lucheck_msg(signal_values.empty() || signal_values.size() == signal_fences.size(), "signal_values must be empty or have the same size as signal_fences.");
+            lucheck_msg(!m_render_pass_begin && !m_copy_pass_begin && !m_compute_pass_begin, "submit can only be called when no render, compute or copy pass is open.");
+            lucheck_msg(!m_num_open_events, "submit can only be called when all events are ended.");
+            if (m_submitted) return BasicError::bad_calling_time();
+            for (usize i = 0; i < wait_fences.size(); ++i)
+            {
+                Fence* f = cast_object<Fence>(wait_fences[i]->get_object());
+                if (f->m_type == FenceType::timeline)
+                {
+                    // Commands are executed immediately, so waiting for timeline fences is only validated. The value
+                    // may be signaled later by submissions from other threads.
+                    lucheck_msg(!wait_values.empty(), "wait_values must be specified when waiting for timeline fences.");
+                }
+                else
+                {
+                    lucheck_msg(f->get_value(), "Binary fences must be signaled before being waited.");
+                    f->set_value(0);
+                }
+            }
+            for (usize i = 0; i < signal_fences.size(); ++i)
+            {
+                Fence* f = cast_object<Fence>(signal_fences[i]->get_object());
+                if (f->m_type == FenceType::timeline)
+                {
+                    lucheck_msg(!signal_values.empty(), "signal_values must be specified when signaling timeline fences.");
+                    f->set_value(signal_values[i]);
+                }
+                else
+                {
+                    f->set_value(1);
+                }
+            }
+            m_submitted = true;
+            m_statistics.num_submits = 1;
+            m_device->add_statistics(m_statistics);
+            m_statistics = CommandRecordingStatistics();
+            return ok;
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CommandBuffer.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Resource.hpp"
+#include "PipelineState.hpp"
+#include "QueryHeap.hpp"
+#include "../../CommandBuffer.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Commands are validated and counted when being recorded, and are completed immediately when the command
+        //! buffer is submitted.
+        struct CommandBuffer : ICommandBuffer
+        {
+            lustruct("RHI::CommandBuffer", "{8e3c5a7f-b2d1-4f96-a4e0-7c9d1b6f3a28}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            u32 m_command_queue_index;
+            Name m_name;
+
+            // The attached graphic objects.
+            Vector<Ref<IDeviceChild>> m_objs;
+
+            bool m_render_pass_begin = false;
+            bool m_compute_pass_begin = false;
+            bool m_copy_pass_begin = false;
+            //! `true` if this command buffer is submitted and not reset.
+            bool m_submitted = false;
+            //! The number of events that are not ended.
+            u32 m_num_open_events = 0;
+
+            PipelineLayout* m_graphics_pipeline_layout = nullptr;
+            PipelineState* m_graphics_pipeline_state = nullptr;
+            PipelineLayout* m_compute_pipeline_layout = nullptr;
+            PipelineState* m_compute_pipeline_state = nullptr;
+            bool m_index_buffer_set = false;
+            //! The occlusion query heap of the current render pass.
+            QueryHeap* m_occlusion_query_heap = nullptr;
+
+            // Timestamp query written when the current pass ends.
+            QueryHeap* m_timestamp_query_heap = nullptr;
+            u32 m_timestamp_end_query_index = DONT_QUERY;
+
+            //! Statistics of recorded commands, added to the device statistics when this command buffer is submitted.
+            CommandRecordingStatistics m_statistics;
+
+            void init(u32 command_queue_index)
+            {
+                m_command_queue_index = command_queue_index;
+            }
+            CommandQueueType get_queue_type() const
+            {
+                return m_device->m_queues[m_command_queue_index].type;
+            }
+
+            void assert_graphcis_context()
+            {
+                lucheck_msg(m_render_pass_begin, "A graphics command can only be submitted between begin_render_pass and end_render_pass.");
+            }
+            void assert_compute_context()
+            {
+                lucheck_msg(m_compute_pass_begin, "A compute command can only be submitted between begin_compute_pass and end_compute_pass.");
+            }
+            void assert_copy_context()
+            {
+                lucheck_msg(m_copy_pass_begin, "A copy command can only be submitted between begin_copy_pass and end_copy_pass.");
+            }
+            void assert_non_render_pass()
+            {
+                lucheck_msg(!m_render_pass_begin, "This command cannot be submitted between begin_render_pass and end_render_pass.");
+            }
+            void assert_no_context()
+            {
+                lucheck_msg(!m_render_pass_begin && !m_compute_pass_begin && !m_copy_pass_begin, "This command cannot be called in a pass context.");
+            }
+            void begin_pass_timestamp(IQueryHeap* heap, u32 begin_index, u32 end_index);
+            void end_pass_timestamp();
+            void validate_draw(bool indexed);
+            void validate_indirect_buffer(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride, u32 argument_size);
+            void record_copy(IBuffer* src, u64 copy_bytes);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            // Commands are completed when the command buffer is submitted.
+            virtual void wait() override {}
+            virtual bool try_wait() override { return true; }
+            virtual u32 get_command_queue_index() override { return m_command_queue_index; }
+            virtual RV reset() override;
+            virtual void attach_device_object(IDeviceChild* obj) override;
+            virtual void begin_event(const c8* event_name) override;
+            virtual void end_event() override;
+            virtual void begin_render_pass(const RenderPassDesc& desc) override;
+            virtual void set_graphics_pipeline_layout(IPipelineLayout* pipeline_layout) override;
+            virtual void set_graphics_pipeline_state(IPipelineState* pso) override;
+            virtual void set_vertex_buffers(u32 start_slot, Span<const VertexBufferView> views) override;
+            virtual void set_index_buffer(const IndexBufferView& view) override;
+            virtual void set_graphics_descriptor_set(u32 index, IDescriptorSet* descriptor_set) override;
+            virtual void set_graphics_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
+            virtual void set_viewport(const Viewport& viewport) override;
+            virtual void set_viewports(Span<const Viewport> viewports) override;
+            virtual void set_scissor_rect(const RectI& rect) override;
+            virtual void set_scissor_rects(Span<const RectI> rects) override;
+            virtual void set_blend_factor(const Float4U& blend_factor) override;
+            virtual void set_stencil_ref(u32 stencil_ref) override;
+            virtual void draw(u32 vertex_count, u32 start_vertex_location) override;
+            virtual void draw_indexed(u32 index_count, u32 start_index_location, i32 base_vertex_location) override;
+            virtual void draw_instanced(u32 vertex_count_per_instance, u32 instance_count, u32 start_vertex_location,
+                u32 start_instance_location) override;
+            virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
+                i32 base_vertex_location, u32 start_instance_location) override;
+            virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride) override;
+            virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride) override;
+            virtual void draw_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+                u32 max_draw_count, u32 stride) override;
+            virtual void draw_indexed_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+                u32 max_draw_count, u32 stride) override;
+            virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) override;
+            virtual void end_occlusion_query(u32 index) override;
+            virtual void end_render_pass() override;
+            virtual void begin_compute_pass(const ComputePassDesc& desc) override;
+            virtual void set_compute_pipeline_layout(IPipelineLayout* pipeline_layout) override;
+            virtual void set_compute_pipeline_state(IPipelineState* pso) override;
+            virtual void set_compute_descriptor_set(u32 index, IDescriptorSet* descriptor_set) override;
+            virtual void set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
+            virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) override;
+            virtual void dispatch_indirect(IBuffer* buffer, u64 offset) override;
+            virtual void end_compute_pass() override;
+            virtual void begin_copy_pass(const CopyPassDesc& desc) override;
+            virtual void copy_resource(IResource* dst, IResource* src) override;
+            virtual void copy_buffer(
+                IBuffer* dst, u64 dst_offset,
+                IBuffer* src, u64 src_offset,
+                u64 copy_bytes) override;
+            virtual void copy_texture(
+                ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+                ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+                u32 copy_width, u32 copy_height, u32 copy_depth) override;
+            virtual void copy_buffer_to_texture(
+                ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+                IBuffer* src, u64 src_offset, u32 src_row_pitch, u32 src_slice_pitch,
+                u32 copy_width, u32 copy_height, u32 copy_depth) override;
+            virtual void copy_texture_to_buffer(
+                IBuffer* dst, u64 dst_offset, u32 dst_row_pitch, u32 dst_slice_pitch,
+                ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+                u32 copy_width, u32 copy_height, u32 copy_depth) override;
+            virtual void end_copy_pass() override;
+            virtual void resource_barrier(Span<const BufferBarrier> buffer_barriers, Span<const TextureBarrier> texture_barriers) override;
+            virtual RV submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+                Span<const u64> wait_values, Span<const u64> signal_values) override;
+        };
+    }
+}
@@ -0,0 +1,45 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Common.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "../../RHI.hpp"
+#include "../RHI.hpp"
+#include "../../NullDevice.hpp"
+#include <Luna/Runtime/Name.hpp>
+#include <Luna/Runtime/SpinLock.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The number of command queues created for every null device.
+        constexpr u32 NUM_NULL_COMMAND_QUEUES = 3;
+
+        inline void accumulate_statistics(CommandRecordingStatistics& dst, const CommandRecordingStatistics& src)
+        {
+            dst.num_submits += src.num_submits;
+            dst.num_render_passes += src.num_render_passes;
+            dst.num_compute_passes += src.num_compute_passes;
+            dst.num_copy_passes += src.num_copy_passes;
+            dst.num_draws += src.num_draws;
+            dst.num_indirect_draws += src.num_indirect_draws;
+            dst.num_dispatches += src.num_dispatches;
+            dst.num_pipeline_state_changes += src.num_pipeline_state_changes;
+            dst.num_descriptor_set_bindings += src.num_descriptor_set_bindings;
+            dst.num_barrier_calls += src.num_barrier_calls;
+            dst.num_barriers += src.num_barriers;
+            dst.num_copies += src.num_copies;
+            dst.num_bytes_uploaded += src.num_bytes_uploaded;
+            dst.num_descriptor_updates += src.num_descriptor_updates;
+            dst.num_descriptor_writes += src.num_descriptor_writes;
+            dst.num_bytes_written_by_host += src.num_bytes_written_by_host;
+            dst.num_presents += src.num_presents;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorSet.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "DescriptorSet.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV DescriptorSet::init(const DescriptorSetDesc& desc)
+        {
+            if (!desc.layout) return set_error(BasicError::bad_arguments(), "DescriptorSetDesc::layout must not be nullptr.");
+            m_layout = cast_object<DescriptorSetLayout>(desc.layout->get_object());
+            if (desc.num_variable_descriptors && !test_flags(m_layout->m_flags, DescriptorSetLayoutFlag::variable_descriptors))
+            {
+                return set_error(BasicError::bad_arguments(),
+                    "DescriptorSetDesc::num_variable_descriptors must be 0 if the layout does not have DescriptorSetLayoutFlag::variable_descriptors set.");
+            }
+            m_num_variable_descriptors = desc.num_variable_descriptors;
+            return ok;
+        }
+        RV DescriptorSet::update_descriptors(Span<const WriteDescriptorSet> writes)
+        {
+            CommandRecordingStatistics statistics;
+            for (auto& write : writes)
+            {
+                const DescriptorSetLayoutBinding* binding = m_layout->find_binding(write.binding_slot);
+                if (!binding)
+                {
+                    return set_error(BasicError::bad_arguments(), "Binding slot %u is not declared in the descriptor set layout.", write.binding_slot);
+                }
+                if (binding->type != write.type)
+                {
+                    return set_error(BasicError::bad_arguments(), "The descriptor type written to binding slot %u does not match the descriptor set layout.",
+                        write.binding_slot);
+                }
+                bool variable = test_flags(m_layout->m_flags, DescriptorSetLayoutFlag::variable_descriptors) && binding == &m_layout->m_bindings.back();
+                u32 num_descs = variable ? m_num_variable_descriptors : binding->num_descs;
+                if (write.first_array_index + write.num_descs > num_descs)
+                {
+                    return set_error(BasicError::bad_arguments(), "Descriptors [%u, %u) written to binding slot %u are out of range, the binding has %u descriptors.",
+                        write.first_array_index, write.first_array_index + write.num_descs, write.binding_slot, num_descs);
+                }
+                statistics.num_descriptor_writes += write.num_descs;
+            }
+            statistics.num_descriptor_updates = 1;
+            m_device->add_statistics(statistics);
+            return ok;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorSet.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "DescriptorSetLayout.hpp"
+#include "../../DescriptorSet.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct DescriptorSet : IDescriptorSet
+        {
+            lustruct("RHI::DescriptorSet", "{7b4d1e9c-2f6a-4c83-b0e5-9a3c6d8f1b27}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Ref<DescriptorSetLayout> m_layout;
+            u32 m_num_variable_descriptors;
+            Name m_name;
+
+            RV init(const DescriptorSetDesc& desc);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual RV update_descriptors(Span<const WriteDescriptorSet> writes) override;
+        };
+    }
+}
@@ -0,0 +1,47 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorSetLayout.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Device.hpp"
+#include "../../DescriptorSetLayout.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct DescriptorSetLayout : IDescriptorSetLayout
+        {
+            lustruct("RHI::DescriptorSetLayout", "{c2e7a4f0-9b13-4d56-8a2c-e5f1b7d0c394}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Vector<DescriptorSetLayoutBinding> m_bindings;
+            DescriptorSetLayoutFlag m_flags;
+            Name m_name;
+
+            void init(const DescriptorSetLayoutDesc& desc)
+            {
+                m_bindings.assign(desc.bindings.begin(), desc.bindings.end());
+                m_flags = desc.flags;
+            }
+            //! Finds the binding with the specified binding slot. Returns `nullptr` if not found.
+            const DescriptorSetLayoutBinding* find_binding(u32 binding_slot) const
+            {
+                for (auto& binding : m_bindings)
+                {
+                    if (binding.binding_slot == binding_slot) return &binding;
+                }
+                return nullptr;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+        };
+    }
+}
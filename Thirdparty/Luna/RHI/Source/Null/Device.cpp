@@ -0,0 +1,307 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Device.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "Device.hpp"
+#include "Adapter.hpp"
+#include "DeviceMemory.hpp"
+#include "Resource.hpp"
+#include "CommandBuffer.hpp"
+#include "PipelineLayout.hpp"
+#include "PipelineState.hpp"
+#include "DescriptorSet.hpp"
+#include "QueryHeap.hpp"
+#include "Fence.hpp"
+#include "SwapChain.hpp"
+#include <Luna/Runtime/Time.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The alignment of resources in device memory, which matches the alignment of uniform buffer data.
+        constexpr u64 NULL_RESOURCE_ALIGNMENT = 256;
+
+        void Device::init()
+        {
+            m_queues[0] = CommandQueueDesc(CommandQueueType::graphics, CommandQueueFlag::presenting);
+            m_queues[1] = CommandQueueDesc(CommandQueueType::compute, CommandQueueFlag::none);
+            m_queues[2] = CommandQueueDesc(CommandQueueType::copy, CommandQueueFlag::none);
+        }
+        u64 Device::get_buffer_size(const BufferDesc& desc)
+        {
+            return align_upper(desc.size, NULL_RESOURCE_ALIGNMENT);
+        }
+        u64 Device::get_texture_size(const TextureDesc& desc)
+        {
+            u64 size = 0;
+            for (u32 mip = 0; mip < desc.mip_levels; ++mip)
+            {
+                u64 mip_size;
+                get_texture_data_placement_info(max<u32>(desc.width >> mip, 1), max<u32>(desc.height >> mip, 1), max<u32>(desc.depth >> mip, 1),
+                    desc.format, &mip_size, nullptr, nullptr, nullptr);
+                size += mip_size;
+            }
+            return align_upper(size * desc.array_size * desc.sample_count, NULL_RESOURCE_ALIGNMENT);
+        }
+        R<u64> Device::get_memory_size(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures)
+        {
+            if (memory_type != MemoryType::local && !textures.empty())
+            {
+                return set_error(BasicError::not_supported(), "Textures cannot be created in upload or readback heaps.");
+            }
+            u64 size = 0;
+            for (auto& buffer : buffers)
+            {
+                size = max(size, get_buffer_size(buffer));
+            }
+            for (auto& texture : textures)
+            {
+                TextureDesc desc = texture;
+                auto r = validate_texture_desc(desc);
+                if (failed(r)) return r.errcode();
+                size = max(size, get_texture_size(desc));
+            }
+            return size;
+        }
+        DeviceFeatureData Device::check_feature(DeviceFeature feature)
+        {
+            DeviceFeatureData ret;
+            switch (feature)
+            {
+            case DeviceFeature::unbound_descriptor_array:
+                ret.unbound_descriptor_array = true;
+                break;
+            case DeviceFeature::pixel_shader_write:
+                ret.pixel_shader_write = true;
+                break;
+            case DeviceFeature::uniform_buffer_data_alignment:
+                ret.uniform_buffer_data_alignment = (u32)NULL_RESOURCE_ALIGNMENT;
+                break;
+            case DeviceFeature::multi_draw_indirect:
+                ret.multi_draw_indirect = true;
+                break;
+            case DeviceFeature::draw_indirect_count:
+                ret.draw_indirect_count = true;
+                break;
+            case DeviceFeature::timeline_fence:
+                ret.timeline_fence = true;
+                break;
+            default: lupanic();
+            }
+            return ret;
+        }
+        void Device::get_texture_data_placement_info(u32 width, u32 height, u32 depth, Format format,
+                u64* size, u64* alignment, u64* row_pitch, u64* slice_pitch)
+        {
+            if (alignment) *alignment = 4;
+            u64 d_row_pitch = (u64)width * (u64)bits_per_pixel(format) / 8;
+            if (row_pitch) *row_pitch = d_row_pitch;
+            u64 d_slice_pitch = d_row_pitch * height;
+            if (slice_pitch) *slice_pitch = d_slice_pitch;
+            u64 d_size = d_slice_pitch * depth;
+            if (size) *size = d_size;
+        }
+        R<Ref<IBuffer>> Device::new_buffer(MemoryType memory_type, const BufferDesc& desc)
+        {
+            Ref<IBuffer> ret;
+            lutry
+            {
+                Ref<Buffer> buffer = new_object<Buffer>();
+                buffer->m_device = this;
+                luexp(buffer->init_as_committed(memory_type, desc));
+                ret = buffer;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<ITexture>> Device::new_texture(MemoryType memory_type, const TextureDesc& desc, const ClearValue* optimized_clear_value)
+        {
+            Ref<ITexture> ret;
+            lutry
+            {
+                Ref<Texture> texture = new_object<Texture>();
+                texture->m_device = this;
+                luexp(texture->init_as_committed(memory_type, desc));
+                ret = texture;
+            }
+            lucatchret;
+            return ret;
+        }
+        bool Device::is_resources_aliasing_compatible(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures)
+        {
+            return succeeded(get_memory_size(memory_type, buffers, textures));
+        }
+        R<Ref<IDeviceMemory>> Device::allocate_memory(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures)
+        {
+            Ref<IDeviceMemory> ret;
+            lutry
+            {
+                lulet(size, get_memory_size(memory_type, buffers, textures));
+                Ref<DeviceMemory> memory = new_object<DeviceMemory>();
+                memory->m_device = this;
+                luexp(memory->init(memory_type, size));
+                ret = memory;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IBuffer>> Device::new_aliasing_buffer(IDeviceMemory* device_memory, const BufferDesc& desc)
+        {
+            Ref<IBuffer> ret;
+            lutry
+            {
+                Ref<Buffer> buffer = new_object<Buffer>();
+                buffer->m_device = this;
+                luexp(buffer->init_as_aliasing(device_memory, desc));
+                ret = buffer;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<ITexture>> Device::new_aliasing_texture(IDeviceMemory* device_memory, const TextureDesc& desc, const ClearValue* optimized_clear_value)
+        {
+            Ref<ITexture> ret;
+            lutry
+            {
+                Ref<Texture> texture = new_object<Texture>();
+                texture->m_device = this;
+                luexp(texture->init_as_aliasing(device_memory, desc));
+                ret = texture;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IPipelineLayout>> Device::new_pipeline_layout(const PipelineLayoutDesc& desc)
+        {
+            Ref<PipelineLayout> o = new_object<PipelineLayout>();
+            o->m_device = this;
+            o->init(desc);
+            return Ref<IPipelineLayout>(o);
+        }
+        R<Ref<IPipelineState>> Device::new_graphics_pipeline_state(const GraphicsPipelineStateDesc& desc)
+        {
+            Ref<IPipelineState> ret;
+            lutry
+            {
+                lucheck_msg(desc.num_color_attachments <= 8, "GraphicsPipelineStateDesc::num_color_attachments must not be greater than 8.");
+                Ref<PipelineState> o = new_object<PipelineState>();
+                o->m_device = this;
+                luexp(o->init(desc.pipeline_layout, true));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IPipelineState>> Device::new_compute_pipeline_state(const ComputePipelineStateDesc& desc)
+        {
+            Ref<IPipelineState> ret;
+            lutry
+            {
+                Ref<PipelineState> o = new_object<PipelineState>();
+                o->m_device = this;
+                luexp(o->init(desc.pipeline_layout, false));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IDescriptorSetLayout>> Device::new_descriptor_set_layout(const DescriptorSetLayoutDesc& desc)
+        {
+            Ref<DescriptorSetLayout> o = new_object<DescriptorSetLayout>();
+            o->m_device = this;
+            o->init(desc);
+            return Ref<IDescriptorSetLayout>(o);
+        }
+        R<Ref<IDescriptorSet>> Device::new_descriptor_set(const DescriptorSetDesc& desc)
+        {
+            Ref<IDescriptorSet> ret;
+            lutry
+            {
+                Ref<DescriptorSet> o = new_object<DescriptorSet>();
+                o->m_device = this;
+                luexp(o->init(desc));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        CommandQueueDesc Device::get_command_queue_desc(u32 command_queue_index)
+        {
+            lucheck_msg(command_queue_index < NUM_NULL_COMMAND_QUEUES, "The command queue index is out of range.");
+            return m_queues[command_queue_index];
+        }
+        R<Ref<ICommandBuffer>> Device::new_command_buffer(u32 command_queue_index)
+        {
+            if (command_queue_index >= NUM_NULL_COMMAND_QUEUES) return BasicError::bad_arguments();
+            Ref<CommandBuffer> buf = new_object<CommandBuffer>();
+            buf->m_device = this;
+            buf->init(command_queue_index);
+            return Ref<ICommandBuffer>(buf);
+        }
+        R<f64> Device::get_command_queue_timestamp_frequency(u32 command_queue_index)
+        {
+            // Timestamps are sampled from the CPU clock.
+            return get_ticks_per_second();
+        }
+        R<Ref<IQueryHeap>> Device::new_query_heap(const QueryHeapDesc& desc)
+        {
+            Ref<QueryHeap> heap = new_object<QueryHeap>();
+            heap->m_device = this;
+            heap->init(desc);
+            return Ref<IQueryHeap>(heap);
+        }
+        R<Ref<IFence>> Device::new_fence(FenceType type)
+        {
+            Ref<Fence> fence = new_object<Fence>();
+            fence->m_device = this;
+            fence->init(type);
+            return Ref<IFence>(fence);
+        }
+        R<Ref<ISwapChain>> Device::new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc)
+        {
+            if (command_queue_index >= NUM_NULL_COMMAND_QUEUES || !test_flags(m_queues[command_queue_index].flags, CommandQueueFlag::presenting))
+            {
+                return set_error(BasicError::bad_arguments(), "The command queue specified for the swap chain does not support presenting.");
+            }
+            Ref<ISwapChain> ret;
+            lutry
+            {
+                Ref<SwapChain> swap_chain = new_object<SwapChain>();
+                swap_chain->m_device = this;
+                luexp(swap_chain->init(window, desc));
+                ret = swap_chain;
+            }
+            lucatchret;
+            return ret;
+        }
+        LUNA_RHI_API R<Ref<IDevice>> new_device(IAdapter* adapter)
+        {
+            Ref<Device> dev = new_object<Device>();
+            dev->init();
+            return Ref<IDevice>(dev);
+        }
+        Ref<IDevice> g_main_device;
+        LUNA_RHI_API IDevice* get_main_device()
+        {
+            return g_main_device.get();
+        }
+        RV init_main_device()
+        {
+            if (!g_main_device)
+            {
+                Ref<Device> dev = new_object<Device>();
+                dev->init();
+                g_main_device = dev;
+            }
+            return ok;
+        }
+    }
+}
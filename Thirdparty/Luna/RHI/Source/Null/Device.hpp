@@ -0,0 +1,84 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Device.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Common.hpp"
+#include "../../Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct Device : IDevice, INullDevice
+        {
+            lustruct("RHI::Device", "{0d8e5b6a-3c1f-4e72-9a4d-7b2e6f1c8a95}");
+            luiimpl();
+
+            CommandQueueDesc m_queues[NUM_NULL_COMMAND_QUEUES];
+
+            CommandRecordingStatistics m_statistics;
+            SpinLock m_statistics_lock;
+
+            void init();
+
+            //! Adds statistics recorded by one command buffer or object to the device statistics.
+            void add_statistics(const CommandRecordingStatistics& statistics)
+            {
+                LockGuard guard(m_statistics_lock);
+                accumulate_statistics(m_statistics, statistics);
+            }
+            //! Computes the size of memory required by one resource.
+            u64 get_buffer_size(const BufferDesc& desc);
+            u64 get_texture_size(const TextureDesc& desc);
+            R<u64> get_memory_size(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures);
+
+            virtual DeviceFeatureData check_feature(DeviceFeature feature) override;
+            virtual void get_texture_data_placement_info(u32 width, u32 height, u32 depth, Format format,
+                u64* size, u64* alignment, u64* row_pitch, u64* slice_pitch) override;
+            virtual R<Ref<IBuffer>> new_buffer(MemoryType memory_type, const BufferDesc& desc) override;
+            virtual R<Ref<ITexture>> new_texture(MemoryType memory_type, const TextureDesc& desc, const ClearValue* optimized_clear_value) override;
+            virtual bool is_resources_aliasing_compatible(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures) override;
+            virtual R<Ref<IDeviceMemory>> allocate_memory(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures) override;
+            virtual R<Ref<IBuffer>> new_aliasing_buffer(IDeviceMemory* device_memory, const BufferDesc& desc) override;
+            virtual R<Ref<ITexture>> new_aliasing_texture(IDeviceMemory* device_memory, const TextureDesc& desc, const ClearValue* optimized_clear_value) override;
+            virtual R<Ref<IPipelineLayout>> new_pipeline_layout(const PipelineLayoutDesc& desc) override;
+            virtual R<Ref<IPipelineState>> new_graphics_pipeline_state(const GraphicsPipelineStateDesc& desc) override;
+            virtual R<Ref<IPipelineState>> new_compute_pipeline_state(const ComputePipelineStateDesc& desc) override;
+            virtual R<Ref<IDescriptorSetLayout>> new_descriptor_set_layout(const DescriptorSetLayoutDesc& desc) override;
+            virtual R<Ref<IDescriptorSet>> new_descriptor_set(const DescriptorSetDesc& desc) override;
+            // Descriptor sets are not allocated from descriptor pools in this backend.
+            virtual DescriptorPoolStatistics get_descriptor_pool_statistics() override { return DescriptorPoolStatistics(); }
+            virtual u32 get_num_command_queues() override { return NUM_NULL_COMMAND_QUEUES; }
+            virtual CommandQueueDesc get_command_queue_desc(u32 command_queue_index) override;
+            virtual R<Ref<ICommandBuffer>> new_command_buffer(u32 command_queue_index) override;
+            virtual R<f64> get_command_queue_timestamp_frequency(u32 command_queue_index) override;
+            virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
+            virtual R<Ref<IFence>> new_fence(FenceType type) override;
+            virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+            // No pipeline is compiled by this backend, so pipeline cache data is empty and ignored.
+            virtual R<Blob> get_pipeline_cache_data() override { return Blob(); }
+            virtual RV load_pipeline_cache_data(Span<const byte_t> data) override { return ok; }
+
+            virtual CommandRecordingStatistics get_statistics() override
+            {
+                LockGuard guard(m_statistics_lock);
+                return m_statistics;
+            }
+            virtual void reset_statistics() override
+            {
+                LockGuard guard(m_statistics_lock);
+                m_statistics = CommandRecordingStatistics();
+            }
+        };
+
+        extern Ref<IDevice> g_main_device;
+
+        RV init_main_device();
+    }
+}
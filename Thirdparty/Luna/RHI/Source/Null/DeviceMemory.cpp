@@ -0,0 +1,39 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DeviceMemory.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "DeviceMemory.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV DeviceMemory::init(MemoryType memory_type, u64 size)
+        {
+            m_memory_type = memory_type;
+            m_size = size;
+            if (memory_type != MemoryType::local && size)
+            {
+                m_data = memalloc((usize)size, NULL_HOST_MEMORY_ALIGNMENT);
+                if (!m_data) return BasicError::out_of_memory();
+                memzero(m_data, (usize)size);
+            }
+            return ok;
+        }
+        DeviceMemory::~DeviceMemory()
+        {
+            if (m_data)
+            {
+                memfree(m_data, NULL_HOST_MEMORY_ALIGNMENT);
+                m_data = nullptr;
+            }
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DeviceMemory.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The alignment of host memory allocated for upload and readback memory.
+        constexpr usize NULL_HOST_MEMORY_ALIGNMENT = 256;
+
+        struct DeviceMemory : IDeviceMemory
+        {
+            lustruct("RHI::DeviceMemory", "{e4c72a19-5d3b-4b80-8f6e-1a9d2c7b5e04}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            MemoryType m_memory_type;
+            u64 m_size = 0;
+            //! The host memory that backs upload and readback memory. Local memory is never accessed by host, so
+            //! no memory is allocated for it.
+            void* m_data = nullptr;
+            Name m_name;
+
+            RV init(MemoryType memory_type, u64 size);
+            ~DeviceMemory();
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual MemoryType get_memory_type() override { return m_memory_type; }
+            virtual u64 get_size() override { return m_size; }
+        };
+    }
+}
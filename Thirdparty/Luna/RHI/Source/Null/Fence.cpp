@@ -0,0 +1,45 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Fence.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "Fence.hpp"
+#include <Luna/Runtime/Time.hpp>
+#include <Luna/Runtime/Thread.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV Fence::wait(u64 value, u64 timeout)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            // The value may be signaled by another thread from host or by submitting command buffers.
+            u64 begin_ticks = get_ticks();
+            f64 ticks_per_ns = get_ticks_per_second() / 1000000000.0;
+            while (get_value() < value)
+            {
+                if (timeout != U64_MAX && (f64)(get_ticks() - begin_ticks) >= (f64)timeout * ticks_per_ns)
+                {
+                    return BasicError::timeout();
+                }
+                yield_current_thread();
+            }
+            return ok;
+        }
+        RV Fence::signal(u64 value)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            LockGuard guard(m_lock);
+            lucheck_msg(value > m_value, "The value to signal must be greater than the current value of the fence.");
+            m_value = value;
+            return ok;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Fence.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Device.hpp"
+#include "../../Fence.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Commands are completed when being submitted in this backend, so fences are signaled immediately
+        //! when the command buffer is submitted.
+        struct Fence : IFence
+        {
+            lustruct("RHI::Fence", "{2a7e9c4d-f1b8-4e63-a05d-8c3b7f2e9d16}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            FenceType m_type = FenceType::binary;
+            //! The timeline value for timeline fences, or 1 if one binary fence is signaled.
+            u64 m_value = 0;
+            SpinLock m_lock;
+            Name m_name;
+
+            void init(FenceType type)
+            {
+                m_type = type;
+            }
+            void set_value(u64 value)
+            {
+                LockGuard guard(m_lock);
+                m_value = value;
+            }
+            u64 get_value()
+            {
+                LockGuard guard(m_lock);
+                return m_value;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual FenceType get_type() override { return m_type; }
+            virtual u64 get_completed_value() override
+            {
+                return m_type == FenceType::timeline ? get_value() : 0;
+            }
+            virtual RV wait(u64 value, u64 timeout) override;
+            virtual RV signal(u64 value) override;
+        };
+    }
+}
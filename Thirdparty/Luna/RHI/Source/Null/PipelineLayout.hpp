@@ -0,0 +1,39 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PipelineLayout.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "DescriptorSetLayout.hpp"
+#include "../../PipelineLayout.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct PipelineLayout : IPipelineLayout
+        {
+            lustruct("RHI::PipelineLayout", "{e9a3b6c1-4d70-4f2e-8c15-b6d2a0f7e348}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Vector<Ref<DescriptorSetLayout>> m_descriptor_set_layouts;
+            Name m_name;
+
+            void init(const PipelineLayoutDesc& desc)
+            {
+                for (IDescriptorSetLayout* layout : desc.descriptor_set_layouts)
+                {
+                    m_descriptor_set_layouts.push_back(cast_object<DescriptorSetLayout>(layout->get_object()));
+                }
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+        };
+    }
+}
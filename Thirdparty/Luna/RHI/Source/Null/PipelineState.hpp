@@ -0,0 +1,42 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PipelineState.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "PipelineLayout.hpp"
+#include "../../PipelineState.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Shaders are not compiled by this backend, the pipeline state only records information used to validate commands.
+        struct PipelineState : IPipelineState
+        {
+            lustruct("RHI::PipelineState", "{5c0f8e2b-a7d4-4193-b6e8-2d9f1c4a7b50}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Ref<PipelineLayout> m_pipeline_layout;
+            //! `true` for graphics pipelines, `false` for compute pipelines.
+            bool m_is_graphics;
+            Name m_name;
+
+            RV init(IPipelineLayout* pipeline_layout, bool is_graphics)
+            {
+                if (!pipeline_layout) return set_error(BasicError::bad_arguments(), "The pipeline layout of one pipeline state must not be nullptr.");
+                m_pipeline_layout = cast_object<PipelineLayout>(pipeline_layout->get_object());
+                m_is_graphics = is_graphics;
+                return ok;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+        };
+    }
+}
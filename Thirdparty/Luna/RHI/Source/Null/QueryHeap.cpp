@@ -0,0 +1,40 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file QueryHeap.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "QueryHeap.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV QueryHeap::get_timestamp_values(u32 index, u32 count, u64* values)
+        {
+            if (m_desc.type != QueryType::timestamp && m_desc.type != QueryType::timestamp_copy_queue) return BasicError::not_supported();
+            if (index + count > m_desc.count) return BasicError::out_of_range();
+            memcpy(values, m_timestamps.data() + index, sizeof(u64) * count);
+            return ok;
+        }
+        RV QueryHeap::get_occlusion_values(u32 index, u32 count, u64* values)
+        {
+            if (m_desc.type != QueryType::occlusion) return BasicError::not_supported();
+            if (index + count > m_desc.count) return BasicError::out_of_range();
+            memzero(values, sizeof(u64) * count);
+            return ok;
+        }
+        RV QueryHeap::get_pipeline_statistics_values(u32 index, u32 count, PipelineStatistics* values)
+        {
+            if (m_desc.type != QueryType::pipeline_statistics) return BasicError::not_supported();
+            if (index + count > m_desc.count) return BasicError::out_of_range();
+            memzero(values, sizeof(PipelineStatistics) * count);
+            return ok;
+        }
+    }
+}
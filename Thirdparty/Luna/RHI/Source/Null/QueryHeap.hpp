@@ -0,0 +1,53 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file QueryHeap.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Device.hpp"
+#include "../../QueryHeap.hpp"
+#include <Luna/Runtime/Time.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Timestamp queries record the CPU time when the command is recorded, occlusion and pipeline statistics
+        //! queries always return 0, since no command is executed by this backend.
+        struct QueryHeap : IQueryHeap
+        {
+            lustruct("RHI::QueryHeap", "{b1d6f3a8-0e29-47c5-9f4b-6a8e2c1d7f93}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            QueryHeapDesc m_desc;
+            Vector<u64> m_timestamps;
+            Name m_name;
+
+            void init(const QueryHeapDesc& desc)
+            {
+                m_desc = desc;
+                if (desc.type == QueryType::timestamp || desc.type == QueryType::timestamp_copy_queue)
+                {
+                    m_timestamps.resize(desc.count, (u64)0);
+                }
+            }
+            void write_timestamp(u32 index)
+            {
+                lucheck_msg(index < m_timestamps.size(), "The timestamp query index is out of range.");
+                m_timestamps[index] = get_ticks();
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual QueryHeapDesc get_desc() override { return m_desc; }
+            virtual RV get_timestamp_values(u32 index, u32 count, u64* values) override;
+            virtual RV get_occlusion_values(u32 index, u32 count, u64* values) override;
+            virtual RV get_pipeline_statistics_values(u32 index, u32 count, PipelineStatistics* values) override;
+        };
+    }
+}
@@ -0,0 +1,100 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Resource.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "Resource.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV Buffer::init_as_committed(MemoryType memory_type, const BufferDesc& desc)
+        {
+            if (!desc.size) return set_error(BasicError::bad_arguments(), "Invalid BufferDesc: size must not be 0.");
+            m_desc = desc;
+            m_memory = new_object<DeviceMemory>();
+            m_memory->m_device = m_device;
+            return m_memory->init(memory_type, m_device->get_buffer_size(desc));
+        }
+        RV Buffer::init_as_aliasing(IDeviceMemory* memory, const BufferDesc& desc)
+        {
+            if (!desc.size) return set_error(BasicError::bad_arguments(), "Invalid BufferDesc: size must not be 0.");
+            DeviceMemory* m = cast_object<DeviceMemory>(memory->get_object());
+            if (m->m_size < m_device->get_buffer_size(desc))
+            {
+                return set_error(BasicError::bad_arguments(), "The device memory is too small to hold the buffer.");
+            }
+            m_desc = desc;
+            m_desc.flags |= ResourceFlag::allow_aliasing;
+            m_memory = m;
+            return ok;
+        }
+        RV Buffer::map(usize read_begin, usize read_end, void** data)
+        {
+            if (m_memory->m_memory_type == MemoryType::local)
+            {
+                return set_error(BasicError::not_supported(), "Buffers in local memory cannot be mapped.");
+            }
+            lucheck_msg(read_end <= read_begin || m_memory->m_memory_type == MemoryType::readback,
+                "Only buffers in readback memory can be read by host.");
+            if (data) *data = m_memory->m_data;
+            return ok;
+        }
+        void Buffer::unmap(usize write_begin, usize write_end)
+        {
+            write_end = min<usize>(write_end, (usize)m_desc.size);
+            if (write_end > write_begin)
+            {
+                lucheck_msg(m_memory->m_memory_type == MemoryType::upload, "Only buffers in upload memory can be written by host.");
+                CommandRecordingStatistics statistics;
+                statistics.num_bytes_written_by_host = write_end - write_begin;
+                m_device->add_statistics(statistics);
+            }
+        }
+        RV Texture::init_as_committed(MemoryType memory_type, const TextureDesc& desc)
+        {
+            if (memory_type != MemoryType::local)
+            {
+                return set_error(BasicError::not_supported(), "Textures can only be created in local memory.");
+            }
+            m_desc = desc;
+            lutry
+            {
+                luexp(validate_texture_desc(m_desc));
+                m_memory = new_object<DeviceMemory>();
+                m_memory->m_device = m_device;
+                luexp(m_memory->init(memory_type, m_device->get_texture_size(m_desc)));
+            }
+            lucatchret;
+            return ok;
+        }
+        RV Texture::init_as_aliasing(IDeviceMemory* memory, const TextureDesc& desc)
+        {
+            DeviceMemory* m = cast_object<DeviceMemory>(memory->get_object());
+            if (m->m_memory_type != MemoryType::local)
+            {
+                return set_error(BasicError::not_supported(), "Textures can only be created in local memory.");
+            }
+            m_desc = desc;
+            lutry
+            {
+                luexp(validate_texture_desc(m_desc));
+                if (m->m_size < m_device->get_texture_size(m_desc))
+                {
+                    return set_error(BasicError::bad_arguments(), "The device memory is too small to hold the texture.");
+                }
+                m_desc.flags |= ResourceFlag::allow_aliasing;
+                m_memory = m;
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Resource.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "DeviceMemory.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct Buffer : IBuffer
+        {
+            lustruct("RHI::Buffer", "{3f9a6d21-7e05-4c8b-b2a4-5d1e8c0f7a36}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            BufferDesc m_desc;
+            Ref<DeviceMemory> m_memory;
+            Name m_name;
+
+            RV init_as_committed(MemoryType memory_type, const BufferDesc& desc);
+            RV init_as_aliasing(IDeviceMemory* memory, const BufferDesc& desc);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual IDeviceMemory* get_memory() override { return m_memory; }
+            virtual BufferDesc get_desc() override { return m_desc; }
+            virtual RV map(usize read_begin, usize read_end, void** data) override;
+            virtual void unmap(usize write_begin, usize write_end) override;
+        };
+        struct Texture : ITexture
+        {
+            lustruct("RHI::Texture", "{a8d0c5e7-16b2-4f3d-9e7a-c4b1f6d2e859}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            TextureDesc m_desc;
+            Ref<DeviceMemory> m_memory;
+            Name m_name;
+
+            RV init_as_committed(MemoryType memory_type, const TextureDesc& desc);
+            RV init_as_aliasing(IDeviceMemory* memory, const TextureDesc& desc);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual IDeviceMemory* get_memory() override { return m_memory; }
+            virtual TextureDesc get_desc() override { return m_desc; }
+        };
+    }
+}
@@ -0,0 +1,74 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file SwapChain.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "SwapChain.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV SwapChain::init(Window::IWindow* window, const SwapChainDesc& desc)
+        {
+            m_window = window;
+            SwapChainDesc new_desc = desc;
+            if (m_window)
+            {
+                auto framebuffer_size = m_window->get_framebuffer_size();
+                new_desc.width = new_desc.width == 0 ? framebuffer_size.x : new_desc.width;
+                new_desc.height = new_desc.height == 0 ? framebuffer_size.y : new_desc.height;
+            }
+            new_desc.buffer_count = new_desc.buffer_count == 0 ? 2 : new_desc.buffer_count;
+            new_desc.format = new_desc.format == Format::unknown ? Format::bgra8_unorm_srgb : new_desc.format;
+            return create_back_buffers(new_desc);
+        }
+        RV SwapChain::create_back_buffers(const SwapChainDesc& desc)
+        {
+            if (!desc.width || !desc.height)
+            {
+                return set_error(BasicError::bad_arguments(), "The swap chain size must be specified if the swap chain is not bound to one window.");
+            }
+            Vector<Ref<Texture>> back_buffers;
+            lutry
+            {
+                for (u32 i = 0; i < desc.buffer_count; ++i)
+                {
+                    Ref<Texture> tex = new_object<Texture>();
+                    tex->m_device = m_device;
+                    luexp(tex->init_as_committed(MemoryType::local, TextureDesc::tex2d(desc.format,
+                        TextureUsageFlag::color_attachment | TextureUsageFlag::copy_source | TextureUsageFlag::copy_dest, desc.width, desc.height, 1, 1)));
+                    back_buffers.push_back(move(tex));
+                }
+            }
+            lucatchret;
+            m_back_buffers = move(back_buffers);
+            m_current_back_buffer = 0;
+            m_desc = desc;
+            return ok;
+        }
+        RV SwapChain::present()
+        {
+            m_current_back_buffer = (m_current_back_buffer + 1) % (u32)m_back_buffers.size();
+            CommandRecordingStatistics statistics;
+            statistics.num_presents = 1;
+            m_device->add_statistics(statistics);
+            return ok;
+        }
+        RV SwapChain::reset(const SwapChainDesc& desc)
+        {
+            SwapChainDesc new_desc = desc;
+            if (!new_desc.width) new_desc.width = m_window ? m_window->get_framebuffer_size().x : m_desc.width;
+            if (!new_desc.height) new_desc.height = m_window ? m_window->get_framebuffer_size().y : m_desc.height;
+            if (!new_desc.buffer_count) new_desc.buffer_count = m_desc.buffer_count;
+            if (new_desc.format == Format::unknown) new_desc.format = m_desc.format;
+            return create_back_buffers(new_desc);
+        }
+    }
+}
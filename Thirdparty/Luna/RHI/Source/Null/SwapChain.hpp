@@ -0,0 +1,46 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file SwapChain.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Resource.hpp"
+#include "../../SwapChain.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Back buffers of the swap chain are offscreen textures, nothing is displayed when presenting.
+        struct SwapChain : ISwapChain
+        {
+            lustruct("RHI::SwapChain", "{d5f2b8e4-6c07-4a91-b3d8-1e7a4c9f2b65}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Ref<Window::IWindow> m_window;
+            SwapChainDesc m_desc;
+            Vector<Ref<Texture>> m_back_buffers;
+            u32 m_current_back_buffer = 0;
+            Name m_name;
+
+            RV init(Window::IWindow* window, const SwapChainDesc& desc);
+            RV create_back_buffers(const SwapChainDesc& desc);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override { m_name = name; }
+            virtual Window::IWindow* get_window() override { return m_window; }
+            virtual SwapChainDesc get_desc() override { return m_desc; }
+            virtual R<ITexture*> get_current_back_buffer() override
+            {
+                return m_back_buffers[m_current_back_buffer].get();
+            }
+            virtual RV present() override;
+            virtual RV reset(const SwapChainDesc& desc) override;
+        };
+    }
+}
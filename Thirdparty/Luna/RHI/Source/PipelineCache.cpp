@@ -0,0 +1,49 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PipelineCache.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "../Device.hpp"
+#include <Luna/VFS/VFS.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        LUNA_RHI_API RV load_pipeline_cache(IDevice* device, const Path& path)
+        {
+            lutry
+            {
+                auto f = VFS::open_file(path, FileOpenFlag::read, FileCreationMode::open_existing);
+                if (failed(f))
+                {
+                    // No pipeline cache is saved yet.
+                    if (f.errcode() == BasicError::not_found()) return ok;
+                    return f.errcode();
+                }
+                lulet(data, load_file_data(f.get()));
+                luexp(device->load_pipeline_cache_data({ (const byte_t*)data.data(), data.size() }));
+            }
+            lucatchret;
+            return ok;
+        }
+        LUNA_RHI_API RV save_pipeline_cache(IDevice* device, const Path& path)
+        {
+            lutry
+            {
+                lulet(data, device->get_pipeline_cache_data());
+                if (data.empty()) return ok;
+                lulet(f, VFS::open_file(path, FileOpenFlag::write, FileCreationMode::create_always));
+                luexp(f->write(data.data(), data.size()));
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
@@ -12,6 +12,8 @@
 #include "RHI.hpp"
 #include <Luna/Runtime/Module.hpp>
 #include "../DescriptorSet.hpp"
+#include "UploadRingBuffer.hpp"
+#include <Luna/VFS/VFS.hpp>
 namespace Luna
 {
     namespace RHI
@@ -21,10 +23,12 @@ namespace Luna
             virtual const c8* get_name() override { return "RHI"; }
             virtual RV on_register() override
             {
-                return add_dependency_module(this, module_window());
+                return add_dependency_modules(this, {module_window(), module_vfs()});
             }
             virtual RV on_init() override
             {
+                register_boxed_type<UploadRingBuffer>();
+                impl_interface_for_type<UploadRingBuffer, IUploadRingBuffer>();
                 return render_api_init();
             }
             virtual void on_close() override
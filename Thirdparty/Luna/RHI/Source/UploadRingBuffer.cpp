@@ -0,0 +1,199 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file UploadRingBuffer.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "UploadRingBuffer.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The minimum alignment of allocations if the device does not require uniform buffer alignment.
+        constexpr u64 MIN_UPLOAD_ALIGNMENT = 16;
+
+        RV UploadRingBuffer::init(IDevice* device, const UploadRingBufferDesc& desc)
+        {
+            m_device = device;
+            m_desc = desc;
+            if (!m_desc.default_alignment)
+            {
+                m_desc.default_alignment = max<u64>(device->check_feature(DeviceFeature::uniform_buffer_data_alignment).uniform_buffer_data_alignment,
+                    MIN_UPLOAD_ALIGNMENT);
+            }
+            lutry
+            {
+                u64 size = max<u64>(m_desc.size, m_desc.default_alignment);
+                void* data;
+                lulet(buffer, create_buffer(size, data));
+                set_buffer(buffer, data, size);
+            }
+            lucatchret;
+            return ok;
+        }
+        UploadRingBuffer::~UploadRingBuffer()
+        {
+            for (auto& frame : m_frames)
+            {
+                for (auto& buffer : frame.m_retired_buffers) buffer->unmap(0, USIZE_MAX);
+            }
+            for (auto& buffer : m_retired_buffers) buffer->unmap(0, USIZE_MAX);
+            if (m_buffer) m_buffer->unmap(0, USIZE_MAX);
+        }
+        R<Ref<IBuffer>> UploadRingBuffer::create_buffer(u64 size, void*& mapped_data)
+        {
+            Ref<IBuffer> ret;
+            lutry
+            {
+                luset(ret, m_device->new_buffer(MemoryType::upload, BufferDesc(m_desc.usages, size)));
+                // The buffer is kept mapped until it is released.
+                luexp(ret->map(0, 0, &mapped_data));
+            }
+            lucatchret;
+            return ret;
+        }
+        void UploadRingBuffer::set_buffer(IBuffer* buffer, void* mapped_data, u64 size)
+        {
+            m_buffer = buffer;
+            m_mapped_data = mapped_data;
+            m_capacity = size;
+            m_head = 0;
+            m_tail = 0;
+            ++m_generation;
+            ++m_num_buffer_creations;
+        }
+        void UploadRingBuffer::retire_completed_frames()
+        {
+            // Frames are completed in order, so stop at the first frame that is not completed.
+            while (!m_frames.empty())
+            {
+                auto& frame = m_frames.front();
+                if (frame.m_fence && frame.m_fence->get_completed_value() < frame.m_fence_value) break;
+                if (frame.m_generation == m_generation)
+                {
+                    m_tail = frame.m_end;
+                }
+                for (auto& buffer : frame.m_retired_buffers) buffer->unmap(0, USIZE_MAX);
+                m_frames.pop_front();
+            }
+        }
+        bool UploadRingBuffer::try_allocate(u64 size, u64 alignment, u64& offset)
+        {
+            if (size > m_capacity) return false;
+            u64 physical = m_head % m_capacity;
+            u64 aligned = align_upper(physical, alignment);
+            u64 begin;
+            if (aligned + size > m_capacity)
+            {
+                // Skip the remaining space and allocate from the beginning of the buffer.
+                begin = m_head + (m_capacity - physical);
+            }
+            else
+            {
+                begin = m_head + (aligned - physical);
+            }
+            u64 end = begin + size;
+            if (end - m_tail > m_capacity) return false;
+            offset = begin % m_capacity;
+            m_head = end;
+            return true;
+        }
+        R<UploadRingBufferAllocation> UploadRingBuffer::allocate(u64 size, u64 alignment)
+        {
+            if (!size) return BasicError::bad_arguments();
+            if (!alignment) alignment = m_desc.default_alignment;
+            UploadRingBufferAllocation ret;
+            lutry
+            {
+                LockGuard guard(m_lock);
+                u64 offset;
+                while (!try_allocate(size, alignment, offset))
+                {
+                    retire_completed_frames();
+                    if (try_allocate(size, alignment, offset)) break;
+                    // Replace the buffer with a larger one. The buffer is created without holding the lock, so that 
+                    // other threads are not blocked by the device.
+                    u64 generation = m_generation;
+                    u64 new_size = max(m_capacity * 2, align_upper(size, alignment));
+                    guard.unlock();
+                    void* data;
+                    lulet(buffer, create_buffer(new_size, data));
+                    guard = m_lock;
+                    if (m_generation != generation)
+                    {
+                        // The buffer is replaced by another thread, so try to allocate from that buffer.
+                        buffer->unmap(0, USIZE_MAX);
+                        continue;
+                    }
+                    // Allocations of the current frame and pending frames may still be used, so the old buffer 
+                    // is released when the current frame is completed.
+                    m_retired_buffers.push_back(m_buffer);
+                    set_buffer(buffer, data, new_size);
+                }
+                ++m_num_frame_allocations;
+                ret.buffer = m_buffer.get();
+                ret.offset = offset;
+                ret.size = size;
+                ret.data = (u8*)m_mapped_data + offset;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<UploadRingBufferAllocation> UploadRingBuffer::upload(const void* data, u64 size, u64 alignment)
+        {
+            auto allocation = allocate(size, alignment);
+            if (succeeded(allocation))
+            {
+                memcpy(allocation.get().data, data, (usize)size);
+            }
+            return allocation;
+        }
+        RV UploadRingBuffer::end_frame(IFence* fence, u64 fence_value)
+        {
+            if (fence && fence->get_type() != FenceType::timeline)
+            {
+                return set_error(BasicError::bad_arguments(), "The fence passed to IUploadRingBuffer::end_frame must be a timeline fence.");
+            }
+            LockGuard guard(m_lock);
+            UploadRingBufferFrame frame;
+            frame.m_fence = fence;
+            frame.m_fence_value = fence_value;
+            frame.m_end = m_head;
+            frame.m_generation = m_generation;
+            frame.m_retired_buffers = move(m_retired_buffers);
+            m_frames.push_back(move(frame));
+            m_num_frame_allocations = 0;
+            retire_completed_frames();
+            return ok;
+        }
+        UploadRingBufferStatistics UploadRingBuffer::get_statistics()
+        {
+            LockGuard guard(m_lock);
+            UploadRingBufferStatistics ret;
+            ret.capacity = m_capacity;
+            ret.used_size = m_head - m_tail;
+            ret.num_pending_frames = (u32)m_frames.size();
+            ret.num_frame_allocations = m_num_frame_allocations;
+            ret.num_buffer_creations = m_num_buffer_creations;
+            return ret;
+        }
+        LUNA_RHI_API R<Ref<IUploadRingBuffer>> new_upload_ring_buffer(IDevice* device, const UploadRingBufferDesc& desc)
+        {
+            Ref<IUploadRingBuffer> ret;
+            lutry
+            {
+                Ref<UploadRingBuffer> ring = new_object<UploadRingBuffer>();
+                luexp(ring->init(device, desc));
+                ret = ring;
+            }
+            lucatchret;
+            return ret;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file UploadRingBuffer.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "../UploadRingBuffer.hpp"
+#include <Luna/Runtime/RingDeque.hpp>
+#include <Luna/Runtime/SpinLock.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct UploadRingBufferFrame
+        {
+            //! The fence to check for completion, `nullptr` if the frame is completed when being ended.
+            Ref<IFence> m_fence;
+            u64 m_fence_value;
+            //! The ring position after the last allocation of this frame.
+            u64 m_end;
+            //! The generation of the upload buffer when this frame is ended.
+            u64 m_generation;
+            //! Upload buffers replaced in this frame, released when this frame is completed.
+            Vector<Ref<IBuffer>> m_retired_buffers;
+        };
+
+        struct UploadRingBuffer : IUploadRingBuffer
+        {
+            lustruct("RHI::UploadRingBuffer", "{8f5b2c71-6d0e-4b3a-a1c9-3e7f2d5b9a64}");
+            luiimpl();
+
+            Ref<IDevice> m_device;
+            UploadRingBufferDesc m_desc;
+
+            Ref<IBuffer> m_buffer;
+            void* m_mapped_data = nullptr;
+            u64 m_capacity = 0;
+            //! Increased every time the upload buffer is replaced.
+            u64 m_generation = 0;
+
+            // Ring positions are counted in bytes since the current buffer is created and never wrap, the physical
+            // offset is computed by `position % m_capacity`.
+            u64 m_head = 0;
+            u64 m_tail = 0;
+
+            //! Buffers replaced in the current frame.
+            Vector<Ref<IBuffer>> m_retired_buffers;
+            RingDeque<UploadRingBufferFrame> m_frames;
+
+            u64 m_num_frame_allocations = 0;
+            u64 m_num_buffer_creations = 0;
+
+            SpinLock m_lock;
+
+            RV init(IDevice* device, const UploadRingBufferDesc& desc);
+            ~UploadRingBuffer();
+
+            //! Creates one upload buffer and maps it. This does not modify the ring, so it can be called without holding the lock.
+            R<Ref<IBuffer>> create_buffer(u64 size, void*& mapped_data);
+            //! Replaces the current upload buffer with the specified buffer.
+            void set_buffer(IBuffer* buffer, void* mapped_data, u64 size);
+            void retire_completed_frames();
+            //! Tries to allocate the range from the current buffer. Returns `false` if the memory is not enough.
+            bool try_allocate(u64 size, u64 alignment, u64& offset);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual const UploadRingBufferDesc& get_desc() override { return m_desc; }
+            virtual R<UploadRingBufferAllocation> allocate(u64 size, u64 alignment) override;
+            virtual R<UploadRingBufferAllocation> upload(const void* data, u64 size, u64 alignment) override;
+            virtual RV end_frame(IFence* fence, u64 fence_value) override;
+            virtual UploadRingBufferStatistics get_statistics() override;
+        };
+    }
+}
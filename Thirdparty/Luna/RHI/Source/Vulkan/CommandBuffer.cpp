@@ -633,6 +633,40 @@ namespace Luna
             m_device->m_funcs.vkCmdDrawIndexed(m_command_buffer, index_count_per_instance * instance_count, instance_count, 
                 start_index_location, base_vertex_location, start_instance_location);
         }
+        void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride)
+        {
+            assert_graphcis_context();
+            lucheck_msg(draw_count <= 1 || m_device->m_physical_device_features.multiDrawIndirect,
+                "DeviceFeature::multi_draw_indirect is required if draw_count is greater than 1.");
+            BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+            m_device->m_funcs.vkCmdDrawIndirect(m_command_buffer, b->m_buffer, offset, draw_count, stride);
+        }
+        void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 draw_count, u32 stride)
+        {
+            assert_graphcis_context();
+            lucheck_msg(draw_count <= 1 || m_device->m_physical_device_features.multiDrawIndirect,
+                "DeviceFeature::multi_draw_indirect is required if draw_count is greater than 1.");
+            BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+            m_device->m_funcs.vkCmdDrawIndexedIndirect(m_command_buffer, b->m_buffer, offset, draw_count, stride);
+        }
+        void CommandBuffer::draw_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+            u32 max_draw_count, u32 stride)
+        {
+            assert_graphcis_context();
+            lucheck_msg(m_device->m_vkCmdDrawIndirectCount, "DeviceFeature::draw_indirect_count is not supported.");
+            BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+            BufferResource* c = cast_object<BufferResource>(count_buffer->get_object());
+            m_device->m_vkCmdDrawIndirectCount(m_command_buffer, b->m_buffer, offset, c->m_buffer, count_buffer_offset, max_draw_count, stride);
+        }
+        void CommandBuffer::draw_indexed_indirect_count(IBuffer* buffer, u64 offset, IBuffer* count_buffer, u64 count_buffer_offset,
+            u32 max_draw_count, u32 stride)
+        {
+            assert_graphcis_context();
+            lucheck_msg(m_device->m_vkCmdDrawIndexedIndirectCount, "DeviceFeature::draw_indirect_count is not supported.");
+            BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+            BufferResource* c = cast_object<BufferResource>(count_buffer->get_object());
+            m_device->m_vkCmdDrawIndexedIndirectCount(m_command_buffer, b->m_buffer, offset, c->m_buffer, count_buffer_offset, max_draw_count, stride);
+        }
         void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
         {
             assert_graphcis_context();
@@ -722,6 +756,12 @@ namespace Luna
             assert_compute_context();
             m_device->m_funcs.vkCmdDispatch(m_command_buffer, thread_group_count_x, thread_group_count_y, thread_group_count_z);
         }
+        void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+        {
+            assert_compute_context();
+            BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+            m_device->m_funcs.vkCmdDispatchIndirect(m_command_buffer, b->m_buffer, offset);
+        }
         void CommandBuffer::end_compute_pass()
         {
             lucheck_msg(m_compute_pass_begin, "Calling end_compute_pass without prior call to begin_compute_pass.");
@@ -939,8 +979,11 @@ namespace Luna
                     m_track_system.m_image_barriers.size(), m_track_system.m_image_barriers.data());
             }
         }
-        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting)
+        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting,
+            Span<const u64> wait_values, Span<const u64> signal_values)
         {
+            lucheck_msg(wait_values.empty() || wait_values.size() == wait_fences.size(), "wait_values must be empty or have the same size as wait_fences.");
+            lucheck_msg(signal_values.empty() || signal_values.size() == signal_fences.size(), "signal_values must be empty or have the same size as signal_fences.");
             lucheck_msg(!m_render_pass_begin && !m_copy_pass_begin && !m_compute_pass_begin, "submit can only be called when no render, compute or copy pass is open.");
             if (!m_recording) return BasicError::bad_calling_time();
             lutry
@@ -963,9 +1006,11 @@ namespace Luna
                 Vector<VkPipelineStageFlags> wait_stages;
 
                 bool resolve_enabled = false;
-                if (!m_track_system.m_unresolved_image_states.empty() || !m_track_system.m_unresolved_buffer_states.empty())
+                if (m_track_system.has_tracked_resources())
                 {
-                    // Resolve image states.
+                    // Resolve image states. The resolve command buffer is submitted only if any barrier is generated, 
+                    // which is not the case if all first barriers are recorded, or all resources are already in the 
+                    // requested states.
                     m_track_system.resolve();
                     if (!m_track_system.m_buffer_barriers.empty() || !m_track_system.m_image_barriers.empty())
                     {
@@ -1006,11 +1051,39 @@ namespace Luna
                     }
                 }
                 // Submit the command buffer.
+                // Semaphores for queue ownership transfers are binary semaphores, whose values are ignored.
+                Vector<u64> wait_semaphore_values(wait_semaphores.size(), (u64)0);
+                bool use_timeline_semaphores = false;
                 for (usize i = 0; i < wait_fences.size(); ++i)
                 {
                     Fence* fence = (Fence*)wait_fences[i]->get_object();
                     wait_semaphores.push_back(fence->m_semaphore);
                     wait_stages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+                    u64 value = 0;
+                    if (fence->m_type == FenceType::timeline)
+                    {
+                        lucheck_msg(!wait_values.empty(), "wait_values must be specified when waiting for timeline fences.");
+                        value = wait_values[i];
+                        use_timeline_semaphores = true;
+                    }
+                    wait_semaphore_values.push_back(value);
+                }
+                u64* signal_semaphore_values = nullptr;
+                if (!signal_fences.empty())
+                {
+                    signal_semaphore_values = (u64*)alloca(sizeof(u64) * signal_fences.size());
+                    for (usize i = 0; i < signal_fences.size(); ++i)
+                    {
+                        Fence* fence = (Fence*)signal_fences[i]->get_object();
+                        u64 value = 0;
+                        if (fence->m_type == FenceType::timeline)
+                        {
+                            lucheck_msg(!signal_values.empty(), "signal_values must be specified when signaling timeline fences.");
+                            value = signal_values[i];
+                            use_timeline_semaphores = true;
+                        }
+                        signal_semaphore_values[i] = value;
+                    }
                 }
                 VkSubmitInfo submit{};
                 submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -1029,6 +1102,16 @@ namespace Luna
                     }
                 }
                 submit.pSignalSemaphores = signal_semaphores;
+                VkTimelineSemaphoreSubmitInfoKHR timeline_info{};
+                if (use_timeline_semaphores)
+                {
+                    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+                    timeline_info.waitSemaphoreValueCount = (u32)wait_semaphore_values.size();
+                    timeline_info.pWaitSemaphoreValues = wait_semaphore_values.data();
+                    timeline_info.signalSemaphoreValueCount = (u32)signal_fences.size();
+                    timeline_info.pSignalSemaphoreValues = signal_semaphore_values;
+                    submit.pNext = &timeline_info;
+                }
                 VkCommandBuffer buffers[2] = { m_resolve_buffer , m_command_buffer };
                 if (resolve_enabled)
                 {
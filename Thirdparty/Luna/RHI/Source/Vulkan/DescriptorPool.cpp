@@ -0,0 +1,214 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorPool.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include "DescriptorPool.hpp"
+#include "Device.hpp"
+#include "DescriptorSetLayout.hpp"
+#include <Luna/Runtime/Thread.hpp>
+#include <Luna/Runtime/Time.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        // The number of descriptors of every type per descriptor set in new pools, in 1/8 descriptors.
+        constexpr u32 DESCRIPTOR_POOL_TYPE_RATIOS[NUM_DESCRIPTOR_POOL_TYPES] = { 1, 8, 1, 8, 1 };
+        constexpr u32 MAX_DESCRIPTOR_POOL_SIZE = 8192;
+
+        // Called when one thread exits, so that the current pool of the thread can be used by other threads.
+        static void release_thread_pool(void* ptr)
+        {
+            DescriptorPool* pool = (DescriptorPool*)ptr;
+            LockGuard guard(pool->m_lock);
+            pool->m_assigned = false;
+        }
+        RV DescriptorPoolAllocator::init(Device* device)
+        {
+            m_device = device;
+            m_pools_mtx = new_mutex();
+            m_tls_pool = tls_alloc(release_thread_pool);
+            m_tls_transient_pool = tls_alloc(release_thread_pool);
+            return ok;
+        }
+        void DescriptorPoolAllocator::clean_up()
+        {
+            for (auto& pool : m_pools)
+            {
+                m_device->m_funcs.vkDestroyDescriptorPool(m_device->m_device, pool->m_pool, nullptr);
+            }
+            m_pools.clear();
+            if (m_tls_pool)
+            {
+                tls_free(m_tls_pool);
+                m_tls_pool = nullptr;
+            }
+            if (m_tls_transient_pool)
+            {
+                tls_free(m_tls_transient_pool);
+                m_tls_transient_pool = nullptr;
+            }
+        }
+        R<DescriptorPool*> DescriptorPoolAllocator::acquire_pool(bool transient, const u32* descriptor_counts, bool& is_new_pool)
+        {
+            MutexGuard guard(m_pools_mtx);
+            for (auto& pool : m_pools)
+            {
+                if (pool->m_transient != transient) continue;
+                bool fit = true;
+                for (u32 i = 0; i < NUM_DESCRIPTOR_POOL_TYPES; ++i)
+                {
+                    if (pool->m_descriptor_counts[i] < descriptor_counts[i])
+                    {
+                        fit = false;
+                        break;
+                    }
+                }
+                if (!fit) continue;
+                LockGuard pool_guard(pool->m_lock);
+                if (pool->m_full || pool->m_assigned) continue;
+                pool->m_assigned = true;
+                is_new_pool = false;
+                return pool.get();
+            }
+            // Create one new pool. Pools grow geometrically so that the number of pools stays small.
+            UniquePtr<DescriptorPool> pool(memnew<DescriptorPool>());
+            pool->m_transient = transient;
+            pool->m_max_sets = m_next_pool_size;
+            m_next_pool_size = min(m_next_pool_size * 2, MAX_DESCRIPTOR_POOL_SIZE);
+            VkDescriptorPoolSize pool_sizes[NUM_DESCRIPTOR_POOL_TYPES] = {
+                {VK_DESCRIPTOR_TYPE_SAMPLER, 0},
+                {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 0},
+                {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0},
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0}
+            };
+            for (u32 i = 0; i < NUM_DESCRIPTOR_POOL_TYPES; ++i)
+            {
+                // Make sure that the set being allocated always fits in the new pool.
+                pool->m_descriptor_counts[i] = max(pool->m_max_sets * DESCRIPTOR_POOL_TYPE_RATIOS[i] / 8, descriptor_counts[i]);
+                pool_sizes[i].descriptorCount = pool->m_descriptor_counts[i];
+            }
+            VkDescriptorPoolCreateInfo create_info{};
+            create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            create_info.poolSizeCount = NUM_DESCRIPTOR_POOL_TYPES;
+            create_info.pPoolSizes = pool_sizes;
+            create_info.flags = transient ? 0 : VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+            create_info.maxSets = pool->m_max_sets;
+            auto r = encode_vk_result(m_device->m_funcs.vkCreateDescriptorPool(m_device->m_device, &create_info, nullptr, &pool->m_pool));
+            if (failed(r)) return r.errcode();
+            pool->m_assigned = true;
+            DescriptorPool* ret = pool.get();
+            m_pools.push_back(move(pool));
+            is_new_pool = true;
+            return ret;
+        }
+        R<DescriptorPool*> DescriptorPoolAllocator::allocate(DescriptorSetLayout* layout, u32 num_variable_descriptors, bool transient, VkDescriptorSet& out_set)
+        {
+            u64 begin_ticks = get_ticks();
+            u32 descriptor_counts[NUM_DESCRIPTOR_POOL_TYPES];
+            memcpy(descriptor_counts, layout->m_descriptor_counts, sizeof(descriptor_counts));
+            if (layout->m_variable_descriptor_type != U32_MAX)
+            {
+                descriptor_counts[layout->m_variable_descriptor_type] += num_variable_descriptors;
+            }
+            VkDescriptorSetAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            alloc_info.descriptorSetCount = 1;
+            alloc_info.pSetLayouts = &layout->m_layout;
+            VkDescriptorSetVariableDescriptorCountAllocateInfo variable_info{};
+            if (layout->m_variable_descriptor_type != U32_MAX)
+            {
+                variable_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+                variable_info.pDescriptorCounts = &num_variable_descriptors;
+                variable_info.descriptorSetCount = 1;
+                alloc_info.pNext = &variable_info;
+            }
+            opaque_t tls = transient ? m_tls_transient_pool : m_tls_pool;
+            DescriptorPool* pool = (DescriptorPool*)tls_get(tls);
+            bool is_new_pool = false;
+            while (true)
+            {
+                if (pool)
+                {
+                    LockGuard guard(pool->m_lock);
+                    if (!pool->m_full)
+                    {
+                        alloc_info.descriptorPool = pool->m_pool;
+                        VkResult result = m_device->m_funcs.vkAllocateDescriptorSets(m_device->m_device, &alloc_info, &out_set);
+                        if (result == VK_SUCCESS)
+                        {
+                            ++pool->m_num_sets;
+                            guard.unlock();
+                            atom_inc_u64(&m_num_allocations);
+                            atom_add_u64(&m_allocation_ticks, get_ticks() - begin_ticks);
+                            return pool;
+                        }
+                        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+                        {
+                            return encode_vk_result(result).errcode();
+                        }
+                        if (result == VK_ERROR_FRAGMENTED_POOL) atom_inc_u64(&m_num_fragmented_allocations);
+                        else atom_inc_u64(&m_num_pool_overflows);
+                        // The set does not fit in one new pool, which should not happen since new pools 
+                        // are created with enough descriptors.
+                        if (is_new_pool) return BasicError::out_of_memory();
+                        pool->m_full = true;
+                    }
+                    pool->m_assigned = false;
+                }
+                auto r = acquire_pool(transient, descriptor_counts, is_new_pool);
+                if (failed(r)) return r.errcode();
+                pool = r.get();
+                tls_set(tls, pool);
+            }
+        }
+        void DescriptorPoolAllocator::free(DescriptorPool* pool, VkDescriptorSet set)
+        {
+            LockGuard guard(pool->m_lock);
+            --pool->m_num_sets;
+            if (pool->m_transient)
+            {
+                // Recycle all sets in bulk once all sets of the pool are released.
+                if (!pool->m_num_sets)
+                {
+                    m_device->m_funcs.vkResetDescriptorPool(m_device->m_device, pool->m_pool, 0);
+                    pool->m_full = false;
+                }
+            }
+            else
+            {
+                m_device->m_funcs.vkFreeDescriptorSets(m_device->m_device, pool->m_pool, 1, &set);
+                // Let the pool be selected again when half of the pool is free, so that threads do not 
+                // switch between pools that are nearly full.
+                if (pool->m_full && pool->m_num_sets <= pool->m_max_sets / 2)
+                {
+                    pool->m_full = false;
+                }
+            }
+        }
+        DescriptorPoolStatistics DescriptorPoolAllocator::get_statistics()
+        {
+            DescriptorPoolStatistics ret;
+            MutexGuard guard(m_pools_mtx);
+            for (auto& pool : m_pools)
+            {
+                LockGuard pool_guard(pool->m_lock);
+                ++ret.num_pools;
+                if (pool->m_transient) ++ret.num_transient_pools;
+                ret.num_allocated_sets += pool->m_num_sets;
+                ret.max_sets += pool->m_max_sets;
+            }
+            ret.num_fragmented_allocations = m_num_fragmented_allocations;
+            ret.num_pool_overflows = m_num_pool_overflows;
+            ret.num_allocations = m_num_allocations;
+            ret.allocation_time = (f64)m_allocation_ticks / get_ticks_per_second();
+            return ret;
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorPool.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "Common.hpp"
+#include "../../DescriptorSet.hpp"
+#include <Luna/Runtime/Mutex.hpp>
+#include <Luna/Runtime/SpinLock.hpp>
+#include <Luna/Runtime/UniquePtr.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct Device;
+        struct DescriptorSetLayout;
+
+        // Descriptor types stored in descriptor pools.
+        constexpr u32 NUM_DESCRIPTOR_POOL_TYPES = 5;
+        inline u32 get_descriptor_pool_type(VkDescriptorType type)
+        {
+            switch (type)
+            {
+            case VK_DESCRIPTOR_TYPE_SAMPLER: return 0;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return 1;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: return 2;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return 3;
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: return 4;
+            default: lupanic(); return 0;
+            }
+        }
+
+        struct DescriptorPool
+        {
+            VkDescriptorPool m_pool = VK_NULL_HANDLE;
+            u32 m_max_sets = 0;
+            u32 m_descriptor_counts[NUM_DESCRIPTOR_POOL_TYPES];
+            // The number of descriptor sets allocated from this pool and not freed.
+            u32 m_num_sets = 0;
+            // Transient pools do not free descriptor sets individually, but are reset when all sets are released.
+            bool m_transient = false;
+            // Set when one allocation fails. Full pools are not selected by threads until enough sets are freed.
+            bool m_full = false;
+            // Whether this pool is used by one thread as the current pool of the thread.
+            bool m_assigned = false;
+            // Descriptor pools must be externally synchronized. Every pool is usually accessed by one thread,
+            // so the lock is only contended when sets are freed by other threads.
+            SpinLock m_lock;
+        };
+
+        // Allocates descriptor sets from a growable list of descriptor pools.
+        // Every thread allocates from its own current pool, and selects another pool when the current pool is full.
+        // New pools are created with larger sizes when no existing pool can be used.
+        struct DescriptorPoolAllocator
+        {
+            Device* m_device = nullptr;
+            Vector<UniquePtr<DescriptorPool>> m_pools;
+            Ref<IMutex> m_pools_mtx;
+            // The current pool of every thread for normal and transient descriptor sets.
+            opaque_t m_tls_pool = nullptr;
+            opaque_t m_tls_transient_pool = nullptr;
+            // The number of descriptor sets of the next created pool.
+            u32 m_next_pool_size = 256;
+
+            // Statistics.
+            u64 m_num_allocations = 0;
+            u64 m_num_fragmented_allocations = 0;
+            u64 m_num_pool_overflows = 0;
+            u64 m_allocation_ticks = 0;
+
+            RV init(Device* device);
+            // Destroys all pools. This must be called before the device is destroyed.
+            void clean_up();
+            // Allocates one descriptor set, and returns the pool that the set is allocated from.
+            R<DescriptorPool*> allocate(DescriptorSetLayout* layout, u32 num_variable_descriptors, bool transient, VkDescriptorSet& out_set);
+            // Frees one descriptor set allocated by `allocate`.
+            void free(DescriptorPool* pool, VkDescriptorSet set);
+            DescriptorPoolStatistics get_statistics();
+        private:
+            // Selects one pool that is not used by other threads and may have enough space for the set, 
+            // or creates one new pool if no such pool exists.
+            R<DescriptorPool*> acquire_pool(bool transient, const u32* descriptor_counts, bool& is_new_pool);
+        };
+    }
+}
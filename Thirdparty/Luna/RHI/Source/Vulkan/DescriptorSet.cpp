@@ -18,22 +18,8 @@ namespace Luna
             lutry
             {
                 m_layout = (DescriptorSetLayout*)desc.layout->get_object();
-                VkDescriptorSetAllocateInfo alloc_info{};
-                alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-                alloc_info.descriptorPool = m_device->m_desc_pool;
-                alloc_info.descriptorSetCount = 1;
-                alloc_info.pSetLayouts = &m_layout->m_layout;
-                VkDescriptorSetVariableDescriptorCountAllocateInfo variable_info{};
-                if (test_flags(m_layout->m_flags, DescriptorSetLayoutFlag::variable_descriptors))
-                {
-                    variable_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
-                    u32 counts = desc.num_variable_descriptors;
-                    variable_info.pDescriptorCounts = &counts;
-                    variable_info.descriptorSetCount = 1;
-                    alloc_info.pNext = &variable_info;
-                }
-                MutexGuard guard(m_device->m_desc_pool_mtx);
-                luexp(encode_vk_result(m_device->m_funcs.vkAllocateDescriptorSets(m_device->m_device, &alloc_info, &m_desc_set)));
+                luset(m_pool, m_device->m_desc_pool_allocator.allocate(m_layout, desc.num_variable_descriptors, 
+                    test_flags(desc.flags, DescriptorSetFlag::transient), m_desc_set));
             }
             lucatchret;
             return ok;
@@ -42,8 +28,7 @@ namespace Luna
         {
             if (m_desc_set != VK_NULL_HANDLE)
             {
-                MutexGuard guard(m_device->m_desc_pool_mtx);
-                m_device->m_funcs.vkFreeDescriptorSets(m_device->m_device, m_device->m_desc_pool, 1, &m_desc_set);
+                m_device->m_desc_pool_allocator.free(m_pool, m_desc_set);
                 m_desc_set = VK_NULL_HANDLE;
             }
         }
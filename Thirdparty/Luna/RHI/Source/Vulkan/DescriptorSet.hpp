@@ -26,6 +26,8 @@ namespace Luna
             Ref<DescriptorSetLayout> m_layout;
 
             VkDescriptorSet m_desc_set = VK_NULL_HANDLE;
+            // The pool that this set is allocated from.
+            DescriptorPool* m_pool = nullptr;
 
             HashMap<u32, Ref<Sampler>> m_samplers;
 
@@ -73,6 +73,19 @@ namespace Luna
                     flags[info.bindingCount - 1] |= VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT;
                     info.pNext = &binding_flags;
                 }
+                bool variable_descriptors = test_flags(desc.flags, DescriptorSetLayoutFlag::variable_descriptors);
+                for (u32 i = 0; i < info.bindingCount; ++i)
+                {
+                    u32 type = get_descriptor_pool_type(bindings[i].descriptorType);
+                    if (variable_descriptors && i == info.bindingCount - 1)
+                    {
+                        m_variable_descriptor_type = type;
+                    }
+                    else
+                    {
+                        m_descriptor_counts[type] += bindings[i].descriptorCount;
+                    }
+                }
                 luexp(encode_vk_result(m_device->m_funcs.vkCreateDescriptorSetLayout(m_device->m_device, &info, nullptr, &m_layout)));
             }
             lucatchret;
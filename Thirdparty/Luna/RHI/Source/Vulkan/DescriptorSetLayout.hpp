@@ -22,6 +22,10 @@ namespace Luna
             Ref<Device> m_device;
             DescriptorSetLayoutFlag m_flags;
             VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+            // The number of descriptors of every descriptor pool type, excluding the variable-sized binding.
+            u32 m_descriptor_counts[NUM_DESCRIPTOR_POOL_TYPES] = { 0 };
+            // The descriptor pool type of the variable-sized binding, or `U32_MAX` if the layout does not have one.
+            u32 m_variable_descriptor_type = U32_MAX;
             Name m_name;
 
             RV init(const DescriptorSetLayoutDesc& desc);
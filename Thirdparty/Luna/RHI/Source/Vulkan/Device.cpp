@@ -22,6 +22,7 @@
 #include "QueryHeap.hpp"
 #include "ResourceStateTrackingSystem.hpp"
 #include "SwapChain.hpp"
+#include <Luna/Runtime/Hash.hpp>
 namespace Luna
 {
     namespace RHI
@@ -61,7 +62,46 @@ namespace Luna
                 m_supports_descriptor_indexing = true;
             }
 
-            m_desc_pool_mtx = new_mutex();
+            // Check draw indirect count and timeline semaphore support.
+            VkPhysicalDeviceVulkan12Features vulkan12_features{};
+            vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            m_supports_draw_indirect_count = false;
+            m_supports_timeline_semaphore = false;
+            bool core_draw_indirect_count = false;
+            bool core_timeline_semaphore = false;
+            if (g_vk_version >= VK_API_VERSION_1_2)
+            {
+                VkPhysicalDeviceFeatures2 features2{};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &vulkan12_features;
+                vkGetPhysicalDeviceFeatures2(physical_device, &features2);
+                // Both features are promoted to 1.2 and later, but are optional.
+                if (vulkan12_features.drawIndirectCount)
+                {
+                    m_supports_draw_indirect_count = true;
+                    core_draw_indirect_count = true;
+                }
+                if (vulkan12_features.timelineSemaphore)
+                {
+                    m_supports_timeline_semaphore = true;
+                    core_timeline_semaphore = true;
+                }
+            }
+            for (auto& extension : m_extension_properties)
+            {
+                if (!m_supports_draw_indirect_count && strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0)
+                {
+                    m_supports_draw_indirect_count = true;
+                    enabled_extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+                }
+                else if (!m_supports_timeline_semaphore && strcmp(extension.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0)
+                {
+                    m_supports_timeline_semaphore = true;
+                    enabled_extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+                }
+            }
+
+            m_pipeline_states_mtx = new_mutex();
             m_physical_device = physical_device;
             vkGetPhysicalDeviceProperties(physical_device, &m_physical_device_properties);
             // Check device features.
@@ -94,12 +134,57 @@ namespace Luna
             create_info.ppEnabledLayerNames = g_enabled_layers.data();
             create_info.enabledExtensionCount = (u32)enabled_extensions.size();
             create_info.ppEnabledExtensionNames = enabled_extensions.data();
+            VkPhysicalDeviceVulkan12Features enabled_vulkan12_features{};
+            if (core_draw_indirect_count || core_timeline_semaphore)
+            {
+                enabled_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                enabled_vulkan12_features.drawIndirectCount = core_draw_indirect_count ? VK_TRUE : VK_FALSE;
+                enabled_vulkan12_features.timelineSemaphore = core_timeline_semaphore ? VK_TRUE : VK_FALSE;
+                last->pNext = &enabled_vulkan12_features;
+                last = (VkStructureHeader*)&enabled_vulkan12_features;
+            }
+            VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_features{};
+            if (m_supports_timeline_semaphore && !core_timeline_semaphore)
+            {
+                timeline_semaphore_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+                timeline_semaphore_features.timelineSemaphore = VK_TRUE;
+                last->pNext = &timeline_semaphore_features;
+                last = (VkStructureHeader*)&timeline_semaphore_features;
+            }
             auto r = encode_vk_result(vkCreateDevice(physical_device, &create_info, nullptr, &m_device));
             volkLoadDeviceTable(&m_funcs, m_device);
             if (failed(r))
             {
                 return r.errcode();
             }
+            if (m_supports_draw_indirect_count)
+            {
+                if (core_draw_indirect_count)
+                {
+                    m_vkCmdDrawIndirectCount = m_funcs.vkCmdDrawIndirectCount;
+                    m_vkCmdDrawIndexedIndirectCount = m_funcs.vkCmdDrawIndexedIndirectCount;
+                }
+                else
+                {
+                    m_vkCmdDrawIndirectCount = m_funcs.vkCmdDrawIndirectCountKHR;
+                    m_vkCmdDrawIndexedIndirectCount = m_funcs.vkCmdDrawIndexedIndirectCountKHR;
+                }
+            }
+            if (m_supports_timeline_semaphore)
+            {
+                if (core_timeline_semaphore)
+                {
+                    m_vkGetSemaphoreCounterValue = m_funcs.vkGetSemaphoreCounterValue;
+                    m_vkWaitSemaphores = m_funcs.vkWaitSemaphores;
+                    m_vkSignalSemaphore = m_funcs.vkSignalSemaphore;
+                }
+                else
+                {
+                    m_vkGetSemaphoreCounterValue = m_funcs.vkGetSemaphoreCounterValueKHR;
+                    m_vkWaitSemaphores = m_funcs.vkWaitSemaphoresKHR;
+                    m_vkSignalSemaphore = m_funcs.vkSignalSemaphoreKHR;
+                }
+            }
             // Fetch command queue.
             for (usize i = 0; i < queue_families.size(); ++i)
             {
@@ -115,7 +200,7 @@ namespace Luna
                     m_queues.push_back(queue);
                 }
             }
-            r = init_descriptor_pools();
+            r = m_desc_pool_allocator.init(this);
             if (failed(r))
             {
                 return r.errcode();
@@ -125,28 +210,16 @@ namespace Luna
             {
                 return r.errcode();
             }
+            r = init_pipeline_cache();
+            if (failed(r))
+            {
+                return r.errcode();
+            }
             m_render_pass_pool.m_device = m_device;
             m_render_pass_pool.m_vkCreateRenderPass = m_funcs.vkCreateRenderPass;
             m_render_pass_pool.m_vkDestroyRenderPass = m_funcs.vkDestroyRenderPass;
             return ok;
         }
-        RV Device::init_descriptor_pools()
-        {
-            VkDescriptorPoolSize pool_sizes[5] = {
-                {VK_DESCRIPTOR_TYPE_SAMPLER, 1024},
-                {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 8192},
-                {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1024},
-                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 8192},
-                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1024}
-            };
-            VkDescriptorPoolCreateInfo create_info{};
-            create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-            create_info.poolSizeCount = 5;
-            create_info.pPoolSizes = pool_sizes;
-            create_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-            create_info.maxSets = 8192;
-            return encode_vk_result(m_funcs.vkCreateDescriptorPool(m_device, &create_info, nullptr, &m_desc_pool));
-        }
         RV Device::init_vma_allocator()
         {
             VmaAllocatorCreateInfo allocator_create_info = {};
@@ -207,19 +280,42 @@ namespace Luna
             allocator_create_info.pVulkanFunctions = &funcs;
             return encode_vk_result(vmaCreateAllocator(&allocator_create_info, &m_allocator));
         }
+        RV Device::init_pipeline_cache()
+        {
+            VkPipelineCacheCreateInfo create_info{};
+            create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            return encode_vk_result(m_funcs.vkCreatePipelineCache(m_device, &create_info, nullptr, &m_pipeline_cache));
+        }
+        u32 Device::allocate_resource_id()
+        {
+            LockGuard guard(m_resource_ids_lock);
+            if (!m_free_resource_ids.empty())
+            {
+                u32 id = m_free_resource_ids.back();
+                m_free_resource_ids.pop_back();
+                return id;
+            }
+            return m_next_resource_id++;
+        }
+        void Device::free_resource_id(u32 id)
+        {
+            LockGuard guard(m_resource_ids_lock);
+            m_free_resource_ids.push_back(id);
+        }
         Device::~Device()
         {
             m_render_pass_pool.clean_up();
+            if (m_pipeline_cache != VK_NULL_HANDLE)
+            {
+                m_funcs.vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+                m_pipeline_cache = VK_NULL_HANDLE;
+            }
             if (m_allocator != VK_NULL_HANDLE)
             {
                 vmaDestroyAllocator(m_allocator);
                 m_allocator = VK_NULL_HANDLE;
             }
-            if (m_desc_pool != VK_NULL_HANDLE)
-            {
-                m_funcs.vkDestroyDescriptorPool(m_device, m_desc_pool, nullptr);
-                m_desc_pool = VK_NULL_HANDLE;
-            }
+            m_desc_pool_allocator.clean_up();
             if (m_device != VK_NULL_HANDLE)
             {
                 m_funcs.vkDestroyDevice(m_device, nullptr);
@@ -296,6 +392,15 @@ namespace Luna
             case DeviceFeature::uniform_buffer_data_alignment:
                 ret.uniform_buffer_data_alignment = (u32)m_physical_device_properties.limits.minUniformBufferOffsetAlignment;
                 break;
+            case DeviceFeature::multi_draw_indirect:
+                ret.multi_draw_indirect = m_physical_device_features.multiDrawIndirect == VK_TRUE;
+                break;
+            case DeviceFeature::draw_indirect_count:
+                ret.draw_indirect_count = m_supports_draw_indirect_count;
+                break;
+            case DeviceFeature::timeline_fence:
+                ret.timeline_fence = m_supports_timeline_semaphore;
+                break;
             default: lupanic();
             }
             return ret;
@@ -431,6 +536,33 @@ namespace Luna
             lucatchret;
             return ret;
         }
+        Ref<IPipelineState> Device::find_pipeline_state(u64 hash, const Vector<byte_t>& key)
+        {
+            MutexGuard guard(m_pipeline_states_mtx);
+            auto iter = m_pipeline_states.find(hash);
+            if (iter == m_pipeline_states.end()) return nullptr;
+            Ref<IPipelineState> ret = iter->second.pin();
+            if (!ret) return nullptr;
+            // Compare keys in case of hash collision.
+            PipelineState* pso = (PipelineState*)ret->get_object();
+            if (pso->m_key.size() != key.size() || memcmp(pso->m_key.data(), key.data(), key.size())) return nullptr;
+            return ret;
+        }
+        void Device::add_pipeline_state(u64 hash, IPipelineState* pipeline_state)
+        {
+            MutexGuard guard(m_pipeline_states_mtx);
+            m_pipeline_states.insert_or_assign(hash, WeakRef<IPipelineState>(Ref<IPipelineState>(pipeline_state)));
+            if (m_pipeline_states.size() >= m_pipeline_states_prune_size)
+            {
+                // Remove expired pipeline states.
+                for (auto iter = m_pipeline_states.begin(); iter != m_pipeline_states.end();)
+                {
+                    if (!iter->second) iter = m_pipeline_states.erase(iter);
+                    else ++iter;
+                }
+                m_pipeline_states_prune_size = max<usize>(m_pipeline_states.size() * 2, 64);
+            }
+        }
         R<Ref<IPipelineState>> Device::new_graphics_pipeline_state(const GraphicsPipelineStateDesc& desc)
         {
             Ref<IPipelineState> ret;
@@ -438,8 +570,14 @@ namespace Luna
             {
                 auto layout = new_object<PipelineState>();
                 layout->m_device = this;
+                PipelineState::get_graphics_pipeline_key(desc, layout->m_key);
+                u64 hash = memhash64(layout->m_key.data(), layout->m_key.size());
+                ret = find_pipeline_state(hash, layout->m_key);
+                if (ret) return ret;
                 luexp(layout->init_as_graphics(desc));
+                layout->m_pipeline_layout = desc.pipeline_layout;
                 ret = layout;
+                add_pipeline_state(hash, ret);
             }
             lucatchret;
             return ret;
@@ -451,8 +589,14 @@ namespace Luna
             {
                 auto layout = new_object<PipelineState>();
                 layout->m_device = this;
+                PipelineState::get_compute_pipeline_key(desc, layout->m_key);
+                u64 hash = memhash64(layout->m_key.data(), layout->m_key.size());
+                ret = find_pipeline_state(hash, layout->m_key);
+                if (ret) return ret;
                 luexp(layout->init_as_compute(desc));
+                layout->m_pipeline_layout = desc.pipeline_layout;
                 ret = layout;
+                add_pipeline_state(hash, ret);
             }
             lucatchret;
             return ret;
@@ -523,19 +667,93 @@ namespace Luna
             lucatchret;
             return ret;
         }
-        R<Ref<IFence>> Device::new_fence()
+        R<Ref<IFence>> Device::new_fence(FenceType type)
         {
             Ref<IFence> ret;
             lutry
             {
                 auto fence = new_object<Fence>();
                 fence->m_device = this;
-                luexp(fence->init());
+                luexp(fence->init(type));
                 ret = fence;
             }
             lucatchret;
             return ret;
         }
+        // The header stored before Vulkan pipeline cache data, used to reject data produced by other adapters or drivers.
+        struct PipelineCacheDataHeader
+        {
+            u32 magic;
+            u32 version;
+            u32 vendor_id;
+            u32 device_id;
+            u32 driver_version;
+            u8 pipeline_cache_uuid[VK_UUID_SIZE];
+            u64 data_size;
+            u64 data_hash;
+        };
+        constexpr u32 PIPELINE_CACHE_DATA_MAGIC = 0x43505653; // "SVPC"
+        constexpr u32 PIPELINE_CACHE_DATA_VERSION = 1;
+        R<Blob> Device::get_pipeline_cache_data()
+        {
+            Blob ret;
+            lutry
+            {
+                usize size = 0;
+                luexp(encode_vk_result(m_funcs.vkGetPipelineCacheData(m_device, m_pipeline_cache, &size, nullptr)));
+                ret = Blob(sizeof(PipelineCacheDataHeader) + size);
+                byte_t* data = (byte_t*)ret.data() + sizeof(PipelineCacheDataHeader);
+                // `VK_INCOMPLETE` is returned if the cache grows between two calls, in which case the written data is still valid.
+                VkResult result = m_funcs.vkGetPipelineCacheData(m_device, m_pipeline_cache, &size, data);
+                if (result != VK_INCOMPLETE) luexp(encode_vk_result(result));
+                PipelineCacheDataHeader header;
+                memzero(&header, sizeof(header));
+                header.magic = PIPELINE_CACHE_DATA_MAGIC;
+                header.version = PIPELINE_CACHE_DATA_VERSION;
+                header.vendor_id = m_physical_device_properties.vendorID;
+                header.device_id = m_physical_device_properties.deviceID;
+                header.driver_version = m_physical_device_properties.driverVersion;
+                memcpy(header.pipeline_cache_uuid, m_physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE);
+                header.data_size = size;
+                header.data_hash = memhash64(data, size);
+                memcpy(ret.data(), &header, sizeof(header));
+                ret.resize(sizeof(PipelineCacheDataHeader) + size);
+            }
+            lucatchret;
+            return ret;
+        }
+        RV Device::load_pipeline_cache_data(Span<const byte_t> data)
+        {
+            lutry
+            {
+                PipelineCacheDataHeader header;
+                if (data.size() < sizeof(header)) return BasicError::bad_data();
+                memcpy(&header, data.data(), sizeof(header));
+                if (header.magic != PIPELINE_CACHE_DATA_MAGIC || header.data_size != data.size() - sizeof(header)) return BasicError::bad_data();
+                const byte_t* cache_data = data.data() + sizeof(header);
+                if (header.data_hash != memhash64(cache_data, (usize)header.data_size)) return BasicError::bad_data();
+                // Data produced by other adapters or drivers cannot be used.
+                if (header.version != PIPELINE_CACHE_DATA_VERSION ||
+                    header.vendor_id != m_physical_device_properties.vendorID ||
+                    header.device_id != m_physical_device_properties.deviceID ||
+                    header.driver_version != m_physical_device_properties.driverVersion ||
+                    memcmp(header.pipeline_cache_uuid, m_physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE))
+                {
+                    return ok;
+                }
+                VkPipelineCacheCreateInfo create_info{};
+                create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+                create_info.initialDataSize = (usize)header.data_size;
+                create_info.pInitialData = cache_data;
+                VkPipelineCache cache = VK_NULL_HANDLE;
+                luexp(encode_vk_result(m_funcs.vkCreatePipelineCache(m_device, &create_info, nullptr, &cache)));
+                auto r = encode_vk_result(m_funcs.vkMergePipelineCaches(m_device, m_pipeline_cache, 1, &cache));
+                m_funcs.vkDestroyPipelineCache(m_device, cache, nullptr);
+                luexp(r);
+            }
+            lucatchret;
+            return ok;
+        }
         R<Ref<ISwapChain>> Device::new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc)
         {
             Ref<ISwapChain> ret;
@@ -12,8 +12,10 @@
 #include <Luna/Runtime/Mutex.hpp>
 #include "Adapter.hpp"
 #include "RenderPassPool.hpp"
+#include "DescriptorPool.hpp"
 #include <Luna/Runtime/SpinLock.hpp>
 #include <Luna/Runtime/UniquePtr.hpp>
+#include <Luna/Runtime/HashMap.hpp>
 namespace Luna
 {
     namespace RHI
@@ -45,10 +47,18 @@ namespace Luna
             VkPhysicalDeviceProperties m_physical_device_properties;
             Vector<VkExtensionProperties> m_extension_properties;
             bool m_supports_descriptor_indexing;
+            bool m_supports_draw_indirect_count;
+            // Points to either the core or the KHR version of the function, or `nullptr` if not supported.
+            PFN_vkCmdDrawIndirectCount m_vkCmdDrawIndirectCount = nullptr;
+            PFN_vkCmdDrawIndexedIndirectCount m_vkCmdDrawIndexedIndirectCount = nullptr;
+            bool m_supports_timeline_semaphore;
+            // Points to either the core or the KHR version of the function, or `nullptr` if not supported.
+            PFN_vkGetSemaphoreCounterValue m_vkGetSemaphoreCounterValue = nullptr;
+            PFN_vkWaitSemaphores m_vkWaitSemaphores = nullptr;
+            PFN_vkSignalSemaphore m_vkSignalSemaphore = nullptr;
 
             // Descriptor Pools.
-            VkDescriptorPool m_desc_pool = VK_NULL_HANDLE;
-            Ref<IMutex> m_desc_pool_mtx;
+            DescriptorPoolAllocator m_desc_pool_allocator;
 
             // Vulkan memory allocator.
             VmaAllocator m_allocator = VK_NULL_HANDLE;
@@ -57,9 +67,31 @@ namespace Luna
             RenderPassPool m_render_pass_pool;
             SpinLock m_render_pass_pool_lock;
 
+            // The pipeline cache used by all pipeline states created by this device.
+            VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
+            // Alive pipeline states indexed by hashes of their descriptors, so that creating one pipeline state 
+            // with the same descriptor returns the existing pipeline state.
+            HashMap<u64, WeakRef<IPipelineState>> m_pipeline_states;
+            // The size of `m_pipeline_states` that triggers removing expired pipeline states.
+            usize m_pipeline_states_prune_size = 64;
+            Ref<IMutex> m_pipeline_states_mtx;
+
+            // Resource IDs. Every buffer and texture resource is assigned with one small integer ID that is unique among alive 
+            // resources of this device, so that command buffers can track resource states in flat arrays indexed by IDs. 
+            // IDs of destroyed resources are reused.
+            Vector<u32> m_free_resource_ids;
+            u32 m_next_resource_id = 0;
+            SpinLock m_resource_ids_lock;
+
             RV init(VkPhysicalDevice physical_device, const Vector<QueueFamily>& queue_families);
-            RV init_descriptor_pools();
             RV init_vma_allocator();
+            RV init_pipeline_cache();
+            // Finds one alive pipeline state created with the same descriptor key.
+            Ref<IPipelineState> find_pipeline_state(u64 hash, const Vector<byte_t>& key);
+            // Records one pipeline state so that it can be found by `find_pipeline_state`.
+            void add_pipeline_state(u64 hash, IPipelineState* pipeline_state);
+            u32 allocate_resource_id();
+            void free_resource_id(u32 id);
             ~Device();
 
             RV get_memory_requirements(Span<const BufferDesc> buffers, Span<const TextureDesc> textures, VkMemoryRequirements& memory_requirements);
@@ -80,13 +112,16 @@ namespace Luna
             virtual R<Ref<IPipelineState>> new_compute_pipeline_state(const ComputePipelineStateDesc& desc) override;
             virtual R<Ref<IDescriptorSetLayout>> new_descriptor_set_layout(const DescriptorSetLayoutDesc& desc) override;
             virtual R<Ref<IDescriptorSet>> new_descriptor_set(const DescriptorSetDesc& desc) override;
+            virtual DescriptorPoolStatistics get_descriptor_pool_statistics() override { return m_desc_pool_allocator.get_statistics(); }
             virtual u32 get_num_command_queues() override;
             virtual CommandQueueDesc get_command_queue_desc(u32 command_queue_index) override;
             virtual R<Ref<ICommandBuffer>> new_command_buffer(u32 command_queue_index) override;
             virtual R<f64> get_command_queue_timestamp_frequency(u32 command_queue_index) override;
             virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
-            virtual R<Ref<IFence>> new_fence() override;
+            virtual R<Ref<IFence>> new_fence(FenceType type) override;
             virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+            virtual R<Blob> get_pipeline_cache_data() override;
+            virtual RV load_pipeline_cache_data(Span<const byte_t> data) override;
         };
 
         extern Ref<IDevice> g_main_device;
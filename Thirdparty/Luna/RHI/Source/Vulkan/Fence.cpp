@@ -13,12 +13,48 @@ namespace Luna
 {
     namespace RHI
     {
-        RV Fence::init()
+        RV Fence::init(FenceType type)
         {
+            m_type = type;
             VkSemaphoreCreateInfo info{};
             info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            VkSemaphoreTypeCreateInfoKHR type_info{};
+            if (type == FenceType::timeline)
+            {
+                if (!m_device->m_supports_timeline_semaphore) return BasicError::not_supported();
+                type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+                type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+                type_info.initialValue = 0;
+                info.pNext = &type_info;
+            }
             return encode_vk_result(m_device->m_funcs.vkCreateSemaphore(m_device->m_device, &info, nullptr, &m_semaphore));
         }
+        u64 Fence::get_completed_value()
+        {
+            if (m_type != FenceType::timeline) return 0;
+            u64 value = 0;
+            auto r = encode_vk_result(m_device->m_vkGetSemaphoreCounterValue(m_device->m_device, m_semaphore, &value));
+            return failed(r) ? 0 : value;
+        }
+        RV Fence::wait(u64 value, u64 timeout)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            VkSemaphoreWaitInfoKHR info{};
+            info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+            info.semaphoreCount = 1;
+            info.pSemaphores = &m_semaphore;
+            info.pValues = &value;
+            return encode_vk_result(m_device->m_vkWaitSemaphores(m_device->m_device, &info, timeout));
+        }
+        RV Fence::signal(u64 value)
+        {
+            if (m_type != FenceType::timeline) return BasicError::not_supported();
+            VkSemaphoreSignalInfoKHR info{};
+            info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+            info.semaphore = m_semaphore;
+            info.value = value;
+            return encode_vk_result(m_device->m_vkSignalSemaphore(m_device->m_device, &info));
+        }
         Fence::~Fence()
         {
             if (m_semaphore != VK_NULL_HANDLE)
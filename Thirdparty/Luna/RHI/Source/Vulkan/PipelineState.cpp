@@ -38,6 +38,100 @@ namespace Luna
                 }
             }
         };
+        template <typename _Ty>
+        inline void write_key(Vector<byte_t>& key, const _Ty& value)
+        {
+            const byte_t* data = (const byte_t*)&value;
+            key.insert(key.end(), data, data + sizeof(_Ty));
+        }
+        inline void write_shader_key(Vector<byte_t>& key, const ShaderData& shader)
+        {
+            // Store the shader data itself, since pipeline states with equal keys are treated as the same pipeline state, 
+            // and two different shaders may have the same hash.
+            write_key(key, shader.format);
+            write_key(key, shader.data.size());
+            key.insert(key.end(), shader.data.begin(), shader.data.end());
+            write_key(key, shader.entry_point.id());
+        }
+        void PipelineState::get_graphics_pipeline_key(const GraphicsPipelineStateDesc& desc, Vector<byte_t>& key)
+        {
+            // Descriptors contain padding bytes, so write members one by one.
+            key.clear();
+            write_key(key, (u8)0);
+            write_key(key, desc.input_layout.bindings.size());
+            for (auto& binding : desc.input_layout.bindings)
+            {
+                write_key(key, binding.binding_slot);
+                write_key(key, binding.element_size);
+                write_key(key, binding.input_rate);
+            }
+            write_key(key, desc.input_layout.attributes.size());
+            for (auto& attribute : desc.input_layout.attributes)
+            {
+                usize len = attribute.semantic_name ? strlen(attribute.semantic_name) : 0;
+                write_key(key, len);
+                key.insert(key.end(), (const byte_t*)attribute.semantic_name, (const byte_t*)attribute.semantic_name + len);
+                write_key(key, attribute.semantic_index);
+                write_key(key, attribute.location);
+                write_key(key, attribute.binding_slot);
+                write_key(key, attribute.offset);
+                write_key(key, attribute.format);
+            }
+            write_key(key, desc.pipeline_layout);
+            write_shader_key(key, desc.vs);
+            write_shader_key(key, desc.ps);
+            auto& rs = desc.rasterizer_state;
+            write_key(key, rs.depth_bias);
+            write_key(key, rs.slope_scaled_depth_bias);
+            write_key(key, rs.depth_bias_clamp);
+            write_key(key, rs.fill_mode);
+            write_key(key, rs.cull_mode);
+            write_key(key, rs.front_counter_clockwise);
+            write_key(key, rs.depth_clip_enable);
+            auto& ds = desc.depth_stencil_state;
+            write_key(key, ds.depth_test_enable);
+            write_key(key, ds.depth_write_enable);
+            write_key(key, ds.depth_func);
+            write_key(key, ds.stencil_enable);
+            write_key(key, ds.stencil_read_mask);
+            write_key(key, ds.stencil_write_mask);
+            auto write_stencil_op = [&](const DepthStencilOpDesc& op)
+            {
+                write_key(key, op.stencil_fail_op);
+                write_key(key, op.stencil_depth_fail_op);
+                write_key(key, op.stencil_pass_op);
+                write_key(key, op.stencil_func);
+            };
+            write_stencil_op(ds.front_face);
+            write_stencil_op(ds.back_face);
+            auto& bs = desc.blend_state;
+            write_key(key, bs.alpha_to_coverage_enable);
+            write_key(key, bs.independent_blend_enable);
+            for (auto& attachment : bs.attachments)
+            {
+                write_key(key, attachment.blend_enable);
+                write_key(key, attachment.src_blend_color);
+                write_key(key, attachment.dst_blend_color);
+                write_key(key, attachment.blend_op_color);
+                write_key(key, attachment.src_blend_alpha);
+                write_key(key, attachment.dst_blend_alpha);
+                write_key(key, attachment.blend_op_alpha);
+                write_key(key, attachment.color_write_mask);
+            }
+            write_key(key, desc.ib_strip_cut_value);
+            write_key(key, desc.primitive_topology);
+            write_key(key, desc.num_color_attachments);
+            for (auto format : desc.color_formats) write_key(key, format);
+            write_key(key, desc.depth_stencil_format);
+            write_key(key, desc.sample_count);
+        }
+        void PipelineState::get_compute_pipeline_key(const ComputePipelineStateDesc& desc, Vector<byte_t>& key)
+        {
+            key.clear();
+            write_key(key, (u8)1);
+            write_key(key, desc.pipeline_layout);
+            write_shader_key(key, desc.cs);
+        }
         RV PipelineState::init_as_graphics(const GraphicsPipelineStateDesc& desc)
         {
             lutry
@@ -285,7 +379,7 @@ namespace Luna
                 luset(create_info.renderPass, m_device->m_render_pass_pool.get_render_pass(render_pass));
                 guard.unlock();
                 create_info.subpass = 0;
-                luexp(encode_vk_result(m_device->m_funcs.vkCreateGraphicsPipelines(m_device->m_device, VK_NULL_HANDLE, 1, &create_info, nullptr, &m_pipeline)));
+                luexp(encode_vk_result(m_device->m_funcs.vkCreateGraphicsPipelines(m_device->m_device, m_device->m_pipeline_cache, 1, &create_info, nullptr, &m_pipeline)));
             }    
             lucatchret;
             return ok;
@@ -313,7 +407,7 @@ namespace Luna
                 // pipeline layout.
                 PipelineLayout* playout = (PipelineLayout*)desc.pipeline_layout->get_object();
                 create_info.layout = playout->m_pipeline_layout;
-                luexp(encode_vk_result(m_device->m_funcs.vkCreateComputePipelines(m_device->m_device, VK_NULL_HANDLE, 1, &create_info, nullptr, &m_pipeline)));
+                luexp(encode_vk_result(m_device->m_funcs.vkCreateComputePipelines(m_device->m_device, m_device->m_pipeline_cache, 1, &create_info, nullptr, &m_pipeline)));
             }
             lucatchret;
             return ok;
@@ -22,6 +22,15 @@ namespace Luna
             Ref<Device> m_device;
             Name m_name;
             VkPipeline m_pipeline = VK_NULL_HANDLE;
+            // The key built from the descriptor, used to find pipeline states with the same descriptor.
+            Vector<byte_t> m_key;
+            // Keeps the pipeline layout alive, so that the address of the layout stored in `m_key` is not reused
+            // by other layouts.
+            Ref<IPipelineLayout> m_pipeline_layout;
+
+            // Builds the key that identifies pipeline states created with the same descriptor.
+            static void get_graphics_pipeline_key(const GraphicsPipelineStateDesc& desc, Vector<byte_t>& key);
+            static void get_compute_pipeline_key(const ComputePipelineStateDesc& desc, Vector<byte_t>& key);
 
             RV init_as_graphics(const GraphicsPipelineStateDesc& desc);
             RV init_as_compute(const ComputePipelineStateDesc& desc);
@@ -19,6 +19,7 @@ namespace Luna
             lutry
             {
                 m_desc = desc;
+                m_resource_id = m_device->allocate_resource_id();
                 VkBufferCreateInfo create_info{};
                 encode_buffer_create_info(create_info, m_desc);
                 VmaAllocationCreateInfo allocation{};
@@ -49,6 +50,7 @@ namespace Luna
             lutry
             {
                 m_desc = desc;
+                m_resource_id = m_device->allocate_resource_id();
                 m_desc.flags |= ResourceFlag::allow_aliasing;
                 luset(m_buffer, m_device->create_vk_buffer(m_desc));
                 VkMemoryRequirements memory_requirements;
@@ -75,6 +77,11 @@ namespace Luna
                 m_device->m_funcs.vkDestroyBuffer(m_device->m_device, m_buffer, nullptr);
                 m_buffer = VK_NULL_HANDLE;
             }
+            if (m_resource_id != U32_MAX)
+            {
+                m_device->free_resource_id(m_resource_id);
+                m_resource_id = U32_MAX;
+            }
         }
         void BufferResource::set_name(const c8* name)
         {
@@ -136,6 +143,7 @@ namespace Luna
         {
             u32 num_subresources = m_desc.mip_levels * m_desc.array_size;
             m_global_states.resize(num_subresources);
+            m_resource_id = m_device->allocate_resource_id();
         }
         RV ImageResource::init_as_committed(MemoryType memory_type, const TextureDesc& desc)
         {
@@ -202,6 +210,11 @@ namespace Luna
                 m_device->m_funcs.vkDestroyImage(m_device->m_device, m_image, nullptr);
                 m_image = VK_NULL_HANDLE;
             }
+            if (m_resource_id != U32_MAX)
+            {
+                m_device->free_resource_id(m_resource_id);
+                m_resource_id = U32_MAX;
+            }
         }
         void ImageResource::set_name(const c8* name)
         {
@@ -26,7 +26,12 @@ namespace Luna
             VkBuffer m_buffer = VK_NULL_HANDLE;
             Ref<DeviceMemory> m_memory;
 
+            //! The ID used to index resource state tables of command buffers, see `Device::allocate_resource_id`.
+            u32 m_resource_id = U32_MAX;
+
+            // Global state, updated when command buffers that use this resource are submitted.
             u32 m_owning_queue_family_index = U32_MAX;
+            BufferStateFlag m_global_state = BufferStateFlag::none;
 
             RV init_as_committed(MemoryType memory_type, const BufferDesc& desc);
             RV init_as_aliasing(const BufferDesc& desc, DeviceMemory* memory);
@@ -44,6 +49,8 @@ namespace Luna
         {
             VkImageLayout m_image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
             u32 m_owning_queue_family_index = U32_MAX;
+            //! The state of the subresource after the last submitted command buffer that uses the subresource.
+            TextureStateFlag m_state = TextureStateFlag::none;
         };
 
         struct ImageResource : ITexture
@@ -59,6 +66,9 @@ namespace Luna
             // for example, swap chains.
             Ref<DeviceMemory> m_memory;
 
+            //! The ID used to index resource state tables of command buffers, see `Device::allocate_resource_id`.
+            u32 m_resource_id = U32_MAX;
+
             // Global state.
             Vector<ImageGlobalState> m_global_states;
 
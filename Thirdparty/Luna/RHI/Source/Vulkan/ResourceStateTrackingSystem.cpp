@@ -153,19 +153,33 @@ namespace Luna
         void ResourceStateTrackingSystem::pack_buffer(const BufferBarrier& barrier)
         {
             BufferResource* res = cast_object<BufferResource>(barrier.buffer->get_object());
-            auto iter = m_current_buffer_states.find(res);
-            if (iter == m_current_buffer_states.end())
+            BufferTrackingState* state = find_buffer(res);
+            if (!state)
             {
                 // This resource is used on the current buffer for the first time.
-                m_unresolved_buffer_states.insert(make_pair(res, barrier));
-                m_current_buffer_states.insert(make_pair(res, barrier.after));
+                u32 id = res->m_resource_id;
+                if (id >= m_buffer_indices.size()) m_buffer_indices.resize(id + 1, U32_MAX);
+                m_buffer_indices[id] = (u32)m_buffer_states.size();
+                BufferTrackingState new_state;
+                new_state.m_res = res;
+                new_state.m_first_barrier = barrier;
+                new_state.m_current_state = barrier.after;
+                bool before_state_known = barrier.before != BufferStateFlag::automatic ||
+                    test_flags(barrier.flags, ResourceBarrierFlag::aliasing) ||
+                    test_flags(barrier.flags, ResourceBarrierFlag::discard_content);
+                new_state.m_first_barrier_recorded = is_first_barrier_recordable(before_state_known, res->m_owning_queue_family_index);
+                if (new_state.m_first_barrier_recorded)
+                {
+                    pack_buffer_internal(res, barrier, 0, 0, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+                }
+                m_buffer_states.push_back(new_state);
             }
             else
             {
-                pack_buffer_internal(res, barrier, 
-                    encode_access_flags(iter->second), determine_pipeline_stage_flags(iter->second, m_queue_type), 
+                pack_buffer_internal(res, barrier,
+                    encode_access_flags(state->m_current_state), determine_pipeline_stage_flags(state->m_current_state, m_queue_type),
                     VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
-                iter->second = barrier.after;
+                state->m_current_state = barrier.after;
             }
         }
         void ResourceStateTrackingSystem::pack_image(const TextureBarrier& barrier)
@@ -186,36 +200,105 @@ namespace Luna
             }
             else
             {
-                ImageResourceKey key;
-                key.m_res = res;
-                key.m_subres = barrier.subresource;
-                auto iter = m_current_image_states.find(key);
-                if (iter == m_current_image_states.end())
+                u32 first_subresource_state;
+                ImageTrackingState* image = find_image(res);
+                if (image)
+                {
+                    first_subresource_state = image->m_first_subresource_state;
+                }
+                else
+                {
+                    // Allocates states for all subresources of the image.
+                    u32 id = res->m_resource_id;
+                    if (id >= m_image_indices.size()) m_image_indices.resize(id + 1, U32_MAX);
+                    m_image_indices[id] = (u32)m_image_states.size();
+                    first_subresource_state = (u32)m_image_subresource_states.size();
+                    ImageTrackingState new_image;
+                    new_image.m_res = res;
+                    new_image.m_first_subresource_state = first_subresource_state;
+                    m_image_states.push_back(new_image);
+                    ImageSubresourceTrackingState unused_state{};
+                    unused_state.m_used = false;
+                    unused_state.m_first_barrier_recorded = false;
+                    m_image_subresource_states.resize(m_image_subresource_states.size() + res->count_subresources(), unused_state);
+                }
+                u32 subresource_index = calc_subresource_state_index(barrier.subresource.mip_slice, barrier.subresource.array_slice, res->m_desc.mip_levels);
+                auto& state = m_image_subresource_states[first_subresource_state + subresource_index];
+                if (!state.m_used)
                 {
                     // This resource is used on the current buffer for the first time.
-                    m_unresolved_image_states.insert(make_pair(key, barrier));
-                    m_current_image_states.insert(make_pair(key, barrier.after));
+                    state.m_used = true;
+                    state.m_first_barrier = barrier;
+                    state.m_current_state = barrier.after;
+                    bool before_state_known = barrier.before != TextureStateFlag::automatic ||
+                        test_flags(barrier.flags, ResourceBarrierFlag::aliasing) ||
+                        test_flags(barrier.flags, ResourceBarrierFlag::discard_content);
+                    u32 owning_queue_family_index;
+                    {
+                        LockGuard guard(res->m_image_views_lock);
+                        owning_queue_family_index = res->m_global_states[subresource_index].m_owning_queue_family_index;
+                    }
+                    state.m_first_barrier_recorded = is_first_barrier_recordable(before_state_known, owning_queue_family_index);
+                    if (state.m_first_barrier_recorded)
+                    {
+                        // The old layout is not used if the before state is automatic, since the content is discarded.
+                        ImageState before_state;
+                        before_state.access_flags = 0;
+                        before_state.image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                        pack_image_internal(res, barrier, before_state, 0, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+                    }
                 }
                 else
                 {
                     ImageState tracked_state;
-                    tracked_state.access_flags = encode_access_flags(iter->second);
-                    tracked_state.image_layout = encode_image_layout(iter->second);
-                    pack_image_internal(res, barrier, 
-                        tracked_state, determine_pipeline_stage_flags(iter->second, m_queue_type),
+                    tracked_state.access_flags = encode_access_flags(state.m_current_state);
+                    tracked_state.image_layout = encode_image_layout(state.m_current_state);
+                    pack_image_internal(res, barrier,
+                        tracked_state, determine_pipeline_stage_flags(state.m_current_state, m_queue_type),
                         VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
-                    iter->second = barrier.after;
+                    state.m_current_state = barrier.after;
                 }
             }
         }
+        //! Checks whether the first barrier of one resource can be skipped because the resource is already in the
+        //! after state. This is `true` only if both the global state and the after state are read-only, so that the
+        //! resource is not written since its content is made visible to accesses of the global state.
+        inline bool is_first_barrier_redundant(BufferStateFlag global_state, const BufferBarrier& barrier)
+        {
+            if (barrier.before != BufferStateFlag::automatic || barrier.flags != ResourceBarrierFlag::none) return false;
+            if (global_state == BufferStateFlag::none) return false;
+            if (!is_read_only_state(global_state) || !is_read_only_state(barrier.after)) return false;
+            return ((u32)barrier.after & ~(u32)global_state) == 0;
+        }
+        inline bool is_first_barrier_redundant(const ImageGlobalState& global_state, const TextureBarrier& barrier)
+        {
+            if (barrier.before != TextureStateFlag::automatic || barrier.flags != ResourceBarrierFlag::none) return false;
+            if (global_state.m_state == TextureStateFlag::none) return false;
+            if (!is_read_only_state(global_state.m_state) || !is_read_only_state(barrier.after)) return false;
+            if (encode_image_layout(barrier.after) != global_state.m_image_layout) return false;
+            return ((u32)barrier.after & ~(u32)global_state.m_state) == 0;
+        }
         void ResourceStateTrackingSystem::resolve()
         {
             begin_new_barriers_batch();
-            for (auto& i : m_unresolved_buffer_states)
+            for (auto& i : m_buffer_states)
             {
-                u32 before_queue = i.first->m_owning_queue_family_index;
+                BufferResource* res = i.m_res;
+                u32 before_queue = res->m_owning_queue_family_index;
                 if (before_queue == U32_MAX) before_queue = m_queue_family_index;
-                pack_buffer_internal(i.first, i.second, 0, 0, before_queue, m_queue_family_index);
+                if (i.m_first_barrier_recorded)
+                {
+                    if (before_queue == m_queue_family_index) continue;
+                    // The resource is acquired by another queue after the first barrier is recorded, transfer the 
+                    // ownership back without changing its state.
+                    BufferBarrier transfer_barrier(i.m_first_barrier.buffer, res->m_global_state, res->m_global_state);
+                    pack_buffer_internal(res, transfer_barrier, 0, 0, before_queue, m_queue_family_index);
+                }
+                else
+                {
+                    if (before_queue == m_queue_family_index && is_first_barrier_redundant(res->m_global_state, i.m_first_barrier)) continue;
+                    pack_buffer_internal(res, i.m_first_barrier, 0, 0, before_queue, m_queue_family_index);
+                }
                 if (before_queue != m_queue_family_index)
                 {
                     // queue ownership transfer.
@@ -223,21 +306,43 @@ namespace Luna
                     iter->second.buffer_barriers.push_back(m_buffer_barriers.back());
                 }
             }
-            for (auto& i : m_unresolved_image_states)
+            for (auto& image : m_image_states)
             {
-                LockGuard guard(i.first.m_res->m_image_views_lock);
-                auto global_state = i.first.m_res->m_global_states[calc_subresource_state_index(i.first.m_subres.mip_slice, i.first.m_subres.array_slice, i.first.m_res->m_desc.mip_levels)];
-                u32 before_queue = global_state.m_owning_queue_family_index;
-                if (before_queue == U32_MAX) before_queue = m_queue_family_index;
-                ImageState before_state;
-                before_state.access_flags = 0;
-                before_state.image_layout = global_state.m_image_layout;
-                pack_image_internal(i.first.m_res, i.second, before_state, 0, before_queue, m_queue_family_index);
-                if (before_queue != m_queue_family_index)
+                ImageResource* res = image.m_res;
+                u32 num_subresources = res->count_subresources();
+                for (u32 subresource_index = 0; subresource_index < num_subresources; ++subresource_index)
                 {
-                    // queue ownership transfer.
-                    auto iter = m_queue_transfer_barriers.insert(make_pair(before_queue, QueueTransferBarriers())).first;
-                    iter->second.image_barriers.push_back(m_image_barriers.back());
+                    auto& i = m_image_subresource_states[image.m_first_subresource_state + subresource_index];
+                    if (!i.m_used) continue;
+                    ImageGlobalState global_state;
+                    {
+                        LockGuard guard(res->m_image_views_lock);
+                        global_state = res->m_global_states[subresource_index];
+                    }
+                    u32 before_queue = global_state.m_owning_queue_family_index;
+                    if (before_queue == U32_MAX) before_queue = m_queue_family_index;
+                    ImageState before_state;
+                    before_state.access_flags = 0;
+                    before_state.image_layout = global_state.m_image_layout;
+                    if (i.m_first_barrier_recorded)
+                    {
+                        if (before_queue == m_queue_family_index) continue;
+                        // The resource is acquired by another queue after the first barrier is recorded, transfer the 
+                        // ownership back without changing its state.
+                        TextureBarrier transfer_barrier(i.m_first_barrier.texture, i.m_first_barrier.subresource, global_state.m_state, global_state.m_state);
+                        pack_image_internal(res, transfer_barrier, before_state, 0, before_queue, m_queue_family_index);
+                    }
+                    else
+                    {
+                        if (before_queue == m_queue_family_index && is_first_barrier_redundant(global_state, i.m_first_barrier)) continue;
+                        pack_image_internal(res, i.m_first_barrier, before_state, 0, before_queue, m_queue_family_index);
+                    }
+                    if (before_queue != m_queue_family_index)
+                    {
+                        // queue ownership transfer.
+                        auto iter = m_queue_transfer_barriers.insert(make_pair(before_queue, QueueTransferBarriers())).first;
+                        iter->second.image_barriers.push_back(m_image_barriers.back());
+                    }
                 }
             }
             if (m_src_stage_flags == 0) m_src_stage_flags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
@@ -246,21 +351,27 @@ namespace Luna
         void ResourceStateTrackingSystem::generate_finish_barriers()
         {
             begin_new_barriers_batch();
-            for (auto& i : m_current_buffer_states)
+            for (auto& i : m_buffer_states)
             {
-                append_buffer(i.first, encode_access_flags(i.second), 0);
-                m_src_stage_flags |= determine_pipeline_stage_flags(i.second, m_queue_type);
+                append_buffer(i.m_res, encode_access_flags(i.m_current_state), 0);
+                m_src_stage_flags |= determine_pipeline_stage_flags(i.m_current_state, m_queue_type);
             }
-            for (auto& i : m_current_image_states)
+            for (auto& image : m_image_states)
             {
-                ImageState before;
-                before.access_flags = encode_access_flags(i.second);
-                before.image_layout = encode_image_layout(i.second);
-                ImageState after;
-                after.access_flags = 0;
-                after.image_layout = encode_image_layout(i.second);
-                append_image(i.first.m_res, i.first.m_subres, before, after);
-                m_src_stage_flags |= determine_pipeline_stage_flags(i.second, m_queue_type);
+                u32 num_subresources = image.m_res->count_subresources();
+                for (u32 subresource_index = 0; subresource_index < num_subresources; ++subresource_index)
+                {
+                    auto& i = m_image_subresource_states[image.m_first_subresource_state + subresource_index];
+                    if (!i.m_used) continue;
+                    ImageState before;
+                    before.access_flags = encode_access_flags(i.m_current_state);
+                    before.image_layout = encode_image_layout(i.m_current_state);
+                    ImageState after;
+                    after.access_flags = 0;
+                    after.image_layout = encode_image_layout(i.m_current_state);
+                    append_image(image.m_res, i.m_first_barrier.subresource, before, after);
+                    m_src_stage_flags |= determine_pipeline_stage_flags(i.m_current_state, m_queue_type);
+                }
             }
             if (m_src_stage_flags == 0)
             {
@@ -270,18 +381,27 @@ namespace Luna
         }
         void ResourceStateTrackingSystem::apply()
         {
-            for (auto& i : m_current_buffer_states)
+            for (auto& i : m_buffer_states)
             {
-                BufferResource* res = i.first;
+                BufferResource* res = i.m_res;
                 res->m_owning_queue_family_index = m_queue_family_index;
+                res->m_global_state = i.m_current_state;
             }
-            for (auto& i : m_current_image_states)
+            for (auto& image : m_image_states)
             {
-                ImageResource* res = i.first.m_res;
-                u32 subresource_index = calc_subresource_state_index(i.first.m_subres.mip_slice, i.first.m_subres.array_slice, res->m_desc.mip_levels);
-                res->m_global_states[subresource_index].m_image_layout = encode_image_layout(i.second);
-                res->m_global_states[subresource_index].m_owning_queue_family_index = m_queue_family_index;
+                ImageResource* res = image.m_res;
+                LockGuard guard(res->m_image_views_lock);
+                u32 num_subresources = res->count_subresources();
+                for (u32 subresource_index = 0; subresource_index < num_subresources; ++subresource_index)
+                {
+                    auto& i = m_image_subresource_states[image.m_first_subresource_state + subresource_index];
+                    if (!i.m_used) continue;
+                    auto& global_state = res->m_global_states[subresource_index];
+                    global_state.m_image_layout = encode_image_layout(i.m_current_state);
+                    global_state.m_owning_queue_family_index = m_queue_family_index;
+                    global_state.m_state = i.m_current_state;
+                }
             }
         }
     }
-}
\ No newline at end of file
+}
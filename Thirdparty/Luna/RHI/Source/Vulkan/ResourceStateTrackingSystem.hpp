@@ -15,38 +15,30 @@ namespace Luna
 {
     namespace RHI
     {
-        struct ImageResourceKey
+        inline constexpr u32 calc_subresource_state_index(u32 mip_slice, u32 array_slice, u32 mip_levels)
         {
-            ImageResource* m_res;
-            SubresourceIndex m_subres;
-
-            bool operator==(const ImageResourceKey& rhs) const
+            if (mip_slice == U32_MAX && array_slice == U32_MAX)
             {
-                return m_res == rhs.m_res && m_subres == rhs.m_subres;
+                return U32_MAX;
             }
-        };
-    }
+            return mip_slice + array_slice * mip_levels;
+        }
 
-    template<>
-    struct hash<RHI::ImageResourceKey>
-    {
-        usize operator()(const RHI::ImageResourceKey& value)
+        inline bool is_read_only_state(BufferStateFlag state)
         {
-            usize h = (usize)value.m_res;
-            h ^= hash<RHI::SubresourceIndex>()(value.m_subres);
-            return h;
+            return !test_flags(state, BufferStateFlag::shader_write_ps) &&
+                !test_flags(state, BufferStateFlag::shader_write_cs) &&
+                !test_flags(state, BufferStateFlag::copy_dest);
         }
-    };
 
-    namespace RHI
-    {
-        inline constexpr u32 calc_subresource_state_index(u32 mip_slice, u32 array_slice, u32 mip_levels)
+        inline bool is_read_only_state(TextureStateFlag state)
         {
-            if (mip_slice == U32_MAX && array_slice == U32_MAX)
-            {
-                return U32_MAX;
-            }
-            return mip_slice + array_slice * mip_levels;
+            return !test_flags(state, TextureStateFlag::shader_write_ps) &&
+                !test_flags(state, TextureStateFlag::color_attachment_write) &&
+                !test_flags(state, TextureStateFlag::depth_stencil_attachment_write) &&
+                !test_flags(state, TextureStateFlag::resolve_attachment) &&
+                !test_flags(state, TextureStateFlag::shader_write_cs) &&
+                !test_flags(state, TextureStateFlag::copy_dest);
         }
 
         struct ImageState
@@ -65,6 +57,39 @@ namespace Luna
             Vector<VkImageMemoryBarrier> image_barriers;
         };
 
+        struct BufferTrackingState
+        {
+            BufferResource* m_res;
+            //! The first barrier of the resource in the command buffer.
+            BufferBarrier m_first_barrier;
+            //! The current state of the resource in the command buffer.
+            BufferStateFlag m_current_state;
+            //! `true` if the first barrier is recorded in the command buffer directly, so that only the queue ownership
+            //! transfer needs to be resolved when the command buffer is submitted.
+            bool m_first_barrier_recorded;
+        };
+
+        struct ImageTrackingState
+        {
+            ImageResource* m_res;
+            //! The index of the state of the first subresource in `m_image_subresource_states`. States of all
+            //! subresources of the image are stored continuously.
+            u32 m_first_subresource_state;
+        };
+
+        struct ImageSubresourceTrackingState
+        {
+            //! The first barrier of the subresource in the command buffer. Valid only if `m_used` is `true`.
+            TextureBarrier m_first_barrier;
+            //! The current state of the subresource in the command buffer. Valid only if `m_used` is `true`.
+            TextureStateFlag m_current_state;
+            //! `true` if the subresource is used in the command buffer.
+            bool m_used;
+            //! `true` if the first barrier is recorded in the command buffer directly, so that only the queue ownership
+            //! transfer needs to be resolved when the command buffer is submitted.
+            bool m_first_barrier_recorded;
+        };
+
         class ResourceStateTrackingSystem
         {
         public:
@@ -72,15 +97,19 @@ namespace Luna
             CommandQueueType m_queue_type = CommandQueueType::graphics;
             u32 m_queue_family_index;
 
-            //! Tables for unresolved resources. Unlike most implementations in other library, because 
-            //! we don't know when the list will be submitted to the queue, we defer the resolving of this 
-            //! to the time when the list is actually submitted.
-            HashMap<BufferResource*, BufferBarrier> m_unresolved_buffer_states;
-            HashMap<ImageResourceKey, TextureBarrier> m_unresolved_image_states;
-
-            //! Tables for the current state of resources.
-            HashMap<BufferResource*, BufferStateFlag> m_current_buffer_states;
-            HashMap<ImageResourceKey, TextureStateFlag> m_current_image_states;
+            //! Tables for resources used in the command buffer. Unlike most implementations in other library, because
+            //! we don't know when the list will be submitted to the queue, we defer the resolving of the first barrier
+            //! of every resource to the time when the list is actually submitted.
+            //!
+            //! Resources are tracked by flat arrays indexed by resource IDs: `m_buffer_indices[id]` stores the index of the
+            //! resource in `m_buffer_states`, which is valid only if the index is in range and the state refers to the same
+            //! resource. In this way, looking up one resource does not need hashing, and the tables can be reset without
+            //! clearing the index arrays.
+            Vector<u32> m_buffer_indices;
+            Vector<BufferTrackingState> m_buffer_states;
+            Vector<u32> m_image_indices;
+            Vector<ImageTrackingState> m_image_states;
+            Vector<ImageSubresourceTrackingState> m_image_subresource_states;
 
             Vector<VkBufferMemoryBarrier> m_buffer_barriers;
             Vector<VkImageMemoryBarrier> m_image_barriers;
@@ -92,10 +121,9 @@ namespace Luna
 
             void reset()
             {
-                m_unresolved_buffer_states.clear();
-                m_unresolved_image_states.clear();
-                m_current_buffer_states.clear();
-                m_current_image_states.clear();
+                m_buffer_states.clear();
+                m_image_states.clear();
+                m_image_subresource_states.clear();
             }
 
             void begin_new_barriers_batch()
@@ -107,32 +135,66 @@ namespace Luna
                 m_queue_transfer_barriers.clear();
             }
 
-            VkImageLayout get_image_layout(ImageResource* res, const SubresourceIndex& subresource) const
+            //! Checks whether any resource is used in the command buffer.
+            bool has_tracked_resources() const
+            {
+                return !m_buffer_states.empty() || !m_image_states.empty();
+            }
+
+            BufferTrackingState* find_buffer(BufferResource* res)
+            {
+                u32 id = res->m_resource_id;
+                if (id >= m_buffer_indices.size()) return nullptr;
+                u32 index = m_buffer_indices[id];
+                if (index >= m_buffer_states.size() || m_buffer_states[index].m_res != res) return nullptr;
+                return &m_buffer_states[index];
+            }
+
+            ImageTrackingState* find_image(ImageResource* res)
+            {
+                u32 id = res->m_resource_id;
+                if (id >= m_image_indices.size()) return nullptr;
+                u32 index = m_image_indices[id];
+                if (index >= m_image_states.size() || m_image_states[index].m_res != res) return nullptr;
+                return &m_image_states[index];
+            }
+
+            VkImageLayout get_image_layout(ImageResource* res, const SubresourceIndex& subresource)
             {
-                ImageResourceKey k;
-                k.m_res = res;
-                k.m_subres = subresource;
-                auto iter = m_current_image_states.find(k);
-                if (iter == m_current_image_states.end())
+                u32 subresource_index = calc_subresource_state_index(subresource.mip_slice, subresource.array_slice, res->m_desc.mip_levels);
+                ImageTrackingState* image = find_image(res);
+                if (image)
                 {
-                    u32 subresource_index = calc_subresource_state_index(subresource.mip_slice, subresource.array_slice, res->m_desc.mip_levels);
-                    return res->m_global_states[subresource_index].m_image_layout;
+                    auto& state = m_image_subresource_states[image->m_first_subresource_state + subresource_index];
+                    if (state.m_used)
+                    {
+                        return encode_image_layout(state.m_current_state);
+                    }
                 }
-                return encode_image_layout(iter->second);
+                return res->m_global_states[subresource_index].m_image_layout;
             }
 
         private:
-            void append_buffer(BufferResource* res, VkAccessFlags before, VkAccessFlags after, 
+            void append_buffer(BufferResource* res, VkAccessFlags before, VkAccessFlags after,
                 u32 before_queue_family_index = VK_QUEUE_FAMILY_IGNORED, u32 after_queue_family_index = VK_QUEUE_FAMILY_IGNORED);
             void append_image(ImageResource* res, const SubresourceIndex& subresource, const ImageState& before, const ImageState& after,
                 u32 before_queue_family_index = VK_QUEUE_FAMILY_IGNORED, u32 after_queue_family_index = VK_QUEUE_FAMILY_IGNORED);
 
-            void pack_buffer_internal(BufferResource* res, const BufferBarrier& barrier, 
-                VkAccessFlags recorded_src_access_flags, VkPipelineStageFlags recorded_src_pipeline_stage_flags, 
+            void pack_buffer_internal(BufferResource* res, const BufferBarrier& barrier,
+                VkAccessFlags recorded_src_access_flags, VkPipelineStageFlags recorded_src_pipeline_stage_flags,
                 u32 before_queue_family_index, u32 after_queue_family_index);
             void pack_image_internal(ImageResource* res, const TextureBarrier& barrier,
                 const ImageState& recorded_before_state, VkPipelineStageFlags recorded_src_pipeline_stage_flags,
                 u32 before_queue_family_index, u32 after_queue_family_index);
+
+            //! Checks whether the first barrier of one resource can be recorded in the command buffer directly.
+            //! This is `true` if the barrier does not depend on the global state of the resource, and no queue
+            //! ownership transfer is needed when the barrier is recorded.
+            bool is_first_barrier_recordable(bool before_state_known, u32 owning_queue_family_index) const
+            {
+                return before_state_known &&
+                    (owning_queue_family_index == U32_MAX || owning_queue_family_index == m_queue_family_index);
+            }
         public:
 
             //! Appends one barrier that transits the specified subresources' state to after
@@ -140,7 +202,9 @@ namespace Luna
             void pack_buffer(const BufferBarrier& barrier);
             void pack_image(const TextureBarrier& barrier);
 
-            //! Resolves all unresolved transitions into m_transitions based on their current state.
+            //! Resolves the first barriers of all resources based on their global state.
+            //! Barriers that are already recorded, and barriers that do not change the global state of the resource
+            //! are skipped, so this may generate no barrier.
             void resolve();
 
             //! Generates barriers that should be inserted at the end of the command buffer.
@@ -150,4 +214,4 @@ namespace Luna
             void apply();
         };
     }
-}
\ No newline at end of file
+}
@@ -143,7 +143,7 @@ namespace Luna
                     res->m_device = m_device;
                     res->m_desc = desc;
                     res->m_image = images[i];
-                    res->m_global_states.emplace_back();
+                    res->post_init();
                     res->m_is_image_externally_managed = true;
                     m_swap_chain_images.push_back(res);
                 }
@@ -0,0 +1,130 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file UploadRingBuffer.hpp
+* @author JXMaster
+* @date 2026/10/17
+* @brief Ring allocator for per-frame upload data.
+*/
+#pragma once
+#include "Device.hpp"
+#ifndef LUNA_RHI_API
+#define LUNA_RHI_API
+#endif
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! @addtogroup RHI
+        //! @{
+
+        //! Describes one @ref IUploadRingBuffer object.
+        struct UploadRingBufferDesc
+        {
+            //! The initial size, in bytes, of the upload buffer. The buffer grows if the memory is not enough, so this
+            //! should be set to the size of data uploaded for all frames in flight to prevent growing.
+            u64 size;
+            //! The usages of the upload buffer. This must include @ref BufferUsageFlag::copy_source if the ring is used
+            //! for staging copies.
+            BufferUsageFlag usages;
+            //! The default alignment of allocations, in bytes. If this is 0, the alignment required by uniform buffer views
+            //! (@ref DeviceFeature::uniform_buffer_data_alignment) is used, so that every allocation can be bound as uniform buffer.
+            u64 default_alignment;
+
+            UploadRingBufferDesc(u64 size = 4 * 1024 * 1024,
+                BufferUsageFlag usages = BufferUsageFlag::copy_source | BufferUsageFlag::uniform_buffer |
+                    BufferUsageFlag::read_buffer | BufferUsageFlag::vertex_buffer | BufferUsageFlag::index_buffer,
+                u64 default_alignment = 0) :
+                size(size),
+                usages(usages),
+                default_alignment(default_alignment) {}
+        };
+
+        //! Describes one memory range allocated from @ref IUploadRingBuffer.
+        struct UploadRingBufferAllocation
+        {
+            //! The upload buffer that contains the allocated range. The buffer is valid until the frame that allocates
+            //! the range is completed.
+            IBuffer* buffer;
+            //! The offset, in bytes, of the allocated range from the beginning of `buffer`.
+            u64 offset;
+            //! The size, in bytes, of the allocated range.
+            u64 size;
+            //! The host pointer to the allocated range. The memory is persistently mapped and can be written directly.
+            void* data;
+        };
+
+        //! Describes the memory usage of one @ref IUploadRingBuffer object.
+        struct UploadRingBufferStatistics
+        {
+            //! The size, in bytes, of the current upload buffer.
+            u64 capacity;
+            //! The size, in bytes, of memory used by the current frame and all pending frames.
+            u64 used_size;
+            //! The number of frames that are ended but not completed by GPU.
+            u32 num_pending_frames;
+            //! The number of allocations performed in the current frame.
+            u64 num_frame_allocations;
+            //! The number of upload buffers created by this ring since the ring is created.
+            u64 num_buffer_creations;
+        };
+
+        //! @interface IUploadRingBuffer
+        //! Allocates memory for per-frame upload data (like uniform data and dynamic vertex data) from one persistently mapped
+        //! upload buffer, so that no buffer is created when uploading data every frame.
+        //! @details Memory is allocated linearly from one ring buffer. Memory allocated in one frame is released when the fence
+        //! value specified in @ref end_frame is reached, so one ring can be shared by all frames in flight.
+        //!
+        //! All functions of this interface are thread-safe.
+        struct IUploadRingBuffer : virtual Interface
+        {
+            luiid("{5c0d2e8a-3f7b-4a61-9d2c-7e4b1a8f6c35}");
+
+            //! Gets the device that owns the upload buffer.
+            virtual IDevice* get_device() = 0;
+
+            //! Gets the descriptor of the ring.
+            virtual const UploadRingBufferDesc& get_desc() = 0;
+
+            //! Allocates one memory range for the current frame.
+            //! @param[in] size The size, in bytes, to allocate.
+            //! @param[in] alignment The alignment, in bytes, of the allocated range. If this is 0, @ref UploadRingBufferDesc::default_alignment
+            //! is used.
+            //! @return Returns the allocated memory range.
+            //! @remark If the ring does not have enough free memory, memory used by completed frames is released. If the memory is still not
+            //! enough, one larger upload buffer is created, and the old buffer is released when the current frame is completed.
+            virtual R<UploadRingBufferAllocation> allocate(u64 size, u64 alignment = 0) = 0;
+
+            //! Allocates one memory range for the current frame and copies data to it.
+            //! @param[in] data The data to copy.
+            //! @param[in] size The size, in bytes, of the data.
+            //! @param[in] alignment The alignment, in bytes, of the allocated range. If this is 0, @ref UploadRingBufferDesc::default_alignment
+            //! is used.
+            //! @return Returns the allocated memory range.
+            virtual R<UploadRingBufferAllocation> upload(const void* data, u64 size, u64 alignment = 0) = 0;
+
+            //! Ends the current frame and starts a new frame.
+            //! @param[in] fence The timeline fence that will be signaled after all GPU commands reading memory of the current frame
+            //! are completed. If this is `nullptr`, the user must ensure that such commands are completed before this function is called,
+            //! and memory of the current frame is released as soon as memory of all previous frames is released.
+            //! @param[in] fence_value The fence value that indicates the completion of the current frame.
+            //! @return Returns @ref BasicError::bad_arguments if `fence` is not `nullptr` and is not a timeline fence, since the 
+            //! completion of binary fences cannot be queried. The current frame is not ended in such case.
+            virtual RV end_frame(IFence* fence, u64 fence_value) = 0;
+
+            //! Gets the memory usage of the ring.
+            virtual UploadRingBufferStatistics get_statistics() = 0;
+        };
+
+        //! Creates one new upload ring buffer.
+        //! @param[in] device The device used to create upload buffers.
+        //! @param[in] desc The descriptor of the ring.
+        //! @return Returns the created ring.
+        LUNA_RHI_API R<Ref<IUploadRingBuffer>> new_upload_ring_buffer(IDevice* device, const UploadRingBufferDesc& desc = UploadRingBufferDesc());
+
+        //! @}
+    }
+}
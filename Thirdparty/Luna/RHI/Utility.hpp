@@ -11,6 +11,7 @@
 #pragma once
 #include "Resource.hpp"
 #include "CommandBuffer.hpp"
+#include "UploadRingBuffer.hpp"
 #ifndef LUNA_RHI_API
 #define LUNA_RHI_API
 #endif
@@ -196,6 +197,21 @@ namespace Luna
         //! and synchronization overhead.
         LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies);
 
+        //! Records commands that copy data from host memory to resource memory, using memory allocated from one upload ring to 
+        //! stage the data.
+        //! @details Unlike @ref copy_resource_data, this function does not create any buffer, and does not submit or wait for 
+        //! `command_buffer`, so that copies of one frame can be recorded to the command buffer with other commands of the frame 
+        //! and submitted once. The staging memory is allocated from the current frame of `upload_ring`, and is released after 
+        //! the frame is completed, so the fence specified for the frame in @ref IUploadRingBuffer::end_frame must be signaled 
+        //! after `command_buffer` is finished.
+        //! @param[in] command_buffer The command buffer to record copy commands to.
+        //! @param[in] upload_ring The upload ring to allocate staging memory from. The ring must be created with 
+        //! @ref BufferUsageFlag::copy_source usage.
+        //! @param[in] copies A number of copy operations that should be performed. 
+        //! @return Returns @ref BasicError::bad_arguments if `copies` contains @ref ResourceDataCopyOp::read_buffer or 
+        //! @ref ResourceDataCopyOp::read_texture operations, since data cannot be read before the command buffer is finished.
+        LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, IUploadRingBuffer* upload_ring, Span<const CopyResourceData> copies);
+
         //! @}
     }
 }
\ No newline at end of file
@@ -26,7 +26,11 @@ luna_sdk_module_target("RHI")
         add_files("Source/Metal/**.cpp", "Source/Metal/**.mm")
         add_frameworks("Foundation", "QuartzCore", "Metal")
         add_deps("VariantUtils")
+    elseif is_config("rhi_api", "Null") then
+        add_defines("LUNA_RHI_NULL")
+        add_headerfiles("Source/Null/**.hpp", {install = false})
+        add_files("Source/Null/**.cpp")
     end
-    add_deps("Runtime", "Window")
+    add_deps("Runtime", "Window", "VFS")
 target_end()
 
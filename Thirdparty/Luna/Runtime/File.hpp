@@ -144,6 +144,34 @@ namespace Luna
     //! * `file` must be opened with @ref FileOpenFlag::read flag.
     LUNA_RUNTIME_API R<Blob> load_file_data(IFile* file);
 
+    //! @interface IMappedFile
+    //! Represents one file that is mapped into memory for reading. See @ref map_file for details.
+    struct IMappedFile : virtual Interface
+    {
+        luiid("{0d7e4a93-6b2c-4f18-b5e1-9c3a8f27d640}");
+
+        //! Gets the mapped file data.
+        //! @return Returns one pointer to the mapped file data, or `nullptr` if the file is empty. 
+        //! The data is read-only, and is valid until the mapped file object is released.
+        virtual const void* get_data() = 0;
+
+        //! Gets the size of the mapped file data.
+        //! @return Returns the size of the mapped file data in bytes.
+        virtual u64 get_size() = 0;
+    };
+
+    //! Maps the whole file into memory for reading.
+    //! @details Pages of the file are loaded by the operating system on demand when being accessed, so reading 
+    //! parts of one large file does not need to read the whole file. The behavior is undefined if the file 
+    //! is modified or truncated by other processes while being mapped.
+    //! @param[in] path The path of the file to map.
+    //! @return Returns the mapped file object.
+    //! @par Possible Errors
+    //! * @ref BasicError::access_denied
+    //! * @ref BasicError::not_found
+    //! * @ref BasicError::bad_platform_call for all errors that cannot be identified.
+    LUNA_RUNTIME_API R<Ref<IMappedFile>> map_file(const c8* path);
+
     //! Gets the file attribute.
     //! @param[in] path The path of the file.
     //! @return Returns the file attribute structure.
@@ -47,6 +47,23 @@ namespace Luna
         lucatchret;
         return ret;
     }
+    LUNA_RUNTIME_API R<Ref<IMappedFile>> map_file(const c8* path)
+    {
+        Ref<IMappedFile> ret;
+        lutry
+        {
+            const void* data = nullptr;
+            u64 size = 0;
+            lulet(mapping, OS::map_file(path, &data, &size));
+            auto file = new_object<MappedFile>();
+            file->m_mapping = mapping;
+            file->m_data = data;
+            file->m_size = size;
+            ret = file;
+        }
+        lucatchret;
+        return ret;
+    }
     LUNA_RUNTIME_API R<FileAttribute> get_file_attribute(const c8* filename)
     {
         return OS::get_file_attribute(filename);
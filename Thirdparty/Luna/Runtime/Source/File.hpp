@@ -94,4 +94,33 @@ namespace Luna
             return OS::dir_iterator_move_next(m_handle);
         }
     };
+    struct MappedFile : IMappedFile
+    {
+        lustruct("MappedFile", "{5a1f3c82-9e4d-4b07-8c6a-2d7b0e91f4a5}");
+        luiimpl();
+
+        opaque_t m_mapping;
+        const void* m_data;
+        u64 m_size;
+
+        MappedFile() :
+            m_mapping(nullptr),
+            m_data(nullptr),
+            m_size(0) {}
+        ~MappedFile()
+        {
+            if (m_mapping)
+            {
+                OS::unmap_file(m_mapping);
+            }
+        }
+        virtual const void* get_data() override
+        {
+            return m_data;
+        }
+        virtual u64 get_size() override
+        {
+            return m_size;
+        }
+    };
 }
\ No newline at end of file
@@ -384,6 +384,21 @@ namespace Luna
         //! * BasicError::bad_platform_call for all errors that cannot be identified.
         R<FileAttribute> get_file_attribute(const c8* path);
 
+        //! Maps the whole file into the virtual address space of the process for reading.
+        //! @param[in] path The path of the file to map.
+        //! @param[out] data Receives the pointer to the mapped file data. This is `nullptr` if the file is empty.
+        //! @param[out] size Receives the size of the file in bytes.
+        //! @return Returns one handle that should be closed by `unmap_file` if succeeded. Returns error code if failed.
+        //! Possible errors:
+        //! * BasicError::access_denied
+        //! * BasicError::not_found
+        //! * BasicError::bad_platform_call for all errors that cannot be identified.
+        R<opaque_t> map_file(const c8* path, const void** data, u64* size);
+
+        //! Unmaps one file mapped by `map_file`.
+        //! @param[in] mapping The handle returned by `map_file`.
+        void unmap_file(opaque_t mapping);
+
         //! Copies the file from the source path to the destination path.
         //! Refer to docs in `File.hpp`.
         RV    copy_file(const c8* from_path, const c8* to_path, FileCopyFlag flags);
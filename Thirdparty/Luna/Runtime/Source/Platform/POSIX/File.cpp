@@ -23,6 +23,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <sys/mman.h>
 
 #ifdef LUNA_PLATFORM_MACOS
 #include <libproc.h>
@@ -539,6 +540,64 @@ namespace Luna
             }
             return attribute;
         }
+        struct FileMapping
+        {
+            void* data;
+            usize size;
+        };
+        R<opaque_t> map_file(const c8* path, const void** data, u64* size)
+        {
+            lucheck(path && data && size);
+            int fd = open(path, O_RDONLY, 0);
+            if (fd == -1)
+            {
+                auto err = errno;
+                switch (err)
+                {
+                case EACCES:
+                case EPERM:
+                    return BasicError::access_denied();
+                case ENOENT:
+                    return BasicError::not_found();
+                default:
+                    return BasicError::bad_platform_call();
+                }
+            }
+            struct stat s;
+            if (fstat(fd, &s) != 0)
+            {
+                ::close(fd);
+                return BasicError::bad_platform_call();
+            }
+            FileMapping* mapping = memnew<FileMapping>();
+            mapping->data = nullptr;
+            mapping->size = (usize)s.st_size;
+            if (mapping->size)
+            {
+                void* addr = mmap(nullptr, mapping->size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    memdelete(mapping);
+                    return BasicError::bad_platform_call();
+                }
+                mapping->data = addr;
+            }
+            // The mapping is still valid after the file descriptor is closed.
+            ::close(fd);
+            *data = mapping->data;
+            *size = mapping->size;
+            return mapping;
+        }
+        void unmap_file(opaque_t mapping)
+        {
+            FileMapping* m = (FileMapping*)mapping;
+            if (m->data)
+            {
+                munmap(m->data, m->size);
+            }
+            memdelete(m);
+        }
         RV copy_file(const c8* from_path, const c8* to_path, FileCopyFlag flags)
         {
             lucheck(from_path && to_path);
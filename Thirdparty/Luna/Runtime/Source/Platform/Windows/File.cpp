@@ -542,6 +542,60 @@ namespace Luna
             attribute.last_write_time = file_time_to_timestamp(d.ftLastWriteTime);
             return attribute;
         }
+        R<opaque_t> map_file(const c8* path, const void** data, u64* size)
+        {
+            lucheck(path && data && size);
+            usize buffer_size = utf8_to_utf16_len(path) + 1;
+            wchar_t* pathbuffer = (wchar_t*)alloca(sizeof(wchar_t) * buffer_size);
+            utf8_to_utf16((char16_t*)pathbuffer, buffer_size, path);
+            HANDLE file = ::CreateFileW(pathbuffer, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return translate_last_error(::GetLastError());
+            }
+            LARGE_INTEGER file_size;
+            if (!::GetFileSizeEx(file, &file_size))
+            {
+                DWORD err = ::GetLastError();
+                ::CloseHandle(file);
+                return translate_last_error(err);
+            }
+            void* view = nullptr;
+            if (file_size.QuadPart)
+            {
+                HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping)
+                {
+                    DWORD err = ::GetLastError();
+                    ::CloseHandle(file);
+                    return translate_last_error(err);
+                }
+                view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                DWORD err = ::GetLastError();
+                // The view keeps the mapping object alive, so both handles can be closed here.
+                ::CloseHandle(mapping);
+                ::CloseHandle(file);
+                if (!view)
+                {
+                    return translate_last_error(err);
+                }
+            }
+            else
+            {
+                ::CloseHandle(file);
+            }
+            *data = view;
+            *size = (u64)file_size.QuadPart;
+            // Use one non-null handle for empty files.
+            return view ? view : (opaque_t)(usize)1;
+        }
+        void unmap_file(opaque_t mapping)
+        {
+            if (mapping != (opaque_t)(usize)1)
+            {
+                ::UnmapViewOfFile(mapping);
+            }
+        }
         RV copy_file(const c8* from_path, const c8* to_path, FileCopyFlag flags)
         {
             lucheck(from_path && to_path);
@@ -48,6 +48,8 @@ namespace Luna
         impl_interface_for_type<File, IFile, ISeekableStream, IStream>();
         register_boxed_type<FileIterator>();
         impl_interface_for_type<FileIterator, IFileIterator>();
+        register_boxed_type<MappedFile>();
+        impl_interface_for_type<MappedFile, IMappedFile>();
         register_boxed_type<Thread>();
         impl_interface_for_type<Thread, IWaitable, IThread>();
         register_boxed_type<MainThread>();
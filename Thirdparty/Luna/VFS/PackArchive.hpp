@@ -0,0 +1,70 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackArchive.hpp
+* @author JXMaster
+* @date 2026/10/17
+* @brief Packed archive format and the VFS driver that reads files from packed archives.
+*/
+#pragma once
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/Path.hpp>
+
+#ifndef LUNA_VFS_API
+#define LUNA_VFS_API
+#endif
+
+namespace Luna
+{
+    namespace VFS
+    {
+        //! @addtogroup VFS
+        //! @{
+
+        //! Specifies the compression method of one file stored in the pack archive.
+        enum class PackCompression : u32
+        {
+            //! The file data is stored without compression. Files stored in this way can be read without copying
+            //! by fetching @ref IMappedFile from the opened file.
+            none = 0,
+            //! The file data is compressed using the LZ4 block format.
+            lz4 = 1,
+        };
+
+        //! Describes how to build one pack archive.
+        struct PackArchiveBuildDesc
+        {
+            //! The compression method used to compress files.
+            PackCompression compression;
+            //! The maximum ratio of the compressed size to the uncompressed size for one file to be stored compressed.
+            //! Files that cannot be compressed to this ratio are stored without compression, so that they can be read
+            //! without copying.
+            f32 max_compression_ratio;
+
+            PackArchiveBuildDesc(PackCompression compression = PackCompression::lz4, f32 max_compression_ratio = 0.9f) :
+                compression(compression),
+                max_compression_ratio(max_compression_ratio) {}
+        };
+
+        //! Packs all files and directories in one VFS directory recursively into one pack archive.
+        //! @details The pack archive stores one directory table sorted by paths, followed by file data that are aligned
+        //! to 4KB boundaries. The archive can be mounted to VFS using the driver returned by @ref get_pack_archive_driver.
+        //! @param[in] source_dir The VFS directory to pack.
+        //! @param[in] archive_path The VFS path of the archive file to create. If the file already exists, it will be overwritten.
+        //! @param[in] desc The archive build descriptor.
+        //! @par Valid Usage
+        //! * `archive_path` must not be in `source_dir`.
+        LUNA_VFS_API RV build_pack_archive(const Path& source_dir, const Path& archive_path, const PackArchiveBuildDesc& desc = PackArchiveBuildDesc());
+
+        //! Gets the name of the VFS driver that reads files from pack archives created by @ref build_pack_archive.
+        //! @details The driver path passed to @ref mount is the native path of the archive file. The archive file is mapped into memory when
+        //! being mounted, and is read-only: all operations that modify files fail with @ref BasicError::access_denied. Files opened from the
+        //! driver also implement @ref IMappedFile, which can be used to access file data without copying.
+        //! @return Returns the name of the pack archive driver.
+        LUNA_VFS_API Name get_pack_archive_driver();
+
+        //! @}
+    }
+}
@@ -0,0 +1,299 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackArchiveDriver.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_VFS_API LUNA_EXPORT
+#include "PackArchiveDriver.hpp"
+#include "../LZ4.hpp"
+#include "../../Driver.hpp"
+
+namespace Luna
+{
+    namespace VFS
+    {
+        RV PackArchive::init(const c8* path)
+        {
+            lutry
+            {
+                luset(m_file, map_file(path));
+                const u8* data = (const u8*)m_file->get_data();
+                u64 size = m_file->get_size();
+                if (size < sizeof(PackArchiveHeader)) return BasicError::bad_file();
+                m_header = (const PackArchiveHeader*)data;
+                if (m_header->magic != PACK_ARCHIVE_MAGIC || m_header->version != PACK_ARCHIVE_VERSION) return BasicError::bad_file();
+                u64 strings_offset = sizeof(PackArchiveHeader) + (u64)m_header->num_entries * sizeof(PackArchiveEntry);
+                if (strings_offset + m_header->string_table_size > size || m_header->num_root_entries > m_header->num_entries) return BasicError::bad_file();
+                m_entries = (const PackArchiveEntry*)(data + sizeof(PackArchiveHeader));
+                m_strings = (const c8*)(data + strings_offset);
+                // Validates all entries once, so that they can be accessed without checking later.
+                for (u32 i = 0; i < m_header->num_entries; ++i)
+                {
+                    const PackArchiveEntry& e = m_entries[i];
+                    if ((u64)e.path_offset + e.path_size >= m_header->string_table_size ||
+                        m_strings[e.path_offset + e.path_size] != 0 ||
+                        e.name_offset > e.path_size) return BasicError::bad_file();
+                    if (test_flags(e.flags, PackArchiveEntryFlag::directory))
+                    {
+                        if ((u64)e.first_child + e.num_children > m_header->num_entries) return BasicError::bad_file();
+                    }
+                    else
+                    {
+                        if (e.data_offset > size || e.stored_size > size - e.data_offset) return BasicError::bad_file();
+                        if (e.compression == PackCompression::none ? e.stored_size != e.size : e.compression != PackCompression::lz4) return BasicError::bad_file();
+                    }
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        //! Compares the name of one entry with the specified name.
+        inline i32 compare_entry_name(const c8* entry_name, usize entry_name_size, const Name& name)
+        {
+            usize len = min(entry_name_size, name.size());
+            i32 r = memcmp(entry_name, name.c_str(), len);
+            if (r) return r;
+            if (entry_name_size == name.size()) return 0;
+            return entry_name_size < name.size() ? -1 : 1;
+        }
+        R<u32> PackArchive::find_entry(const Path& path) const
+        {
+            u32 current = U32_MAX;
+            u32 first = 0;
+            u32 count = m_header->num_root_entries;
+            for (usize i = 0; i < path.size(); ++i)
+            {
+                if (current != U32_MAX && !test_flags(m_entries[current].flags, PackArchiveEntryFlag::directory))
+                {
+                    return BasicError::not_directory();
+                }
+                // Children of one directory are sorted by name, so binary search can be used.
+                const Name& name = path[i];
+                u32 begin = first;
+                u32 end = first + count;
+                current = U32_MAX;
+                while (begin < end)
+                {
+                    u32 mid = begin + (end - begin) / 2;
+                    const PackArchiveEntry& e = m_entries[mid];
+                    i32 r = compare_entry_name(m_strings + e.path_offset + e.name_offset, e.path_size - e.name_offset, name);
+                    if (r == 0)
+                    {
+                        current = mid;
+                        break;
+                    }
+                    if (r < 0) begin = mid + 1;
+                    else end = mid;
+                }
+                if (current == U32_MAX) return BasicError::not_found();
+                first = m_entries[current].first_child;
+                count = m_entries[current].num_children;
+            }
+            return current;
+        }
+        RV PackFile::read(void* buffer, usize size, usize* read_bytes)
+        {
+            usize bytes = (usize)min<u64>(size, m_size - min(m_cursor, m_size));
+            if (bytes)
+            {
+                memcpy(buffer, m_data + m_cursor, bytes);
+            }
+            m_cursor += bytes;
+            if (read_bytes) *read_bytes = bytes;
+            return ok;
+        }
+        RV PackFile::seek(i64 offset, SeekMode mode)
+        {
+            i64 base = 0;
+            switch (mode)
+            {
+            case SeekMode::begin: base = 0; break;
+            case SeekMode::current: base = (i64)m_cursor; break;
+            case SeekMode::end: base = (i64)m_size; break;
+            default: return BasicError::bad_arguments();
+            }
+            i64 cursor = base + offset;
+            if (cursor < 0) return BasicError::bad_arguments();
+            m_cursor = (u64)cursor;
+            return ok;
+        }
+        const c8* PackFileIterator::get_filename()
+        {
+            if (!is_valid()) return nullptr;
+            const PackArchiveEntry& e = m_entries[m_current];
+            return m_strings + e.path_offset + e.name_offset;
+        }
+        FileAttributeFlag PackFileIterator::get_attributes()
+        {
+            if (!is_valid()) return FileAttributeFlag::none;
+            FileAttributeFlag ret = FileAttributeFlag::read_only;
+            if (test_flags(m_entries[m_current].flags, PackArchiveEntryFlag::directory)) ret |= FileAttributeFlag::directory;
+            return ret;
+        }
+        bool PackFileIterator::move_next()
+        {
+            if (m_current < m_end) ++m_current;
+            return is_valid();
+        }
+        static R<void*> pack_mount(void* driver_data, const c8* driver_path, const Path& mount_dir, typeinfo_t params_type, void* params_data)
+        {
+            PackArchive* archive = memnew<PackArchive>();
+            auto r = archive->init(driver_path);
+            if (failed(r))
+            {
+                memdelete(archive);
+                return r.errcode();
+            }
+            return archive;
+        }
+        static RV pack_unmount(void* driver_data, void* mount_data)
+        {
+            memdelete((PackArchive*)mount_data);
+            return ok;
+        }
+        static R<Ref<IFile>> pack_open_file(void* driver_data, void* mount_data, const Path& path, FileOpenFlag flags, FileCreationMode creation)
+        {
+            auto archive = (PackArchive*)mount_data;
+            if (test_flags(flags, FileOpenFlag::write) || creation == FileCreationMode::create_always ||
+                creation == FileCreationMode::create_new || creation == FileCreationMode::open_existing_as_new)
+            {
+                return BasicError::access_denied();
+            }
+            Ref<IFile> ret;
+            lutry
+            {
+                lulet(index, archive->find_entry(path));
+                if (index == U32_MAX) return BasicError::is_directory();
+                const PackArchiveEntry& entry = archive->m_entries[index];
+                if (test_flags(entry.flags, PackArchiveEntryFlag::directory)) return BasicError::is_directory();
+                Ref<PackFile> file = new_object<PackFile>();
+                file->m_archive = archive->m_file;
+                const u8* stored_data = (const u8*)archive->m_file->get_data() + entry.data_offset;
+                if (entry.compression == PackCompression::none)
+                {
+                    // Reads from the mapped archive directly.
+                    file->m_data = stored_data;
+                }
+                else
+                {
+                    file->m_decompressed_data = Blob((usize)entry.size);
+                    if (!lz4_decompress(stored_data, (usize)entry.stored_size, (u8*)file->m_decompressed_data.data(), (usize)entry.size))
+                    {
+                        return set_error(BasicError::bad_file(), "The data of file %s in the pack archive is corrupted.", path.encode().c_str());
+                    }
+                    file->m_data = (const u8*)file->m_decompressed_data.data();
+                }
+                file->m_size = entry.size;
+                ret = file;
+            }
+            lucatchret;
+            return ret;
+        }
+        static R<FileAttribute> pack_get_file_attribute(void* driver_data, void* mount_data, const Path& path)
+        {
+            auto archive = (PackArchive*)mount_data;
+            FileAttribute ret;
+            lutry
+            {
+                lulet(index, archive->find_entry(path));
+                ret.attributes = FileAttributeFlag::read_only;
+                if (index == U32_MAX)
+                {
+                    ret.size = 0;
+                    ret.last_write_time = archive->m_header->last_write_time;
+                    ret.attributes |= FileAttributeFlag::directory;
+                }
+                else
+                {
+                    const PackArchiveEntry& entry = archive->m_entries[index];
+                    ret.size = test_flags(entry.flags, PackArchiveEntryFlag::directory) ? 0 : entry.size;
+                    ret.last_write_time = entry.last_write_time;
+                    if (test_flags(entry.flags, PackArchiveEntryFlag::directory)) ret.attributes |= FileAttributeFlag::directory;
+                }
+                ret.creation_time = ret.last_write_time;
+                ret.last_access_time = ret.last_write_time;
+            }
+            lucatchret;
+            return ret;
+        }
+        static RV pack_copy_file(void* driver_data, void* from_mount_data, void* to_mount_data, const Path& from_path, const Path& to_path, FileCopyFlag flags)
+        {
+            return BasicError::access_denied();
+        }
+        static RV pack_move_file(void* driver_data, void* from_mount_data, void* to_mount_data, const Path& from_path, const Path& to_path, FileMoveFlag flags)
+        {
+            return BasicError::access_denied();
+        }
+        static RV pack_delete_file(void* driver_data, void* mount_data, const Path& path)
+        {
+            return BasicError::access_denied();
+        }
+        static R<Ref<IFileIterator>> pack_open_dir(void* driver_data, void* mount_data, const Path& path)
+        {
+            auto archive = (PackArchive*)mount_data;
+            Ref<IFileIterator> ret;
+            lutry
+            {
+                lulet(index, archive->find_entry(path));
+                Ref<PackFileIterator> iter = new_object<PackFileIterator>();
+                iter->m_archive = archive->m_file;
+                iter->m_entries = archive->m_entries;
+                iter->m_strings = archive->m_strings;
+                if (index == U32_MAX)
+                {
+                    iter->m_current = 0;
+                    iter->m_end = archive->m_header->num_root_entries;
+                }
+                else
+                {
+                    const PackArchiveEntry& entry = archive->m_entries[index];
+                    if (!test_flags(entry.flags, PackArchiveEntryFlag::directory)) return BasicError::not_directory();
+                    iter->m_current = entry.first_child;
+                    iter->m_end = entry.first_child + entry.num_children;
+                }
+                ret = iter;
+            }
+            lucatchret;
+            return ret;
+        }
+        static RV pack_create_dir(void* driver_data, void* mount_data, const Path& path)
+        {
+            return BasicError::access_denied();
+        }
+        static R<Name> pack_get_native_path(void* driver_data, void* mount_data, const Path& path)
+        {
+            // Files in the archive do not have native paths.
+            return BasicError::not_supported();
+        }
+        void register_pack_archive_driver()
+        {
+            register_boxed_type<PackFile>();
+            impl_interface_for_type<PackFile, IFile, ISeekableStream, IStream, IMappedFile>();
+            register_boxed_type<PackFileIterator>();
+            impl_interface_for_type<PackFileIterator, IFileIterator>();
+            DriverDesc desc;
+            desc.driver_data = nullptr;
+            desc.on_driver_unregister = nullptr;
+            desc.on_mount = pack_mount;
+            desc.on_unmount = pack_unmount;
+            desc.on_open_file = pack_open_file;
+            desc.on_get_file_attribute = pack_get_file_attribute;
+            desc.on_copy_file = pack_copy_file;
+            desc.on_move_file = pack_move_file;
+            desc.on_delete_file = pack_delete_file;
+            desc.on_open_dir = pack_open_dir;
+            desc.on_create_dir = pack_create_dir;
+            desc.on_get_native_path = pack_get_native_path;
+            register_driver(get_pack_archive_driver(), desc);
+        }
+        LUNA_VFS_API Name get_pack_archive_driver()
+        {
+            return "Pack Archive";
+        }
+    }
+}
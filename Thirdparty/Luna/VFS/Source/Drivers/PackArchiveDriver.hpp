@@ -0,0 +1,128 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackArchiveDriver.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include "../../PackArchive.hpp"
+#include <Luna/Runtime/Blob.hpp>
+
+namespace Luna
+{
+    namespace VFS
+    {
+        // Layout of one pack archive:
+        //
+        // PackArchiveHeader
+        // PackArchiveEntry[num_entries]    Sorted by (parent directory path, name), so that children of one directory are stored
+        //                                  continuously, and entries can be found by binary search.
+        // c8[string_table_size]            Null-terminated paths of entries relative to the archive root, separated by '/'.
+        // File data                        Every file starts at one PACK_ARCHIVE_ALIGNMENT boundary.
+        constexpr u32 PACK_ARCHIVE_MAGIC = 0x4B41504C; // "LPAK"
+        constexpr u32 PACK_ARCHIVE_VERSION = 1;
+        constexpr u64 PACK_ARCHIVE_ALIGNMENT = 4096;
+
+        enum class PackArchiveEntryFlag : u32
+        {
+            none = 0,
+            directory = 1,
+        };
+
+        struct PackArchiveHeader
+        {
+            u32 magic;
+            u32 version;
+            u32 num_entries;
+            //! The number of entries in the root directory. Entries of the root directory are always stored first.
+            u32 num_root_entries;
+            u64 string_table_size;
+            //! The last write time of the archive root directory.
+            i64 last_write_time;
+        };
+
+        struct PackArchiveEntry
+        {
+            u32 path_offset;
+            u32 path_size;
+            //! The offset of the entry name from the beginning of the path.
+            u32 name_offset;
+            PackArchiveEntryFlag flags;
+            //! For files, the offset of the file data from the beginning of the archive.
+            u64 data_offset;
+            //! For files, the uncompressed size of the file data.
+            u64 size;
+            //! For files, the size of the file data stored in the archive.
+            u64 stored_size;
+            //! For directories, the index of the first child entry.
+            u32 first_child;
+            //! For directories, the number of child entries.
+            u32 num_children;
+            PackCompression compression;
+            u32 reserved;
+            i64 last_write_time;
+        };
+
+        struct PackArchive
+        {
+            Ref<IMappedFile> m_file;
+            const PackArchiveHeader* m_header;
+            const PackArchiveEntry* m_entries;
+            const c8* m_strings;
+
+            RV init(const c8* path);
+            //! Finds the entry of the specified path. Returns `U32_MAX` if the path is the root directory.
+            R<u32> find_entry(const Path& path) const;
+        };
+
+        //! The file opened from one pack archive.
+        struct PackFile : IFile, IMappedFile
+        {
+            lustruct("VFS::PackFile", "{3e9b6c4d-71f2-4a8e-b05d-c28f4e1a7d93}");
+            luiimpl();
+
+            //! Keeps the archive mapped while the file is opened.
+            Ref<IMappedFile> m_archive;
+            //! The decompressed file data, empty if the file is stored without compression.
+            Blob m_decompressed_data;
+            const u8* m_data = nullptr;
+            u64 m_size = 0;
+            u64 m_cursor = 0;
+
+            virtual RV read(void* buffer, usize size, usize* read_bytes) override;
+            virtual RV write(const void* buffer, usize size, usize* write_bytes) override
+            {
+                if (write_bytes) *write_bytes = 0;
+                return BasicError::access_denied();
+            }
+            virtual R<u64> tell() override { return m_cursor; }
+            virtual RV seek(i64 offset, SeekMode mode) override;
+            virtual u64 get_size() override { return m_size; }
+            virtual RV set_size(u64 size) override { return BasicError::access_denied(); }
+            virtual void flush() override {}
+            virtual const void* get_data() override { return m_data; }
+        };
+
+        struct PackFileIterator : IFileIterator
+        {
+            lustruct("VFS::PackFileIterator", "{a4d17f20-5b8c-4e36-9f2a-6c0e3d8b1f57}");
+            luiimpl();
+
+            Ref<IMappedFile> m_archive;
+            const PackArchiveEntry* m_entries;
+            const c8* m_strings;
+            u32 m_current;
+            u32 m_end;
+
+            virtual bool is_valid() override { return m_current < m_end; }
+            virtual const c8* get_filename() override;
+            virtual FileAttributeFlag get_attributes() override;
+            virtual bool move_next() override;
+        };
+
+        void register_pack_archive_driver();
+    }
+}
@@ -0,0 +1,158 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file LZ4.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_VFS_API LUNA_EXPORT
+#include "LZ4.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+
+namespace Luna
+{
+    namespace VFS
+    {
+        // Constants defined by the LZ4 block format.
+        constexpr usize LZ4_MIN_MATCH = 4;
+        // The last 5 bytes are always literals.
+        constexpr usize LZ4_LAST_LITERALS = 5;
+        // The last match must start at least 12 bytes before the end of the block.
+        constexpr usize LZ4_MF_LIMIT = 12;
+        constexpr usize LZ4_MAX_OFFSET = 65535;
+        constexpr u32 LZ4_HASH_LOG = 12;
+
+        inline u32 lz4_read32(const u8* p)
+        {
+            u32 v;
+            memcpy(&v, p, sizeof(u32));
+            return v;
+        }
+        inline u32 lz4_hash(u32 v)
+        {
+            return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+        }
+        inline bool lz4_write_length(u8*& op, u8* oend, usize length)
+        {
+            while (length >= 255)
+            {
+                if (op >= oend) return false;
+                *op++ = 255;
+                length -= 255;
+            }
+            if (op >= oend) return false;
+            *op++ = (u8)length;
+            return true;
+        }
+        static bool lz4_write_sequence(u8*& op, u8* oend, const u8* literals, usize literal_length, usize offset, usize match_length, bool last)
+        {
+            if (op >= oend) return false;
+            u8* token = op++;
+            u8 t = (u8)(min<usize>(literal_length, 15) << 4);
+            if (literal_length >= 15 && !lz4_write_length(op, oend, literal_length - 15)) return false;
+            if ((usize)(oend - op) < literal_length) return false;
+            memcpy(op, literals, literal_length);
+            op += literal_length;
+            if (!last)
+            {
+                if ((usize)(oend - op) < 2) return false;
+                *op++ = (u8)(offset & 0xFF);
+                *op++ = (u8)(offset >> 8);
+                usize length = match_length - LZ4_MIN_MATCH;
+                t |= (u8)min<usize>(length, 15);
+                if (length >= 15 && !lz4_write_length(op, oend, length - 15)) return false;
+            }
+            *token = t;
+            return true;
+        }
+        usize lz4_compress(const u8* src, usize src_size, u8* dst, usize dst_capacity)
+        {
+            const u8* ip = src;
+            const u8* anchor = src;
+            const u8* end = src + src_size;
+            u8* op = dst;
+            u8* oend = dst + dst_capacity;
+            if (src_size > LZ4_MF_LIMIT)
+            {
+                u32 table[1 << LZ4_HASH_LOG];
+                for (u32& i : table) i = U32_MAX;
+                const u8* match_limit = end - LZ4_MF_LIMIT;
+                const u8* match_end_limit = end - LZ4_LAST_LITERALS;
+                // Skips faster in data that cannot be compressed.
+                usize num_misses = 0;
+                while (ip < match_limit)
+                {
+                    u32 seq = lz4_read32(ip);
+                    u32 h = lz4_hash(seq);
+                    u32 candidate = table[h];
+                    table[h] = (u32)(ip - src);
+                    if (candidate == U32_MAX || (usize)(ip - src) - candidate > LZ4_MAX_OFFSET || lz4_read32(src + candidate) != seq)
+                    {
+                        ip += 1 + (num_misses++ >> 6);
+                        continue;
+                    }
+                    num_misses = 0;
+                    const u8* ref = src + candidate;
+                    const u8* mp = ip + LZ4_MIN_MATCH;
+                    const u8* rp = ref + LZ4_MIN_MATCH;
+                    while (mp < match_end_limit && *mp == *rp)
+                    {
+                        ++mp;
+                        ++rp;
+                    }
+                    if (!lz4_write_sequence(op, oend, anchor, (usize)(ip - anchor), (usize)(ip - ref), (usize)(mp - ip), false)) return 0;
+                    ip = mp;
+                    anchor = ip;
+                }
+            }
+            if (!lz4_write_sequence(op, oend, anchor, (usize)(end - anchor), 0, 0, true)) return 0;
+            return (usize)(op - dst);
+        }
+        inline bool lz4_read_length(const u8*& ip, const u8* iend, usize& length)
+        {
+            u8 b;
+            do
+            {
+                if (ip >= iend) return false;
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+            return true;
+        }
+        bool lz4_decompress(const u8* src, usize src_size, u8* dst, usize dst_size)
+        {
+            const u8* ip = src;
+            const u8* iend = src + src_size;
+            u8* op = dst;
+            u8* oend = dst + dst_size;
+            while (ip < iend)
+            {
+                u8 token = *ip++;
+                usize literal_length = token >> 4;
+                if (literal_length == 15 && !lz4_read_length(ip, iend, literal_length)) return false;
+                if (literal_length > (usize)(iend - ip) || literal_length > (usize)(oend - op)) return false;
+                memcpy(op, ip, literal_length);
+                ip += literal_length;
+                op += literal_length;
+                // The last sequence only contains literals.
+                if (ip == iend) break;
+                if (iend - ip < 2) return false;
+                usize offset = (usize)ip[0] | ((usize)ip[1] << 8);
+                ip += 2;
+                if (!offset || offset > (usize)(op - dst)) return false;
+                usize match_length = token & 0x0F;
+                if (match_length == 15 && !lz4_read_length(ip, iend, match_length)) return false;
+                match_length += LZ4_MIN_MATCH;
+                if (match_length > (usize)(oend - op)) return false;
+                // The match may overlap with the output, so copies byte by byte.
+                const u8* match = op - offset;
+                for (usize i = 0; i < match_length; ++i) op[i] = match[i];
+                op += match_length;
+            }
+            return op == oend;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file LZ4.hpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#pragma once
+#include <Luna/Runtime/Base.hpp>
+
+namespace Luna
+{
+    namespace VFS
+    {
+        //! Gets the maximum size of the compressed data for data of the specified size.
+        inline constexpr usize lz4_compress_bound(usize size)
+        {
+            return size + size / 255 + 16;
+        }
+
+        //! Compresses data using the LZ4 block format.
+        //! @return Returns the size of the compressed data, or `0` if `dst_capacity` is not large enough.
+        usize lz4_compress(const u8* src, usize src_size, u8* dst, usize dst_capacity);
+
+        //! Decompresses data compressed in the LZ4 block format.
+        //! @return Returns `true` if the data is decompressed successfully and exactly `dst_size` bytes are produced,
+        //! returns `false` if the data is corrupted.
+        bool lz4_decompress(const u8* src, usize src_size, u8* dst, usize dst_size);
+    }
+}
@@ -0,0 +1,211 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackArchive.cpp
+* @author JXMaster
+* @date 2026/10/17
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_VFS_API LUNA_EXPORT
+#include "Drivers/PackArchiveDriver.hpp"
+#include "LZ4.hpp"
+#include "../VFS.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/Runtime/HashMap.hpp>
+
+namespace Luna
+{
+    namespace VFS
+    {
+        struct PackBuildEntry
+        {
+            //! The path relative to the source directory, separated by '/'.
+            String path;
+            //! The offset of the entry name from the beginning of the path.
+            usize name_offset;
+            bool directory;
+            u64 size;
+            i64 last_write_time;
+        };
+
+        inline i32 compare_strings(const c8* a, usize a_size, const c8* b, usize b_size)
+        {
+            i32 r = memcmp(a, b, min(a_size, b_size));
+            if (r) return r;
+            if (a_size == b_size) return 0;
+            return a_size < b_size ? -1 : 1;
+        }
+
+        //! Orders entries by their parent directory paths first, then by their names.
+        inline bool pack_build_entry_less(const PackBuildEntry& a, const PackBuildEntry& b)
+        {
+            usize a_parent_size = a.name_offset ? a.name_offset - 1 : 0;
+            usize b_parent_size = b.name_offset ? b.name_offset - 1 : 0;
+            i32 r = compare_strings(a.path.c_str(), a_parent_size, b.path.c_str(), b_parent_size);
+            if (r) return r < 0;
+            return compare_strings(a.path.c_str() + a.name_offset, a.path.size() - a.name_offset,
+                b.path.c_str() + b.name_offset, b.path.size() - b.name_offset) < 0;
+        }
+
+        static RV collect_pack_build_entries(const Path& dir, const String& relative_dir, Vector<PackBuildEntry>& entries)
+        {
+            lutry
+            {
+                lulet(iter, open_dir(dir));
+                Path path = dir;
+                for (; iter->is_valid(); iter->move_next())
+                {
+                    const c8* filename = iter->get_filename();
+                    if (!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
+                    path.push_back(filename);
+                    lulet(attr, get_file_attribute(path));
+                    PackBuildEntry entry;
+                    entry.path = relative_dir;
+                    if (!entry.path.empty()) entry.path.push_back('/');
+                    entry.name_offset = entry.path.size();
+                    entry.path.append(filename);
+                    entry.directory = test_flags(attr.attributes, FileAttributeFlag::directory);
+                    entry.size = entry.directory ? 0 : attr.size;
+                    entry.last_write_time = attr.last_write_time;
+                    String child_dir = entry.path;
+                    bool directory = entry.directory;
+                    entries.push_back(move(entry));
+                    if (directory)
+                    {
+                        luexp(collect_pack_build_entries(path, child_dir, entries));
+                    }
+                    path.pop_back();
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+
+        static RV write_padding(IFile* file, u64& cursor, u64 alignment)
+        {
+            static const u8 zeros[256] = { 0 };
+            u64 padding = align_upper(cursor, alignment) - cursor;
+            while (padding)
+            {
+                usize bytes = (usize)min<u64>(padding, sizeof(zeros));
+                lutry
+                {
+                    luexp(file->write(zeros, bytes));
+                }
+                lucatchret;
+                padding -= bytes;
+                cursor += bytes;
+            }
+            return ok;
+        }
+
+        LUNA_VFS_API RV build_pack_archive(const Path& source_dir, const Path& archive_path, const PackArchiveBuildDesc& desc)
+        {
+            lutry
+            {
+                lulet(source_attr, get_file_attribute(source_dir));
+                if (!test_flags(source_attr.attributes, FileAttributeFlag::directory)) return BasicError::not_directory();
+                Vector<PackBuildEntry> entries;
+                luexp(collect_pack_build_entries(source_dir, String(), entries));
+                if (entries.size() >= (usize)U32_MAX) return BasicError::out_of_range();
+                sort(entries.begin(), entries.end(), pack_build_entry_less);
+                // Children of one directory are continuous after sorting, so maps every directory path to the index
+                // and number of its children. Entries in the root directory are always sorted first.
+                u32 num_root_entries = 0;
+                HashMap<Name, Pair<u32, u32>> children;
+                for (u32 i = 0; i < (u32)entries.size(); ++i)
+                {
+                    auto& e = entries[i];
+                    if (!e.name_offset)
+                    {
+                        ++num_root_entries;
+                        continue;
+                    }
+                    Name parent(e.path.c_str(), e.name_offset - 1);
+                    auto iter = children.insert(make_pair(parent, make_pair(i, 0U))).first;
+                    ++iter->second.second;
+                }
+                Vector<c8> strings;
+                Vector<PackArchiveEntry> records;
+                records.reserve(entries.size());
+                for (auto& e : entries)
+                {
+                    PackArchiveEntry record;
+                    memzero(&record, sizeof(PackArchiveEntry));
+                    record.path_offset = (u32)strings.size();
+                    record.path_size = (u32)e.path.size();
+                    record.name_offset = (u32)e.name_offset;
+                    strings.insert(strings.end(), e.path.c_str(), e.path.c_str() + e.path.size() + 1);
+                    record.flags = e.directory ? PackArchiveEntryFlag::directory : PackArchiveEntryFlag::none;
+                    record.last_write_time = e.last_write_time;
+                    if (e.directory)
+                    {
+                        auto iter = children.find(Name(e.path.c_str(), e.path.size()));
+                        if (iter != children.end())
+                        {
+                            record.first_child = iter->second.first;
+                            record.num_children = iter->second.second;
+                        }
+                    }
+                    records.push_back(record);
+                }
+                PackArchiveHeader header;
+                header.magic = PACK_ARCHIVE_MAGIC;
+                header.version = PACK_ARCHIVE_VERSION;
+                header.num_entries = (u32)records.size();
+                header.num_root_entries = num_root_entries;
+                header.string_table_size = strings.size();
+                header.last_write_time = source_attr.last_write_time;
+                lulet(f, open_file(archive_path, FileOpenFlag::write, FileCreationMode::create_always));
+                // File data is written first, then tables are written to the beginning of the file, since the
+                // data offsets and stored sizes are known only after files are compressed.
+                u64 cursor = sizeof(PackArchiveHeader) + records.size() * sizeof(PackArchiveEntry) + strings.size();
+                luexp(f->seek(cursor, SeekMode::begin));
+                Blob compressed;
+                for (usize i = 0; i < entries.size(); ++i)
+                {
+                    auto& e = entries[i];
+                    auto& record = records[i];
+                    if (e.directory) continue;
+                    Path path = source_dir;
+                    path.append(Path(e.path));
+                    lulet(src, open_file(path, FileOpenFlag::read, FileCreationMode::open_existing));
+                    lulet(data, load_file_data(src));
+                    // The size may change after entries are collected.
+                    record.size = data.size();
+                    const byte_t* stored_data = (const byte_t*)data.data();
+                    usize stored_size = data.size();
+                    record.compression = PackCompression::none;
+                    if (desc.compression == PackCompression::lz4 && data.size())
+                    {
+                        usize bound = lz4_compress_bound(data.size());
+                        if (compressed.size() < bound) compressed.resize(bound, false);
+                        usize compressed_size = lz4_compress((const u8*)data.data(), data.size(), (u8*)compressed.data(), compressed.size());
+                        if (compressed_size && (f64)compressed_size <= (f64)data.size() * desc.max_compression_ratio)
+                        {
+                            stored_data = (const byte_t*)compressed.data();
+                            stored_size = compressed_size;
+                            record.compression = PackCompression::lz4;
+                        }
+                    }
+                    luexp(write_padding(f, cursor, PACK_ARCHIVE_ALIGNMENT));
+                    record.data_offset = cursor;
+                    record.stored_size = stored_size;
+                    if (stored_size)
+                    {
+                        luexp(f->write(stored_data, stored_size));
+                    }
+                    cursor += stored_size;
+                }
+                luexp(f->seek(0, SeekMode::begin));
+                luexp(f->write(&header, sizeof(PackArchiveHeader)));
+                luexp(f->write(records.data(), records.size() * sizeof(PackArchiveEntry)));
+                luexp(f->write(strings.data(), strings.size()));
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
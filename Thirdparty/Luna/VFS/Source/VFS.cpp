@@ -14,6 +14,7 @@
 #include <Luna/Runtime/Mutex.hpp>
 #include <Luna/Runtime/Module.hpp>
 #include "Drivers/PlatformFSDriver.hpp"
+#include "Drivers/PackArchiveDriver.hpp"
 
 namespace Luna
 {
@@ -308,6 +309,7 @@ namespace Luna
                 g_driver_mutex = new_mutex();
                 g_mounts_mutex = new_mutex();
                 register_platform_filesystem_driver();
+                register_pack_archive_driver();
                 return ok;
             }
             virtual void on_close() override
@@ -62,11 +62,11 @@ option("rhi_api")
     set_default(get_default_rhi_api())
     set_showmenu(true)
     if is_os("windows") then
-        set_values("D3D12", "Vulkan")
+        set_values("D3D12", "Vulkan", "Null")
     elseif is_os("macosx", "ios") then
-        set_values("Metal")
+        set_values("Metal", "Null")
     elseif is_os("linux", "android") then
-        set_values("Vulkan")
+        set_values("Vulkan", "Null")
     end
     set_description("The Graphics API to use for Luna SDK")
 option_end()